@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -44,7 +45,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(MixerImpl *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
 	~Channel();
 
 	/**
@@ -175,10 +176,19 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _rateConverterType(kRateConverterLinear) {
 
 	assert(sampleRate > 0);
 
+	if (ConfMan.hasKey("resampler")) {
+		const Common::String resampler = ConfMan.get("resampler");
+		if (resampler == "polyphase")
+			_rateConverterType = kRateConverterPolyphase;
+		else if (resampler != "linear")
+			warning("MixerImpl: Unknown resampler '%s'", resampler.c_str());
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
 }
@@ -196,6 +206,10 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+RateConverter *MixerImpl::createRateConverter(st_rate_t inrate, bool stereo, bool reverseStereo) {
+	return makeRateConverter(inrate, _sampleRate, stereo, reverseStereo, _rateConverterType, &_filterCache);
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -499,7 +513,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark --- Channel implementations ---
 #pragma mark -
 
-Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
+Channel::Channel(MixerImpl *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
@@ -509,7 +523,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = mixer->createRateConverter(_stream->getRate(), _stream->isStereo(), reverseStereo);
 }
 
 Channel::~Channel() {
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -70,6 +71,9 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	RateConverterType _rateConverterType;
+	PolyphaseFilterCache _filterCache;
+
 
 public:
 
@@ -118,6 +122,12 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	/**
+	 * Create a converter from the given rate to the output rate, using the
+	 * algorithm selected by the "resampler" config key.
+	 */
+	RateConverter *createRateConverter(st_rate_t inrate, bool stereo, bool reverseStereo);
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
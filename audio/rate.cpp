@@ -30,6 +30,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
@@ -64,7 +65,7 @@ enum {
  * Limited to sampling frequency <= 65535 Hz.
  */
 template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+class SimpleRateConverter : public BlockRateConverter<reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -79,10 +80,9 @@ protected:
 
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+
+protected:
+	st_size_t resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
 };
 
 
@@ -112,7 +112,7 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+st_size_t SimpleRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -144,10 +144,10 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		opos += opos_inc;
 
 		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		obuf[reverseStereo    ] = out0;
 
 		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf[reverseStereo ^ 1] = out1;
 
 		obuf += 2;
 	}
@@ -166,7 +166,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  */
 
 template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+class LinearRateConverter : public BlockRateConverter<reverseStereo> {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -185,10 +185,9 @@ protected:
 
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+
+protected:
+	st_size_t resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
 };
 
 
@@ -221,7 +220,7 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+st_size_t LinearRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -259,10 +258,10 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  out0);
 
 			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			obuf[reverseStereo    ] = out0;
 
 			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			obuf[reverseStereo ^ 1] = out1;
 
 			obuf += 2;
 
@@ -284,6 +283,7 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
+	st_sample_t _mixBuf[MIX_BLOCK_SIZE * 2];
 public:
 	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
 	~CopyRateConverter() {
@@ -313,21 +313,36 @@ public:
 
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
+		if (len <= 0)
+			return 0;
 
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+		const st_volume_t vol0 = reverseStereo ? vol_r : vol_l;
+		const st_volume_t vol1 = reverseStereo ? vol_l : vol_r;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		// Stereo data in the right order can be mixed in straight away
+		if (stereo && !reverseStereo) {
+			mixStereoBlock(obuf, _buffer, len / 2, vol0, vol1);
+			return len / 2;
+		}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		// Otherwise, produce sample pairs in output order first
+		ptr = _buffer;
+		while (len > 0) {
+			st_sample_t *mixPtr = _mixBuf;
+			st_size_t pairs = 0;
+
+			for (; len > 0 && pairs < MIX_BLOCK_SIZE; len -= (stereo ? 2 : 1), ++pairs) {
+				st_sample_t out0, out1;
+				out0 = *ptr++;
+				out1 = (stereo ? *ptr++ : out0);
+
+				mixPtr[reverseStereo    ] = out0;
+				mixPtr[reverseStereo ^ 1] = out1;
+				mixPtr += 2;
+			}
 
-			obuf += 2;
+			mixStereoBlock(obuf, _mixBuf, pairs, vol0, vol1);
+			obuf += pairs * 2;
 		}
 		return (obuf - ostart) / 2;
 	}
@@ -24,6 +24,7 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 
 namespace Audio {
 
@@ -65,6 +66,45 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Implementations of the final step of rate conversion, which scales
+ * converted sample pairs by the channel volume and adds them with clipping
+ * to the mix buffer.
+ */
+enum MixKernel {
+	kMixKernelScalar,   ///< Portable C implementation; the reference all others must match
+	kMixKernelSSE2,
+	kMixKernelNEON
+};
+
+/**
+ * Mix interleaved sample pairs into the output buffer, i.e. perform
+ *   clampedAdd(obuf[2 * i + c], (ibuf[2 * i + c] * vol_c) / Mixer::kMaxMixerVolume)
+ * for all pairs i < osamp and both channels c, using the currently selected
+ * kernel. All kernels produce bit-identical results.
+ *
+ * @param obuf  the mix buffer
+ * @param ibuf  converted samples, already in output channel order
+ * @param osamp number of sample pairs to mix
+ * @param vol0  volume of the first channel of each pair
+ * @param vol1  volume of the second channel of each pair
+ */
+void mixStereoBlock(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1);
+
+/**
+ * @return the kernel currently used by mixStereoBlock. This is the fastest
+ * one supported by the build and the host CPU unless overridden.
+ */
+MixKernel getMixKernel();
+
+/**
+ * Select the kernel used by mixStereoBlock.
+ *
+ * @return false if the kernel is not available, in which case the current
+ * selection is kept.
+ */
+bool setMixKernel(MixKernel kernel);
+
 class RateConverter {
 public:
 	RateConverter() {}
@@ -78,8 +118,46 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
+/**
+ * Rate conversion algorithms, selectable with the "resampler" config key.
+ */
+enum RateConverterType {
+	kRateConverterLinear,   ///< Sample skipping or linear interpolation ("linear", the default)
+	kRateConverterPolyphase ///< Windowed-sinc polyphase FIR filter ("polyphase")
+};
+
+class PolyphaseFilter;
+
+/**
+ * Cache of the filter tables used by polyphase rate converters. Every
+ * conversion ratio needs its own table, which is costly to compute, so
+ * converters between the same rates share one. The cache must outlive all
+ * converters created with it.
+ */
+class PolyphaseFilterCache {
+public:
+	~PolyphaseFilterCache();
+
+	/**
+	 * @return the filter table for converting from inrate to outrate,
+	 *         computing it on first use
+	 */
+	const PolyphaseFilter *getFilter(st_rate_t inrate, st_rate_t outrate);
+
+private:
+	Common::Array<PolyphaseFilter *> _filters;
+};
+
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
 
+/**
+ * Create a RateConverter object using the given conversion algorithm.
+ *
+ * @param cache cache to take polyphase filter tables from. If 0, the
+ *              converter computes and owns its table.
+ */
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterType type, PolyphaseFilterCache *cache = 0);
+
 } // End of namespace Audio
 
 #endif
@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+/*
+ * Parts of the rate converters shared by the different implementations.
+ * This is internal to the rate conversion code.
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/**
+ * Number of sample pairs which are converted before they are mixed into the
+ * output buffer in one go by mixStereoBlock.
+ */
+#define MIX_BLOCK_SIZE 256
+
+/**
+ * Base class of the resampling rate converters. Subclasses produce the
+ * converted sample pairs (in output channel order) into a block buffer, which
+ * is then scaled by the volume and mixed into the output buffer.
+ */
+template<bool reverseStereo>
+class BlockRateConverter : public RateConverter {
+protected:
+	st_sample_t _mixBuf[MIX_BLOCK_SIZE * 2];
+
+	/**
+	 * Convert up to osamp sample pairs into obuf.
+	 * @return Number of sample pairs written into the buffer. Less than
+	 *         osamp only if the input stream ran out of data.
+	 */
+	virtual st_size_t resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) = 0;
+
+public:
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		const st_volume_t vol0 = reverseStereo ? vol_r : vol_l;
+		const st_volume_t vol1 = reverseStereo ? vol_l : vol_r;
+		st_size_t done = 0;
+
+		while (done < osamp) {
+			const st_size_t request = MIN<st_size_t>(osamp - done, MIX_BLOCK_SIZE);
+			const st_size_t converted = resample(input, _mixBuf, request);
+			mixStereoBlock(obuf + done * 2, _mixBuf, converted, vol0, vol1);
+			done += converted;
+
+			if (converted < request)
+				break;
+		}
+
+		return done;
+	}
+
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+} // End of namespace Audio
+
+#endif
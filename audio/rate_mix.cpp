@@ -0,0 +1,155 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use the intrinsics headers
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "audio/rate.h"
+#include "audio/rate_simd.h"
+#include "audio/mixer.h"
+
+namespace Audio {
+
+static void mixStereoBlockScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1) {
+	for (; osamp > 0; --osamp) {
+		clampedAdd(obuf[0], (ibuf[0] * (int)vol0) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (ibuf[1] * (int)vol1) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+		ibuf += 2;
+	}
+}
+
+#ifdef AUDIO_RATE_SSE2
+static void mixStereoBlockSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1) {
+	const __m128i vol = _mm_set_epi16(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+	// Added to negative products, so the shift truncates towards zero like
+	// the integer division of the scalar code.
+	const __m128i round = _mm_set1_epi32(Mixer::kMaxMixerVolume - 1);
+
+	for (; osamp >= 4; osamp -= 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+
+		// 32 bit products of the samples and the volume
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+		p0 = _mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), round));
+		p1 = _mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), round));
+		p0 = _mm_srai_epi32(p0, 8);
+		p1 = _mm_srai_epi32(p1, 8);
+
+		__m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		out = _mm_adds_epi16(out, _mm_packs_epi32(p0, p1));
+		_mm_storeu_si128((__m128i *)obuf, out);
+
+		obuf += 8;
+		ibuf += 8;
+	}
+
+	mixStereoBlockScalar(obuf, ibuf, osamp, vol0, vol1);
+}
+#endif
+
+#ifdef AUDIO_RATE_NEON
+static void mixStereoBlockNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1) {
+	const int16 volPair[4] = { (int16)vol0, (int16)vol1, (int16)vol0, (int16)vol1 };
+	const int16x4_t vol = vld1_s16(volPair);
+	// See mixStereoBlockSSE2
+	const int32x4_t round = vdupq_n_s32(Mixer::kMaxMixerVolume - 1);
+
+	for (; osamp >= 4; osamp -= 4) {
+		const int16x8_t in = vld1q_s16(ibuf);
+
+		int32x4_t p0 = vmull_s16(vget_low_s16(in), vol);
+		int32x4_t p1 = vmull_s16(vget_high_s16(in), vol);
+
+		p0 = vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), round));
+		p1 = vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), round));
+		p0 = vshrq_n_s32(p0, 8);
+		p1 = vshrq_n_s32(p1, 8);
+
+		const int16x8_t scaled = vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+
+		obuf += 8;
+		ibuf += 8;
+	}
+
+	mixStereoBlockScalar(obuf, ibuf, osamp, vol0, vol1);
+}
+#endif
+
+typedef void (*MixStereoBlockProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1);
+
+static MixStereoBlockProc getMixStereoBlockProc(MixKernel kernel) {
+	// The vector kernels divide by shifting
+	STATIC_ASSERT(Mixer::kMaxMixerVolume == 256, mixer_volume_must_be_256);
+
+	switch (kernel) {
+	case kMixKernelScalar:
+		return mixStereoBlockScalar;
+#ifdef AUDIO_RATE_SSE2
+	case kMixKernelSSE2:
+		return mixStereoBlockSSE2;
+#endif
+#ifdef AUDIO_RATE_NEON
+	case kMixKernelNEON:
+		return mixStereoBlockNEON;
+#endif
+	default:
+		return 0;
+	}
+}
+
+// Use the fastest kernel available in this build by default
+#if defined(AUDIO_RATE_SSE2)
+static MixKernel s_mixKernel = kMixKernelSSE2;
+static MixStereoBlockProc s_mixStereoBlock = mixStereoBlockSSE2;
+#elif defined(AUDIO_RATE_NEON)
+static MixKernel s_mixKernel = kMixKernelNEON;
+static MixStereoBlockProc s_mixStereoBlock = mixStereoBlockNEON;
+#else
+static MixKernel s_mixKernel = kMixKernelScalar;
+static MixStereoBlockProc s_mixStereoBlock = mixStereoBlockScalar;
+#endif
+
+void mixStereoBlock(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol0, st_volume_t vol1) {
+	s_mixStereoBlock(obuf, ibuf, osamp, vol0, vol1);
+}
+
+MixKernel getMixKernel() {
+	return s_mixKernel;
+}
+
+bool setMixKernel(MixKernel kernel) {
+	MixStereoBlockProc proc = getMixStereoBlockProc(kernel);
+	if (!proc)
+		return false;
+
+	s_mixKernel = kernel;
+	s_mixStereoBlock = proc;
+	return true;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,443 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Polyphase FIR rate converter.
+ *
+ * Every output sample is the dot product of the input samples around its
+ * position with a windowed-sinc low pass filter, evaluated at the fractional
+ * part of that position. The filter is precomputed for a fixed set of
+ * fractional positions (the phases) as 16 bit fixed point coefficients, so
+ * the conversion itself only uses integer arithmetic.
+ */
+
+// Disable symbol overrides so that we can use the intrinsics headers
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/rate_simd.h"
+#include "common/algorithm.h"
+#include "common/math.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+enum {
+	/** Fractional bits of the filter coefficients */
+	kCoeffBits = 14,
+	/** Filter length used when upsampling; grows proportionally when downsampling */
+	kBaseTaps = 16,
+	kMaxTaps = 64,
+	/**
+	 * Upper limit on the number of phases. Ratios which need more phases
+	 * (e.g. 22254 Hz to 44100 Hz) use the nearest one of these.
+	 */
+	kMaxPhases = 1024,
+	/** Number of input sample frames buffered per channel */
+	kHistorySize = 512 + kMaxTaps
+};
+
+/** Fraction of the lower of the two Nyquist frequencies passed by the filter */
+static const double kCutoff = 0.9;
+/** Shape parameter of the Kaiser window */
+static const double kKaiserBeta = 7.0;
+
+/** Zeroth order modified Bessel function of the first kind, for the Kaiser window */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+class PolyphaseFilter {
+public:
+	PolyphaseFilter(st_rate_t inrate, st_rate_t outrate);
+	~PolyphaseFilter() { delete[] _coeffs; }
+
+	st_rate_t getInRate() const { return _inRate; }
+	st_rate_t getOutRate() const { return _outRate; }
+
+	/** Number of filter coefficients per phase, always a multiple of 8 */
+	uint getTaps() const { return _taps; }
+
+	/**
+	 * The input position advances by step / length input samples per
+	 * output sample; the ratio is in lowest terms.
+	 */
+	uint32 getStep() const { return _step; }
+	uint32 getLength() const { return _length; }
+
+	/**
+	 * @return the coefficients for the output position phase / getLength()
+	 *         input samples after the center of the filter window
+	 */
+	const int16 *getCoeffs(uint32 phase) const {
+		if (_phases == _length)
+			return _coeffs + phase * _taps;
+
+		// Map the phase to the nearest table row
+		const uint32 row = (uint32)(((uint64)phase * _phaseScale + (1U << 31)) >> 32);
+		return _coeffs + row * _taps;
+	}
+
+private:
+	st_rate_t _inRate, _outRate;
+	uint _taps;
+	uint32 _step, _length;
+	uint _phases;
+	/** Maps a phase to a table row in 32.32 fixed point */
+	uint64 _phaseScale;
+
+	/**
+	 * _phases + 1 rows of _taps coefficients. Row p is for the fractional
+	 * position p / _phases, so the last row is the first one shifted by
+	 * one sample, which saves wrapping around when rounding the phase.
+	 */
+	int16 *_coeffs;
+};
+
+PolyphaseFilter::PolyphaseFilter(st_rate_t inrate, st_rate_t outrate)
+	: _inRate(inrate), _outRate(outrate) {
+	const uint32 divisor = Common::gcd(inrate, outrate);
+	_step = inrate / divisor;
+	_length = outrate / divisor;
+
+	_phases = MIN<uint32>(_length, kMaxPhases);
+	_phaseScale = ((uint64)_phases << 32) / _length;
+
+	// When downsampling, the cutoff is below the input Nyquist frequency and
+	// the filter needs to be longer for the same steepness.
+	double cutoff = kCutoff;
+	_taps = kBaseTaps;
+	if (_step > _length) {
+		cutoff = kCutoff * _length / _step;
+		_taps = MIN<uint>(kMaxTaps, (kBaseTaps * _step + _length - 1) / _length);
+		_taps = (_taps + 7) & ~7;
+	}
+
+	_coeffs = new int16[(_phases + 1) * _taps];
+
+	const double halfWidth = _taps / 2;
+	const double windowScale = 1.0 / besselI0(kKaiserBeta);
+
+	for (uint p = 0; p <= _phases; ++p) {
+		const double frac = (double)p / _phases;
+		int16 *row = _coeffs + p * _taps;
+		double h[kMaxTaps];
+		double sum = 0.0;
+
+		// Tap k is applied to the input sample at
+		// (position - frac) + k - (_taps / 2 - 1) relative to the output.
+		for (uint k = 0; k < _taps; ++k) {
+			const double d = (double)k - (halfWidth - 1) - frac;
+			const double x = d / halfWidth;
+			if (fabs(x) >= 1.0) {
+				h[k] = 0.0;
+				continue;
+			}
+
+			const double t = M_PI * cutoff * d;
+			const double sinc = (d == 0.0) ? 1.0 : sin(t) / t;
+			h[k] = cutoff * sinc * besselI0(kKaiserBeta * sqrt(1.0 - x * x)) * windowScale;
+			sum += h[k];
+		}
+
+		// Normalize to unity gain, and make the rounded coefficients sum up
+		// exactly, so constant signals pass unchanged.
+		int isum = 0;
+		uint center = 0;
+		for (uint k = 0; k < _taps; ++k) {
+			row[k] = (int16)floor(h[k] / sum * (1 << kCoeffBits) + 0.5);
+			isum += row[k];
+			if (h[k] > h[center])
+				center = k;
+		}
+		row[center] += (1 << kCoeffBits) - isum;
+	}
+}
+
+PolyphaseFilterCache::~PolyphaseFilterCache() {
+	for (uint i = 0; i < _filters.size(); ++i)
+		delete _filters[i];
+}
+
+const PolyphaseFilter *PolyphaseFilterCache::getFilter(st_rate_t inrate, st_rate_t outrate) {
+	for (uint i = 0; i < _filters.size(); ++i) {
+		if (_filters[i]->getInRate() == inrate && _filters[i]->getOutRate() == outrate)
+			return _filters[i];
+	}
+
+	PolyphaseFilter *filter = new PolyphaseFilter(inrate, outrate);
+	_filters.push_back(filter);
+	return filter;
+}
+
+
+#pragma mark -
+
+
+/**
+ * Audio rate converter using a polyphase FIR filter.
+ *
+ * The filter needs to look ahead by half its length, so the end of the
+ * stream is padded with silence to convert its last samples.
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public BlockRateConverter<reverseStereo> {
+	const PolyphaseFilter *_filter;
+	PolyphaseFilter *_ownFilter;
+
+	/** Deinterleaved input samples per channel */
+	st_sample_t _history[stereo ? 2 : 1][kHistorySize];
+	/** Number of valid frames in _history */
+	uint _historyLen;
+	/** Start of the filter window of the next output sample in _history */
+	uint _pos;
+	/** Fractional input position of the next output sample, in 1 / length units */
+	uint32 _phase;
+
+	uint32 _stepInt, _stepFrac;
+	/** Whether the silence after the end of the stream was added */
+	bool _flushed;
+
+	st_sample_t _readBuf[512];
+
+	bool refill(AudioStream &input);
+
+	/**
+	 * Filter the input at in0 (and in1 for the second channel) and store
+	 * the resulting sample pair in output channel order.
+	 */
+	static void applyFilter(const st_sample_t *in0, const st_sample_t *in1, const int16 *coeffs, uint taps, st_sample_t *obuf) {
+#if defined(AUDIO_RATE_SSE2)
+		// Both channels share the coefficient loads and the final reduction
+		__m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+		for (uint k = 0; k < taps; k += 8) {
+			const __m128i h = _mm_loadu_si128((const __m128i *)(coeffs + k));
+			acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in0 + k)), h));
+			if (stereo)
+				acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in1 + k)), h));
+		}
+		if (!stereo)
+			acc1 = acc0;
+
+		// Lanes 0 and 1 of sum end up holding the totals of acc0 and acc1
+		__m128i sum = _mm_add_epi32(_mm_unpacklo_epi32(acc0, acc1), _mm_unpackhi_epi32(acc0, acc1));
+		sum = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+		sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << (kCoeffBits - 1))), kCoeffBits);
+		if (reverseStereo)
+			sum = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 2, 0, 1));
+
+		// Saturating to 16 bits is the same as the clipping below
+		const int32 pair = _mm_cvtsi128_si32(_mm_packs_epi32(sum, sum));
+		memcpy(obuf, &pair, sizeof(pair));
+#else
+		const st_sample_t out0 = filterChannel(in0, coeffs, taps);
+		const st_sample_t out1 = stereo ? filterChannel(in1, coeffs, taps) : out0;
+		obuf[reverseStereo    ] = out0;
+		obuf[reverseStereo ^ 1] = out1;
+#endif
+	}
+
+#if !defined(AUDIO_RATE_SSE2)
+	static st_sample_t filterChannel(const st_sample_t *in, const int16 *coeffs, uint taps) {
+#if defined(AUDIO_RATE_NEON)
+		int32x4_t acc = vdupq_n_s32(0);
+		for (uint k = 0; k < taps; k += 8) {
+			const int16x8_t x = vld1q_s16(in + k);
+			const int16x8_t h = vld1q_s16(coeffs + k);
+			acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(h));
+			acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(h));
+		}
+		const int32x2_t pair = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+		const int32 sum = vget_lane_s32(vpadd_s32(pair, pair), 0);
+#else
+		int32 acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+		for (uint k = 0; k < taps; k += 4) {
+			acc0 += in[k    ] * coeffs[k    ];
+			acc1 += in[k + 1] * coeffs[k + 1];
+			acc2 += in[k + 2] * coeffs[k + 2];
+			acc3 += in[k + 3] * coeffs[k + 3];
+		}
+		const int32 sum = acc0 + acc1 + acc2 + acc3;
+#endif
+		// The sums are exact, so all variants produce identical results
+		const int32 out = (sum + (1 << (kCoeffBits - 1))) >> kCoeffBits;
+		return (st_sample_t)CLIP<int32>(out, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+#endif
+
+	/**
+	 * Convert up to osamp sample pairs, as far as the buffered input
+	 * reaches. fixedTaps is the filter length if it is known at compile
+	 * time, which lets the compiler unroll the filter loop, or 0.
+	 */
+	template<uint fixedTaps>
+	st_size_t convert(st_sample_t *obuf, st_size_t osamp);
+
+public:
+	PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, PolyphaseFilterCache *cache);
+	~PolyphaseRateConverter() { delete _ownFilter; }
+
+protected:
+	st_size_t resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+};
+
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, PolyphaseFilterCache *cache)
+	: _ownFilter(0), _phase(0), _flushed(false) {
+	if (cache) {
+		_filter = cache->getFilter(inrate, outrate);
+	} else {
+		_ownFilter = new PolyphaseFilter(inrate, outrate);
+		_filter = _ownFilter;
+	}
+
+	_stepInt = _filter->getStep() / _filter->getLength();
+	_stepFrac = _filter->getStep() % _filter->getLength();
+
+	// Start with silence before the first sample, so that the first output
+	// sample is centered on it.
+	_historyLen = _filter->getTaps() / 2 - 1;
+	_pos = 0;
+	memset(_history, 0, sizeof(_history));
+}
+
+template<bool stereo, bool reverseStereo>
+bool PolyphaseRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	// Drop the samples before the current filter window
+	const uint drop = MIN(_pos, _historyLen);
+	if (drop) {
+		for (uint c = 0; c < (stereo ? 2 : 1); ++c)
+			memmove(_history[c], _history[c] + drop, (_historyLen - drop) * sizeof(st_sample_t));
+		_historyLen -= drop;
+		_pos -= drop;
+	}
+
+	const int request = MIN<int>((kHistorySize - _historyLen) * (stereo ? 2 : 1), ARRAYSIZE(_readBuf));
+	const int len = input.readBuffer(_readBuf, request);
+	if (len <= 0) {
+		if (_flushed || !input.endOfData())
+			return false;
+
+		// Pad the end with silence, so that the filter window can be
+		// centered on the last sample of the stream. Less than a full window
+		// is left in the buffer, so this always fits.
+		const uint pad = _filter->getTaps() / 2;
+		for (uint c = 0; c < (stereo ? 2 : 1); ++c)
+			memset(_history[c] + _historyLen, 0, pad * sizeof(st_sample_t));
+		_historyLen += pad;
+		_flushed = true;
+		return true;
+	}
+
+	const st_sample_t *in = _readBuf;
+	st_sample_t *out0 = _history[0] + _historyLen;
+	st_sample_t *out1 = _history[stereo ? 1 : 0] + _historyLen;
+	const uint frames = stereo ? len / 2 : len;
+	for (uint i = 0; i < frames; ++i) {
+		out0[i] = *in++;
+		if (stereo)
+			out1[i] = *in++;
+	}
+	_historyLen += frames;
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+template<uint fixedTaps>
+st_size_t PolyphaseRateConverter<stereo, reverseStereo>::convert(st_sample_t *obuf, st_size_t osamp) {
+	const uint taps = fixedTaps ? fixedTaps : _filter->getTaps();
+	const uint32 length = _filter->getLength();
+	const st_sample_t *in0 = _history[0];
+	const st_sample_t *in1 = _history[stereo ? 1 : 0];
+	uint pos = _pos;
+	uint32 phase = _phase;
+	st_size_t done = 0;
+
+	while (done < osamp && pos + taps <= _historyLen) {
+		applyFilter(in0 + pos, in1 + pos, _filter->getCoeffs(phase), taps, obuf);
+		obuf += 2;
+		++done;
+
+		pos += _stepInt;
+		phase += _stepFrac;
+		if (phase >= length) {
+			phase -= length;
+			++pos;
+		}
+	}
+
+	_pos = pos;
+	_phase = phase;
+	return done;
+}
+
+template<bool stereo, bool reverseStereo>
+st_size_t PolyphaseRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+	assert(input.isStereo() == stereo);
+
+	const uint taps = _filter->getTaps();
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		if (_pos + taps > _historyLen) {
+			if (!refill(input))
+				break;
+			continue;
+		}
+
+		// Upsampling, by far the most common case, always uses the base
+		// filter length
+		if (taps == kBaseTaps)
+			done += convert<kBaseTaps>(obuf + done * 2, osamp - done);
+		else
+			done += convert<0>(obuf + done * 2, osamp - done);
+	}
+
+	return done;
+}
+
+
+#pragma mark -
+
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterType type, PolyphaseFilterCache *cache) {
+	if (type != kRateConverterPolyphase || inrate == outrate)
+		return makeRateConverter(inrate, outrate, stereo, reverseStereo);
+
+	if (stereo) {
+		if (reverseStereo)
+			return new PolyphaseRateConverter<true, true>(inrate, outrate, cache);
+		else
+			return new PolyphaseRateConverter<true, false>(inrate, outrate, cache);
+	} else
+		return new PolyphaseRateConverter<false, false>(inrate, outrate, cache);
+}
+
+} // End of namespace Audio
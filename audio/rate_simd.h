@@ -0,0 +1,51 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_SIMD_H
+#define AUDIO_RATE_SIMD_H
+
+/*
+ * Detection of the vector instruction sets used by the rate converters.
+ * This is internal to the rate conversion code; files including this header
+ * have to define FORBIDDEN_SYMBOL_ALLOW_ALL first, as the intrinsics headers
+ * pull in system headers.
+ */
+
+#include "common/scummsys.h"
+
+// The vector code relies on the output being signed 16 bit, so that the
+// clipping in clampedAdd is a plain saturating add.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_RATE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define AUDIO_RATE_NEON
+#include <arm_neon.h>
+#endif
+
+#endif // OUTPUT_UNSIGNED_AUDIO
+
+#endif
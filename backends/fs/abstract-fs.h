@@ -173,6 +173,20 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Get the size of the file and the time it was last modified, without
+	 * opening it.
+	 *
+	 * @note By default, this method fails, which means the backend does not
+	 * know the modification time.
+	 *
+	 * @param size Set to the size of the file.
+	 * @param modificationTime Set to the modification time, in seconds since an arbitrary epoch.
+	 *
+	 * @return true if successful, false otherwise.
+	 */
+	virtual bool getFileStatus(uint32 &size, uint32 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -183,6 +197,18 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance for a file which is only read,
+	 * and is neither modified nor truncated while the stream exists. This
+	 * allows backends to map the file into memory instead of reading it,
+	 * in which case the stream supports getRange().
+	 *
+	 * The default implementation just calls createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
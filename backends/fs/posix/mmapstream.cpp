@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+// Disable symbol overrides so that we can use open, fdopen etc.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/mmapstream.h"
+
+#ifdef HAVE_MMAP
+
+#include "backends/fs/stdiostream.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+MmapStream::MmapStream(void *data, uint32 size)
+	: Common::MemoryReadStream((const byte *)data, size), _data(data), _size(size) {
+}
+
+MmapStream::~MmapStream() {
+	munmap(_data, _size);
+}
+
+Common::SeekableReadStream *MmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= kMinMappedSize && st.st_size <= 0x7FFFFFFF) {
+		void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			// The mapping stays valid after closing the file
+			close(fd);
+			return new MmapStream(data, st.st_size);
+		}
+	}
+
+	FILE *handle = fdopen(fd, "rb");
+	if (!handle) {
+		close(fd);
+		return 0;
+	}
+
+	return new StdioStream(handle);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef BACKENDS_FS_POSIX_MMAPSTREAM_H
+#define BACKENDS_FS_POSIX_MMAPSTREAM_H
+
+#include "common/scummsys.h"
+
+#ifdef HAVE_MMAP
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+/**
+ * Read stream on a file which is mapped into memory. Reading just copies
+ * from the mapping, and getRange() gives access to the file data in place,
+ * so large data files can be used without reading them into buffers first.
+ *
+ * The file must not be truncated while it is mapped, as reading the
+ * missing part would then crash with SIGBUS instead of failing. Therefore
+ * it is only used for files which are explicitly opened through
+ * FSNode::createMappedReadStream().
+ */
+class MmapStream : public Common::MemoryReadStream {
+public:
+	enum {
+		/**
+		 * Smaller files are read through stdio, as mapping them costs more
+		 * than it saves.
+		 */
+		kMinMappedSize = 64 * 1024
+	};
+
+	/**
+	 * Open the file at the given path for reading. Files of at least
+	 * kMinMappedSize bytes are mapped into memory; smaller files, and files
+	 * which can not be mapped, are opened as a StdioStream instead.
+	 *
+	 * @return the stream, or 0 if the file could not be opened
+	 */
+	static Common::SeekableReadStream *makeFromPath(const Common::String &path);
+
+	~MmapStream();
+
+private:
+	void *_data;
+	uint32 _size;
+
+	MmapStream(void *data, uint32 size);
+};
+
+#endif
+
+#endif
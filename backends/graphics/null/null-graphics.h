@@ -24,12 +24,28 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
 
 static const OSystem::GraphicsMode s_noGraphicsModes[] = { {0, 0, 0} };
 
+/**
+ * Graphics manager which does not display anything.
+ *
+ * When keepSurfaces is set, the game screen and the overlay are kept in
+ * memory, so engines and the GUI drawing to them behave, and spend time, as
+ * they would with a real display.
+ */
 class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	NullGraphicsManager(bool keepSurfaces = false) : _keepSurfaces(keepSurfaces), _screenChangeID(0) {
+		memset(_palette, 0, sizeof(_palette));
+		if (_keepSurfaces)
+			_overlay.create(640, 480, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+	virtual ~NullGraphicsManager() {
+		_screen.free();
+		_overlay.free();
+	}
 
 	bool hasFeature(OSystem::Feature f) { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) {}
@@ -48,20 +64,33 @@ public:
 		list.push_back(Graphics::PixelFormat::createFormatCLUT8());
 		return list;
 	}
-	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
-	virtual int getScreenChangeID() const { return 0; }
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {
+		if (!_keepSurfaces || (_screen.w == (int16)width && _screen.h == (int16)height))
+			return;
+
+		_screen.free();
+		_screen.create(width, height, Graphics::PixelFormat::createFormatCLUT8());
+		_screenChangeID++;
+	}
+	virtual int getScreenChangeID() const { return _screenChangeID; }
 
 	void beginGFXTransaction() {}
 	OSystem::TransactionError endGFXTransaction() { return OSystem::kTransactionSuccess; }
 
-	int16 getHeight() { return 0; }
-	int16 getWidth() { return 0; }
-	void setPalette(const byte *colors, uint start, uint num) {}
-	void grabPalette(byte *colors, uint start, uint num) {}
-	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
-	Graphics::Surface *lockScreen() { return NULL; }
+	int16 getHeight() { return _screen.h; }
+	int16 getWidth() { return _screen.w; }
+	void setPalette(const byte *colors, uint start, uint num) { memcpy(_palette + start * 3, colors, num * 3); }
+	void grabPalette(byte *colors, uint start, uint num) { memcpy(colors, _palette + start * 3, num * 3); }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+		if (_screen.getPixels())
+			_screen.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	Graphics::Surface *lockScreen() { return _screen.getPixels() ? &_screen : NULL; }
 	void unlockScreen() {}
-	void fillScreen(uint32 col) {}
+	void fillScreen(uint32 col) {
+		if (_screen.getPixels())
+			_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
 	void updateScreen() {}
 	void setShakePos(int shakeOffset) {}
 	void setFocusRectangle(const Common::Rect& rect) {}
@@ -69,17 +98,33 @@ public:
 
 	void showOverlay() {}
 	void hideOverlay() {}
-	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
-	void clearOverlay() {}
-	void grabOverlay(void *buf, int pitch) {}
-	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
-	int16 getOverlayHeight() { return 0; }
-	int16 getOverlayWidth() { return 0; }
+	Graphics::PixelFormat getOverlayFormat() const { return _overlay.format; }
+	void clearOverlay() {
+		if (_overlay.getPixels())
+			_overlay.fillRect(Common::Rect(_overlay.w, _overlay.h), 0);
+	}
+	void grabOverlay(void *buf, int pitch) {
+		for (int y = 0; y < _overlay.h; y++)
+			memcpy((byte *)buf + y * pitch, _overlay.getBasePtr(0, y), _overlay.w * _overlay.format.bytesPerPixel);
+	}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {
+		if (_overlay.getPixels())
+			_overlay.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	int16 getOverlayHeight() { return _overlay.h; }
+	int16 getOverlayWidth() { return _overlay.w; }
 
 	bool showMouse(bool visible) { return !visible; }
 	void warpMouse(int x, int y) {}
 	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
 	void setCursorPalette(const byte *colors, uint start, uint num) {}
+
+private:
+	bool _keepSurfaces;
+	Graphics::Surface _screen;
+	Graphics::Surface _overlay;
+	byte _palette[3 * 256];
+	int _screenChangeID;
 };
 
 #endif
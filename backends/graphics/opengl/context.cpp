@@ -38,6 +38,8 @@ void Context::reset() {
 	shadersSupported = false;
 	multitextureSupported = false;
 	framebufferObjectSupported = false;
+	pixelBufferObjectSupported = false;
+	syncSupported = false;
 
 #define GL_FUNC_DEF(ret, name, param) name = nullptr;
 #include "backends/graphics/opengl/opengl-func.h"
@@ -119,6 +121,8 @@ void OpenGLGraphicsManager::initializeGLContext() {
 	bool ARBShadingLanguage100 = false;
 	bool ARBVertexShader = false;
 	bool ARBFragmentShader = false;
+	bool ARBPixelBufferObject = false;
+	bool ARBMapBufferRange = false;
 
 	Common::StringTokenizer tokenizer(extString, " ");
 	while (!tokenizer.empty()) {
@@ -138,6 +142,12 @@ void OpenGLGraphicsManager::initializeGLContext() {
 			g_context.multitextureSupported = true;
 		} else if (token == "GL_EXT_framebuffer_object") {
 			g_context.framebufferObjectSupported = true;
+		} else if (token == "GL_ARB_pixel_buffer_object") {
+			ARBPixelBufferObject = true;
+		} else if (token == "GL_ARB_map_buffer_range") {
+			ARBMapBufferRange = true;
+		} else if (token == "GL_ARB_sync") {
+			g_context.syncSupported = true;
 		}
 	}
 
@@ -157,6 +167,26 @@ void OpenGLGraphicsManager::initializeGLContext() {
 		g_context.shadersSupported = ARBShaderObjects & ARBShadingLanguage100 & ARBVertexShader & ARBFragmentShader;
 	}
 
+#if !USE_FORCED_GLES
+	// Pixel buffer objects are only used with desktop GL, GLES 1 and 2 lack
+	// them.
+	g_context.pixelBufferObjectSupported = g_context.type == kContextGL && ARBPixelBufferObject && ARBMapBufferRange
+	                                    && g_context.glGenBuffers && g_context.glDeleteBuffers && g_context.glBindBuffer
+	                                    && g_context.glBufferData && g_context.glMapBufferRange && g_context.glUnmapBuffer;
+
+	// Software renderers copy the pixels right away in glTexSubImage2D, so
+	// a pixel buffer would only add another copy. With llvmpipe, uploads
+	// take about twice as long through one.
+	const char *renderer = (const char *)g_context.glGetString(GL_RENDERER);
+	if (renderer && (strstr(renderer, "llvmpipe") || strstr(renderer, "softpipe") || strstr(renderer, "Software Rasterizer"))) {
+		debug(5, "OpenGL: Not using pixel buffers with software renderer %s", renderer);
+		g_context.pixelBufferObjectSupported = false;
+	}
+	g_context.syncSupported = g_context.syncSupported && g_context.glFenceSync && g_context.glClientWaitSync && g_context.glDeleteSync;
+#else
+	g_context.syncSupported = false;
+#endif
+
 	// Log context type.
 	switch (g_context.type) {
 	case kContextGL:
@@ -177,6 +207,8 @@ void OpenGLGraphicsManager::initializeGLContext() {
 	debug(5, "OpenGL: Shader support: %d", g_context.shadersSupported);
 	debug(5, "OpenGL: Multitexture support: %d", g_context.multitextureSupported);
 	debug(5, "OpenGL: FBO support: %d", g_context.framebufferObjectSupported);
+	debug(5, "OpenGL: PBO support: %d", g_context.pixelBufferObjectSupported);
+	debug(5, "OpenGL: Sync support: %d", g_context.syncSupported);
 }
 
 } // End of namespace OpenGL
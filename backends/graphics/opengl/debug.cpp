@@ -20,12 +20,81 @@
  *
  */
 
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "backends/graphics/opengl/debug.h"
 #include "backends/graphics/opengl/opengl-sys.h"
 
+#include "common/debug.h"
 #include "common/str.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
+#if defined(POSIX)
+#include <time.h>
+#endif
+
+namespace OpenGL {
+
+namespace {
+struct UploadStats {
+	uint32 frames;
+	uint32 micros;
+	uint32 uploads;
+	uint32 pixelBufferUploads;
+	uint32 bytes;
+	uint32 stalls;
+	uint32 startTime;
+};
+
+UploadStats g_uploadStats;
+
+// Interval for logging the statistics (in milliseconds)
+const uint32 kUploadStatsInterval = 5000;
+} // End of anonymous namespace
+
+void recordTextureUpload(uint32 bytes, bool pixelBuffer) {
+	++g_uploadStats.uploads;
+	if (pixelBuffer) {
+		++g_uploadStats.pixelBufferUploads;
+	}
+	g_uploadStats.bytes += bytes;
+}
+
+void recordPixelBufferStall() {
+	++g_uploadStats.stalls;
+}
+
+uint32 getUploadClock() {
+#if defined(POSIX) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return g_system->getMillis() * 1000;
+#endif
+}
+
+void recordUploadTime(uint32 micros) {
+	++g_uploadStats.frames;
+	g_uploadStats.micros += micros;
+
+	const uint32 now = g_system->getMillis();
+	if (!g_uploadStats.startTime) {
+		g_uploadStats.startTime = now;
+	} else if (now - g_uploadStats.startTime >= kUploadStatsInterval) {
+		debug(5, "OpenGL: %u frames, %.3f ms uploading per frame, %u uploads (%u through pixel buffers, %u stalls), %u KB",
+		      g_uploadStats.frames, (double)g_uploadStats.micros / g_uploadStats.frames / 1000,
+		      g_uploadStats.uploads, g_uploadStats.pixelBufferUploads, g_uploadStats.stalls,
+		      g_uploadStats.bytes / 1024);
+
+		memset(&g_uploadStats, 0, sizeof(g_uploadStats));
+		g_uploadStats.startTime = now;
+	}
+}
+
+} // End of namespace OpenGL
+
 #ifdef OPENGL_DEBUG
 
 namespace OpenGL {
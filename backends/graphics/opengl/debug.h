@@ -23,8 +23,44 @@
 #ifndef BACKENDS_GRAPHICS_OPENGL_DEBUG_H
 #define BACKENDS_GRAPHICS_OPENGL_DEBUG_H
 
+#include "common/scummsys.h"
+
 #define OPENGL_DEBUG
 
+namespace OpenGL {
+
+/**
+ * Count a texture upload for the upload statistics. These are logged at
+ * debug level 5 every few seconds.
+ *
+ * @param bytes       The number of bytes uploaded.
+ * @param pixelBuffer Whether the upload went through a pixel buffer object.
+ */
+void recordTextureUpload(uint32 bytes, bool pixelBuffer);
+
+/**
+ * Count a wait for the GPU to release a pixel buffer segment.
+ */
+void recordPixelBufferStall();
+
+/**
+ * Get a timestamp for measuring upload times. Uploads usually take well
+ * under a millisecond, so this has a finer resolution than getMillis where
+ * the platform offers one.
+ *
+ * @return The time in microseconds, wrapping around every 71 minutes.
+ */
+uint32 getUploadClock();
+
+/**
+ * Record the time spent uploading the textures of a frame.
+ *
+ * @param micros The difference of two getUploadClock() timestamps.
+ */
+void recordUploadTime(uint32 micros);
+
+} // End of namespace OpenGL
+
 #ifdef OPENGL_DEBUG
 
 namespace OpenGL {
@@ -140,6 +140,17 @@ GL_FUNC_2_DEF(void, glFramebufferTexture2D, glFramebufferTexture2DEXT, (GLenum t
 GL_FUNC_2_DEF(GLenum, glCheckFramebufferStatus, glCheckFramebufferStatusEXT, (GLenum target));
 
 GL_FUNC_2_DEF(void, glActiveTexture, glActiveTextureARB, (GLenum texture));
+
+GL_EXT_FUNC_DEF(void, glGenBuffers, (GLsizei n, GLuint *buffers));
+GL_EXT_FUNC_DEF(void, glDeleteBuffers, (GLsizei n, const GLuint *buffers));
+GL_EXT_FUNC_DEF(void, glBindBuffer, (GLenum target, GLuint buffer));
+GL_EXT_FUNC_DEF(void, glBufferData, (GLenum target, GLsizeiptr size, const void *data, GLenum usage));
+GL_EXT_FUNC_DEF(void *, glMapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access));
+GL_EXT_FUNC_DEF(GLboolean, glUnmapBuffer, (GLenum target));
+
+GL_EXT_FUNC_DEF(GLsync, glFenceSync, (GLenum condition, GLbitfield flags));
+GL_EXT_FUNC_DEF(GLenum, glClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout));
+GL_EXT_FUNC_DEF(void, glDeleteSync, (GLsync sync));
 #endif
 
 #ifdef DEFINED_GL_EXT_FUNC_DEF
@@ -406,11 +406,13 @@ void OpenGLGraphicsManager::updateScreen() {
 	_forceRedraw = false;
 
 	// Update changes to textures.
+	const uint32 uploadStart = getUploadClock();
 	_gameScreen->updateGLTexture();
 	if (_cursorVisible && _cursor) {
 		_cursor->updateGLTexture();
 	}
 	_overlay->updateGLTexture();
+	recordUploadTime(getUploadClock() - uploadStart);
 
 	// Clear the screen buffer.
 	if (_scissorOverride && !_overlayVisible) {
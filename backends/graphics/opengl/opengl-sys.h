@@ -126,6 +126,15 @@ struct Context {
 	/** Whether FBO support is available or not. */
 	bool framebufferObjectSupported;
 
+	/**
+	 * Whether textures can be uploaded from mapped pixel buffer objects.
+	 * This requires GL_ARB_pixel_buffer_object and GL_ARB_map_buffer_range.
+	 */
+	bool pixelBufferObjectSupported;
+
+	/** Whether fences (GL_ARB_sync) are available or not. */
+	bool syncSupported;
+
 #define GL_FUNC_DEF(ret, name, param) ret (GL_CALL_CONV *name)param
 #include "backends/graphics/opengl/opengl-func.h"
 #undef GL_FUNC_DEF
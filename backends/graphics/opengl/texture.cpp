@@ -72,6 +72,8 @@ void GLTexture::enableLinearFiltering(bool enable) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+	_uploadBuffer.destroy();
 }
 
 void GLTexture::create() {
@@ -146,6 +148,12 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	// Set the texture on the active texture unit.
 	bind();
 
+	// Stream larger areas through a pixel buffer object if possible. This
+	// only uploads the area itself, as its rows are copied to the buffer.
+	if (_uploadBuffer.upload(area, src, _glFormat, _glType)) {
+		return;
+	}
+
 	// Update the actual texture.
 	// Although we have the area of the texture buffer we want to update we
 	// cannot take advantage of the left/right boundries here because it is
@@ -166,6 +174,8 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	//    graphics manager did but it is much slower! Thus, we do not use it.
 	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
 	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+	recordTextureUpload(src.w * area.height() * src.format.bytesPerPixel, false);
 }
 
 //
@@ -24,6 +24,7 @@
 #define BACKENDS_GRAPHICS_OPENGL_TEXTURE_H
 
 #include "backends/graphics/opengl/opengl-sys.h"
+#include "backends/graphics/opengl/uploadbuffer.h"
 
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
@@ -143,6 +144,8 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	UploadBuffer _uploadBuffer;
 };
 
 /**
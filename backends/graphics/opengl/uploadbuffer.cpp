@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/opengl/uploadbuffer.h"
+
+#include "common/textconsole.h"
+
+namespace OpenGL {
+
+#if !USE_FORCED_GLES
+namespace {
+// Smaller uploads, e.g. palettes and cursors, are done directly
+const uint32 kMinUploadSize = 16 * 1024;
+
+// Segments are allocated in steps of this size, so they do not need to be
+// reallocated for every slightly larger area
+const uint32 kSegmentGranularity = 64 * 1024;
+
+// How long to wait for the GPU to release a segment (in nanoseconds)
+const GLuint64 kFenceTimeout = 1000 * 1000 * 1000;
+} // End of anonymous namespace
+
+UploadBuffer::UploadBuffer()
+    : _buffer(0), _segmentSize(0), _nextSegment(0), _fences(), _failed(false) {
+}
+
+UploadBuffer::~UploadBuffer() {
+	for (uint i = 0; i < kSegmentCount; ++i) {
+		if (_fences[i]) {
+			GL_CALL_SAFE(glDeleteSync, (_fences[i]));
+		}
+	}
+
+	if (_buffer) {
+		GL_CALL_SAFE(glDeleteBuffers, (1, &_buffer));
+	}
+}
+
+void UploadBuffer::destroy() {
+	for (uint i = 0; i < kSegmentCount; ++i) {
+		if (_fences[i]) {
+			GL_CALL(glDeleteSync(_fences[i]));
+			_fences[i] = 0;
+		}
+	}
+
+	if (_buffer) {
+		GL_CALL(glDeleteBuffers(1, &_buffer));
+		_buffer = 0;
+	}
+
+	_segmentSize = 0;
+	_nextSegment = 0;
+	_failed = false;
+}
+
+void UploadBuffer::allocate(uint32 segmentSize) {
+	destroy();
+
+	_segmentSize = (segmentSize + kSegmentGranularity - 1) / kSegmentGranularity * kSegmentGranularity;
+
+	GL_CALL(glGenBuffers(1, &_buffer));
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer));
+	GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, _segmentSize * kSegmentCount, nullptr, GL_STREAM_DRAW));
+}
+
+void UploadBuffer::waitForSegment(uint segment) {
+	if (!_fences[segment]) {
+		return;
+	}
+
+	GLenum result;
+	GL_ASSIGN(result, glClientWaitSync(_fences[segment], 0, 0));
+	if (result == GL_TIMEOUT_EXPIRED) {
+		// The GPU is still reading the segment
+		recordPixelBufferStall();
+		GL_ASSIGN(result, glClientWaitSync(_fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeout));
+		if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+			warning("OpenGL: Waiting for pixel buffer failed");
+		}
+	}
+
+	GL_CALL(glDeleteSync(_fences[segment]));
+	_fences[segment] = 0;
+}
+
+bool UploadBuffer::upload(const Common::Rect &area, const Graphics::Surface &src, GLenum glFormat, GLenum glType) {
+	if (!g_context.pixelBufferObjectSupported || _failed) {
+		return false;
+	}
+
+	const uint32 rowSize = area.width() * src.format.bytesPerPixel;
+	const uint32 size = rowSize * area.height();
+	if (size < kMinUploadSize) {
+		return false;
+	}
+
+	if (size > _segmentSize) {
+		allocate(size);
+	} else {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer));
+	}
+
+	GLintptr offset;
+	GLbitfield access = GL_MAP_WRITE_BIT;
+	if (g_context.syncSupported) {
+		waitForSegment(_nextSegment);
+		offset = _nextSegment * _segmentSize;
+		access |= GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+	} else {
+		// Let the driver hand out fresh memory if the GPU still uses the
+		// old contents
+		offset = 0;
+		access |= GL_MAP_INVALIDATE_BUFFER_BIT;
+	}
+
+	void *mapped;
+	GL_ASSIGN(mapped, glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset, size, access));
+	if (!mapped) {
+		warning("OpenGL: Mapping pixel buffer failed, uploading textures directly");
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		_failed = true;
+		return false;
+	}
+
+	// Pack the rows of the area tightly, so only the area itself is uploaded
+	const byte *srcRow = (const byte *)src.getBasePtr(area.left, area.top);
+	byte *dstRow = (byte *)mapped;
+	for (int y = area.top; y < area.bottom; ++y) {
+		memcpy(dstRow, srcRow, rowSize);
+		srcRow += src.pitch;
+		dstRow += rowSize;
+	}
+
+	GLboolean unmapped;
+	GL_ASSIGN(unmapped, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+	if (!unmapped) {
+		// The buffer contents got lost, e.g. on a mode switch
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+	                        glFormat, glType, (const void *)offset));
+
+	if (g_context.syncSupported) {
+		GL_ASSIGN(_fences[_nextSegment], glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		_nextSegment = (_nextSegment + 1) % kSegmentCount;
+	}
+
+	// Other uploads read from client memory
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+	recordTextureUpload(size, true);
+	return true;
+}
+#else
+// GLES 1 has no pixel buffer objects
+UploadBuffer::UploadBuffer()
+    : _buffer(0), _segmentSize(0), _nextSegment(0), _fences(), _failed(true) {
+}
+
+UploadBuffer::~UploadBuffer() {
+}
+
+void UploadBuffer::destroy() {
+}
+
+bool UploadBuffer::upload(const Common::Rect &area, const Graphics::Surface &src, GLenum glFormat, GLenum glType) {
+	return false;
+}
+#endif // !USE_FORCED_GLES
+
+} // End of namespace OpenGL
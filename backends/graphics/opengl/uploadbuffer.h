@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_OPENGL_UPLOADBUFFER_H
+#define BACKENDS_GRAPHICS_OPENGL_UPLOADBUFFER_H
+
+#include "backends/graphics/opengl/opengl-sys.h"
+
+#include "graphics/surface.h"
+
+#include "common/rect.h"
+
+namespace OpenGL {
+
+/**
+ * Ring of pixel buffer objects for streaming texture uploads.
+ *
+ * The dirty area is copied into a mapped buffer segment and uploaded from
+ * there, so glTexSubImage2D returns right away instead of copying the data
+ * synchronously. Each segment is guarded by a fence, so it is only written
+ * again once the GPU has read it. Without fences, the whole buffer is
+ * orphaned for every upload instead.
+ */
+class UploadBuffer {
+public:
+	UploadBuffer();
+	~UploadBuffer();
+
+	/**
+	 * Delete the GL buffer and fences.
+	 */
+	void destroy();
+
+	/**
+	 * Upload an area of a surface to the texture bound to GL_TEXTURE_2D.
+	 *
+	 * @param area     The area to update.
+	 * @param src      Surface for the whole texture.
+	 * @param glFormat The input format of the texture.
+	 * @param glType   The input type of the texture.
+	 * @return true on success, false if the caller has to upload the area
+	 *         itself, e.g. because pixel buffer objects are not supported or
+	 *         the area is too small to be worth it.
+	 */
+	bool upload(const Common::Rect &area, const Graphics::Surface &src, GLenum glFormat, GLenum glType);
+
+private:
+	enum {
+		kSegmentCount = 3
+	};
+
+	GLuint _buffer;
+	uint32 _segmentSize;
+	uint _nextSegment;
+	GLsync _fences[kSegmentCount];
+
+	/** Set when mapping the buffer failed, so it is not tried again. */
+	bool _failed;
+
+	void allocate(uint32 segmentSize);
+	void waitForSegment(uint segment);
+};
+
+} // End of namespace OpenGL
+
+#endif
@@ -156,6 +156,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenIsLocked(false),
 	_graphicsMutex(0),
 	_displayDisabled(false),
+	_dirtyRegion(NUM_DIRTY_RECT - 1), _numDirtyRects(0),
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
@@ -168,6 +169,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_mouseBackup.x = _mouseBackup.y = _mouseBackup.w = _mouseBackup.h = 0;
 
 	memset(&_mouseCurState, 0, sizeof(_mouseCurState));
+	memset(&_scaleStats, 0, sizeof(_scaleStats));
 
 	_graphicsMutex = g_system->createMutex();
 
@@ -1160,6 +1162,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	updateOSD();
 #endif
 
+	updateDirtyRectList();
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -1175,6 +1179,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_Rect dst;
 		uint32 srcPitch, dstPitch;
 		SDL_Rect *lastRect = _dirtyRectList + _numDirtyRects;
+		uint32 scaledPixels = 0;
 
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			dst = *r;
@@ -1213,8 +1218,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+				scaleInBands(scalerProc, scale1, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+				scaledPixels += r->w * dst_h;
 			}
 
 			r->x = rx1;
@@ -1230,6 +1236,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwscreen);
 
+		recordScaledFrame(scaledPixels, width * height);
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceFull) {
@@ -1326,6 +1334,28 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	_mouseNeedsRedraw = false;
 }
 
+void SurfaceSdlGraphicsManager::recordScaledFrame(uint32 scaledPixels, uint32 screenPixels) {
+	++_scaleStats.frames;
+	_scaleStats.rects += _numDirtyRects;
+	_scaleStats.scaledPixels += scaledPixels;
+	_scaleStats.screenPixels += screenPixels;
+
+	// Interval for logging the statistics (in milliseconds)
+	const uint32 kScaleStatsInterval = 5000;
+	const uint32 now = g_system->getMillis();
+	if (!_scaleStats.startTime) {
+		_scaleStats.startTime = now;
+	} else if (now - _scaleStats.startTime >= kScaleStatsInterval) {
+		debug(5, "SurfaceSdlGraphicsManager: %u frames, %.1f rects and %u of %u pixels scaled per frame (%.1f%%)",
+		      _scaleStats.frames, (double)_scaleStats.rects / _scaleStats.frames,
+		      _scaleStats.scaledPixels / _scaleStats.frames, _scaleStats.screenPixels / _scaleStats.frames,
+		      _scaleStats.screenPixels ? 100.0 * _scaleStats.scaledPixels / _scaleStats.screenPixels : 0.0);
+
+		memset(&_scaleStats, 0, sizeof(_scaleStats));
+		_scaleStats.startTime = now;
+	}
+}
+
 bool SurfaceSdlGraphicsManager::saveScreenshot(const char *filename) {
 	assert(_hwscreen != NULL);
 
@@ -1589,13 +1619,34 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	}
 
 	if (w > 0 && h > 0) {
+		if (realCoordinates) {
+			// The mouse cursor is added after the dirty rects are scaled
+			SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+			r->x = x;
+			r->y = y;
+			r->w = w;
+			r->h = h;
+		} else {
+			_dirtyRegion.addRect(Common::Rect(x, y, x + w, y + h));
+		}
+	}
+}
+
+void SurfaceSdlGraphicsManager::updateDirtyRectList() {
+	const Common::Array<Common::Rect> &rects = _dirtyRegion.getRects();
+	assert(_numDirtyRects + rects.size() < NUM_DIRTY_RECT);
+
+	for (uint i = 0; i < rects.size(); ++i) {
 		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+		r->x = rects[i].left;
+		r->y = rects[i].top;
+		r->w = rects[i].width();
+		r->h = rects[i].height();
 	}
+
+	_dirtyRegion.clear();
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() {
@@ -25,6 +25,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -311,10 +312,24 @@ protected:
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
+	// Dirty rect management. The rects added in game or overlay coordinates
+	// are merged in _dirtyRegion, and moved to _dirtyRectList for drawing.
+	// The last entry is kept free for the mouse cursor.
+	Graphics::DirtyRegion _dirtyRegion;
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	// How much of the screen the dirty rects made the scaler redraw, logged
+	// every few seconds
+	struct ScaleStats {
+		uint32 frames;
+		uint32 rects;
+		uint32 scaledPixels;
+		uint32 screenPixels;
+		uint32 startTime;
+	};
+	ScaleStats _scaleStats;
+
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
 		// (overlay) coordinates.
@@ -383,6 +398,14 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	/**
+	 * Move the rects of the dirty region to _dirtyRectList. To be called by
+	 * internUpdateScreen() before drawing.
+	 */
+	void updateDirtyRectList();
+
+	void recordScaledFrame(uint32 scaledPixels, uint32 screenPixels);
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
@@ -26,6 +26,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/mutex/mutex.h"
+#include "backends/thread/thread.h"
 #include "gui/EventRecorder.h"
 
 #include "audio/mixer.h"
@@ -34,6 +35,7 @@
 ModularBackend::ModularBackend()
 	:
 	_mutexManager(0),
+	_threadManager(0),
 	_graphicsManager(0),
 	_mixer(0) {
 
@@ -48,6 +50,10 @@ ModularBackend::~ModularBackend() {
 		delete _mixer;
 		_mixer = NULL;
 	}
+	if (_threadManager) {
+		delete _threadManager;
+		_threadManager = NULL;
+	}
 	if (_mutexManager) {
 		delete _mutexManager;
 		_mutexManager = NULL;
@@ -250,6 +256,49 @@ void ModularBackend::deleteMutex(MutexRef mutex) {
 	_mutexManager->deleteMutex(mutex);
 }
 
+OSystem::ThreadRef ModularBackend::createThread(ThreadProc proc, void *param, const char *name) {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createThread(proc, param, name);
+}
+
+void ModularBackend::joinThread(ThreadRef thread) {
+	assert(_threadManager);
+	_threadManager->joinThread(thread);
+}
+
+OSystem::ConditionRef ModularBackend::createCondition() {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createCondition();
+}
+
+void ModularBackend::waitCondition(ConditionRef cond, MutexRef mutex) {
+	assert(_threadManager);
+	_threadManager->waitCondition(cond, mutex);
+}
+
+void ModularBackend::signalCondition(ConditionRef cond) {
+	assert(_threadManager);
+	_threadManager->signalCondition(cond);
+}
+
+void ModularBackend::broadcastCondition(ConditionRef cond) {
+	assert(_threadManager);
+	_threadManager->broadcastCondition(cond);
+}
+
+void ModularBackend::deleteCondition(ConditionRef cond) {
+	assert(_threadManager);
+	_threadManager->deleteCondition(cond);
+}
+
+int ModularBackend::getCPUCount() {
+	if (!_threadManager)
+		return 1;
+	return _threadManager->getCPUCount();
+}
+
 Audio::Mixer *ModularBackend::getMixer() {
 	assert(_mixer);
 	return (Audio::Mixer *)_mixer;
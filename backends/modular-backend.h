@@ -27,6 +27,7 @@
 
 class GraphicsManager;
 class MutexManager;
+class ThreadManager;
 
 /**
  * Base class for modular backends.
@@ -118,6 +119,20 @@ public:
 
 	//@}
 
+	/** @name Thread handling */
+	//@{
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name);
+	virtual void joinThread(ThreadRef thread);
+	virtual ConditionRef createCondition();
+	virtual void waitCondition(ConditionRef cond, MutexRef mutex);
+	virtual void signalCondition(ConditionRef cond);
+	virtual void broadcastCondition(ConditionRef cond);
+	virtual void deleteCondition(ConditionRef cond);
+	virtual int getCPUCount();
+
+	//@}
+
 	/** @name Sound */
 	//@{
 
@@ -139,6 +154,8 @@ protected:
 	//@{
 
 	MutexManager *_mutexManager;
+	/** Optional; without it, the backend does not support threads */
+	ThreadManager *_threadManager;
 	GraphicsManager *_graphicsManager;
 	Audio::Mixer *_mixer;
 
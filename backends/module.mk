@@ -125,6 +125,7 @@ MODULE_OBJS += \
 	graphics/opengl/opengl-graphics.o \
 	graphics/opengl/shader.o \
 	graphics/opengl/texture.o \
+	graphics/opengl/uploadbuffer.o \
 	graphics/opengl/pipelines/clut8.o \
 	graphics/opengl/pipelines/fixed.o \
 	graphics/opengl/pipelines/pipeline.o \
@@ -142,6 +143,7 @@ MODULE_OBJS += \
 	mixer/doublebuffersdl/doublebuffersdl-mixer.o \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	thread/sdl/sdl-thread.o \
 	plugins/sdl/sdl-provider.o \
 	timer/sdl/sdl-timer.o
 
@@ -168,6 +170,7 @@ endif
 
 ifdef POSIX
 MODULE_OBJS += \
+	fs/posix/mmapstream.o \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
@@ -329,8 +332,12 @@ endif
 
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
-	mixer/nullmixer/nullsdl-mixer.o \
 	saves/recorder/recorder-saves.o
+
+ifdef SDL_BACKEND
+MODULE_OBJS += \
+	mixer/nullmixer/nullsdl-mixer.o
+endif
 endif
 
 # Include common rules
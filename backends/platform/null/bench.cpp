@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_clock
+
+#include "backends/platform/null/bench.h"
+
+#include "common/debug.h"
+
+#if defined(POSIX)
+#include <sys/resource.h>
+#endif
+#include <time.h>
+
+NullBenchmark::NullBenchmark() : _maxFrames(0), _frames(0), _engineMillis(0), _startMicros(0), _skippedMicros(0),
+	_frameStartMicros(0), _frameMixerMicros(0), _frameTimerMicros(0), _totalEngineMicros(0),
+	_totalScreenMicros(0), _totalMixerMicros(0), _totalTimerMicros(0) {
+}
+
+NullBenchmark::~NullBenchmark() {
+	close();
+}
+
+bool NullBenchmark::open(const Common::String &fileName, uint maxFrames) {
+	if (!_log.open(fileName, true))
+		return false;
+
+	_log.writeString("frame,virtual_ms,engine_us,update_screen_us,mixer_us,timer_us,max_rss_kb\n");
+
+	_maxFrames = maxFrames;
+	_frames = 0;
+	_engineMillis = 0;
+	_startMicros = _frameStartMicros = getRealMicros();
+	_skippedMicros = 0;
+	return true;
+}
+
+void NullBenchmark::close() {
+	if (!_log.isOpen())
+		return;
+
+	_log.finalize();
+	_log.close();
+
+	const uint64 realMicros = getRealMicros() - _startMicros;
+	debug("Benchmark: %u frames in %u ms (%u ms virtual); engine %u ms, updateScreen %u ms, mixer %u ms, timers %u ms; peak memory %u KB",
+		_frames, (uint)(realMicros / 1000), _engineMillis, (uint)(_totalEngineMicros / 1000), (uint)(_totalScreenMicros / 1000),
+		(uint)(_totalMixerMicros / 1000), (uint)(_totalTimerMicros / 1000), getMaxResidentKB());
+}
+
+uint32 NullBenchmark::getMillis() const {
+	return (uint32)((getRealMicros() - _startMicros + _skippedMicros) / 1000);
+}
+
+void NullBenchmark::endFrame(uint64 updateScreenMicros, uint32 engineMillis) {
+	// Frames drawn while quitting are not part of the run
+	if (isFinished())
+		return;
+
+	const uint64 now = getRealMicros();
+	const uint64 frameMicros = now - _frameStartMicros;
+
+	// Whatever was not spent in the backend was spent in the engine
+	const uint64 backendMicros = updateScreenMicros + _frameMixerMicros + _frameTimerMicros;
+	const uint64 engineMicros = frameMicros > backendMicros ? frameMicros - backendMicros : 0;
+
+	_engineMillis = engineMillis;
+	_log.writeString(Common::String::format("%u,%u,%u,%u,%u,%u,%u\n", _frames, engineMillis,
+		(uint)engineMicros, (uint)updateScreenMicros, (uint)_frameMixerMicros, (uint)_frameTimerMicros,
+		getMaxResidentKB()));
+
+	_totalEngineMicros += engineMicros;
+	_totalScreenMicros += updateScreenMicros;
+	_totalMixerMicros += _frameMixerMicros;
+	_totalTimerMicros += _frameTimerMicros;
+
+	_frames++;
+	_frameStartMicros = now;
+	_frameMixerMicros = _frameTimerMicros = 0;
+}
+
+uint64 NullBenchmark::getRealMicros() {
+#if defined(POSIX) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	// Processor time, which is close enough as long as the engine does not
+	// wait for anything
+	return (uint64)clock() * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
+uint32 NullBenchmark::getMaxResidentKB() {
+#if defined(POSIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(MACOSX)
+	// Mac OS X reports bytes rather than KB
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
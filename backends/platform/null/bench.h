@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_PLATFORM_NULL_BENCH_H
+#define BACKENDS_PLATFORM_NULL_BENCH_H
+
+#include "common/file.h"
+#include "common/str.h"
+
+/**
+ * Timing accounting for running engines headless in the null backend.
+ *
+ * The benchmark keeps a virtual clock which is the real time elapsed since
+ * it started plus all delays the engine asked for, which are skipped. Engines
+ * thus run as fast as the host allows, while still seeing time pass at the
+ * rate they expect. When a recording is played back with the event recorder,
+ * the engine sees the recorded time instead, which also drives the timers.
+ *
+ * For each frame, i.e. each OSystem::updateScreen() call, one CSV line is
+ * written with the time the engine sees, the real time spent in the engine, in
+ * updateScreen(), in the mixer and in timer callbacks, and the peak resident
+ * memory of the process.
+ */
+class NullBenchmark {
+public:
+	NullBenchmark();
+	~NullBenchmark();
+
+	/**
+	 * Start the benchmark, writing the frame log to fileName.
+	 *
+	 * @param maxFrames	number of frames to run before isFinished() returns
+	 *			true, or 0 to run until the engine quits.
+	 */
+	bool open(const Common::String &fileName, uint maxFrames);
+
+	/** Write the summary and close the frame log. */
+	void close();
+
+	/** Get the virtual time in milliseconds since the benchmark started. */
+	uint32 getMillis() const;
+
+	/** Advance the virtual clock without waiting. */
+	void skipMillis(uint msecs) { _skippedMicros += msecs * 1000; }
+
+	/** Account real time spent mixing audio in the current frame. */
+	void addMixerTime(uint64 micros) { _frameMixerMicros += micros; }
+
+	/** Account real time spent in timer callbacks in the current frame. */
+	void addTimerTime(uint64 micros) { _frameTimerMicros += micros; }
+
+	/**
+	 * Log the current frame and start the next one.
+	 *
+	 * @param engineMillis	the time the engine sees, which is the recorded
+	 *			time when playing back a recording
+	 */
+	void endFrame(uint64 updateScreenMicros, uint32 engineMillis);
+
+	/** Has the requested number of frames been run? */
+	bool isFinished() const { return _maxFrames && _frames >= _maxFrames; }
+
+	/** Get a monotonic real time in microseconds. */
+	static uint64 getRealMicros();
+
+	/** Get the peak resident memory of the process in KB, or 0 if unknown. */
+	static uint32 getMaxResidentKB();
+
+private:
+	Common::DumpFile _log;
+
+	uint _maxFrames;
+	uint _frames;
+	uint32 _engineMillis;
+
+	uint64 _startMicros;
+	uint64 _skippedMicros;
+	uint64 _frameStartMicros;
+
+	uint64 _frameMixerMicros;
+	uint64 _frameTimerMicros;
+
+	uint64 _totalEngineMicros;
+	uint64 _totalScreenMicros;
+	uint64 _totalMixerMicros;
+	uint64 _totalTimerMicros;
+};
+
+#endif
@@ -37,8 +37,11 @@
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/null/null-mutex.h"
 #include "backends/graphics/null/null-graphics.h"
+#include "backends/platform/null/bench.h"
 #include "audio/mixer_intern.h"
+#include "common/config-manager.h"
 #include "common/scummsys.h"
+#include "gui/EventRecorder.h"
 
 /*
  * Include header files needed for the getFilesystemFactory() method.
@@ -61,14 +64,36 @@ public:
 	virtual Common::EventSource *getDefaultEventSource() { return this; }
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual void updateScreen();
+
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
+#ifdef ENABLE_EVENTRECORDER
+	virtual Audio::Mixer *getMixer();
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
+	virtual void fatalError();
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+private:
+	/** Samples mixed per mixer callback while benchmarking. */
+	static const uint kMixSamples = 1024;
+
+	NullBenchmark *_benchmark;
+	bool _benchmarkQuitSent;
+
+	uint64 _mixedSamples;
+	byte *_mixBuffer;
+
+	/** Run the timers and the mixer up to the current virtual time. */
+	void runBenchmarkTasks();
 };
 
-OSystem_NULL::OSystem_NULL() {
+OSystem_NULL::OSystem_NULL() : _benchmark(0), _benchmarkQuitSent(false), _mixedSamples(0), _mixBuffer(0) {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(POSIX)
@@ -78,37 +103,156 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+	// Command line detection runs before initBackend() and already locks
+	// the mutex of the detection cache
+	_mutexManager = new NullMutexManager();
 }
 
 OSystem_NULL::~OSystem_NULL() {
+	delete _benchmark;
+	delete[] _mixBuffer;
+
+	// The timer manager locks its mutex when deleted, so it must go before
+	// the mutex manager
+#ifdef ENABLE_EVENTRECORDER
+	delete g_eventRec.getTimerManager();
+#else
+	delete _timerManager;
+#endif
+	_timerManager = 0;
 }
 
 void OSystem_NULL::initBackend() {
-	_mutexManager = new NullMutexManager();
+#ifdef ENABLE_EVENTRECORDER
+	g_eventRec.registerTimerManager(new DefaultTimerManager());
+#else
 	_timerManager = new DefaultTimerManager();
+#endif
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
-	_graphicsManager = new NullGraphicsManager();
 	_mixer = new Audio::MixerImpl(this, 22050);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
+	// When benchmarking, the timers and the mixer are run from the virtual
+	// clock. Otherwise both are useless; they need to be hooked into the
+	// system somehow to be functional. Of course, can't do that in a NULL
+	// backend :).
+	if (ConfMan.hasKey("bench_log")) {
+		const Common::String logName = ConfMan.get("bench_log");
+		const int maxFrames = ConfMan.hasKey("bench_frames") ? ConfMan.getInt("bench_frames") : 0;
+
+		_benchmark = new NullBenchmark();
+		if (_benchmark->open(logName, MAX(maxFrames, 0))) {
+			_mixBuffer = new byte[kMixSamples * 4];
+			((Audio::MixerImpl *)_mixer)->setReady(true);
+		} else {
+			warning("Could not open benchmark log '%s'", logName.c_str());
+			delete _benchmark;
+			_benchmark = 0;
+		}
+	}
 
-	// Note that both the mixer and the timer manager are useless
-	// this way; they need to be hooked into the system somehow to
-	// be functional. Of course, can't do that in a NULL backend :).
+	if (!_benchmark)
+		((Audio::MixerImpl *)_mixer)->setReady(false);
+
+	_graphicsManager = new NullGraphicsManager(_benchmark != 0);
 
 	ModularBackend::initBackend();
 }
 
 bool OSystem_NULL::pollEvent(Common::Event &event) {
+	if (!_benchmark)
+		return false;
+
+	runBenchmarkTasks();
+
+	if (_benchmark->isFinished() && !_benchmarkQuitSent) {
+		_benchmarkQuitSent = true;
+		event.type = Common::EVENT_QUIT;
+		return true;
+	}
+
 	return false;
 }
 
+void OSystem_NULL::updateScreen() {
+	if (!_benchmark) {
+		ModularBackend::updateScreen();
+		return;
+	}
+
+	const uint64 start = NullBenchmark::getRealMicros();
+	ModularBackend::updateScreen();
+	_benchmark->endFrame(NullBenchmark::getRealMicros() - start, getMillis(true));
+}
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
-	return 0;
+	uint32 millis = _benchmark ? _benchmark->getMillis() : 0;
+
+#ifdef ENABLE_EVENTRECORDER
+	// When playing back, this is the recorded time instead
+	g_eventRec.processMillis(millis, skipRecord);
+#endif
+
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (!_benchmark)
+		return;
+
+	_benchmark->skipMillis(msecs);
+	runBenchmarkTasks();
+}
+
+void OSystem_NULL::runBenchmarkTasks() {
+#ifdef ENABLE_EVENTRECORDER
+	// The recorder runs the timers and its own mixer from getMillis() while
+	// recording or playing back, so that time is accounted to the engine
+	if (g_eventRec.isActive())
+		return;
+#endif
+
+	uint64 start = NullBenchmark::getRealMicros();
+	((DefaultTimerManager *)getTimerManager())->handler();
+	uint64 end = NullBenchmark::getRealMicros();
+	_benchmark->addTimerTime(end - start);
+
+	Audio::MixerImpl *mixer = (Audio::MixerImpl *)_mixer;
+	const uint64 dueSamples = (uint64)_benchmark->getMillis() * mixer->getOutputRate() / 1000;
+	if (_mixedSamples >= dueSamples)
+		return;
+
+	start = end;
+	while (_mixedSamples < dueSamples) {
+		const uint samples = (uint)MIN<uint64>(dueSamples - _mixedSamples, kMixSamples);
+		mixer->mixCallback(_mixBuffer, samples * 4);
+		_mixedSamples += samples;
+	}
+	_benchmark->addMixerTime(NullBenchmark::getRealMicros() - start);
+}
+
+#ifdef ENABLE_EVENTRECORDER
+Audio::Mixer *OSystem_NULL::getMixer() {
+	return g_eventRec.getMixer(_mixer);
+}
+
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+#endif
+
+void OSystem_NULL::fatalError() {
+	// Playing back a recording ends with an error, so write the summary of
+	// the benchmark first
+	delete _benchmark;
+	_benchmark = 0;
+
+	ModularBackend::fatalError();
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
@@ -45,6 +45,7 @@
 
 #include "backends/events/sdl/sdl-events.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/thread/sdl/sdl-thread.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -125,6 +126,8 @@ OSystem_SDL::~OSystem_SDL() {
 #endif
 
 	_timerManager = 0;
+	delete _threadManager;
+	_threadManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 
@@ -165,6 +168,9 @@ void OSystem_SDL::init() {
 	if (_mutexManager == 0)
 		_mutexManager = new SdlMutexManager();
 
+	if (_threadManager == 0)
+		_threadManager = new SdlThreadManager();
+
 	if (_window == 0)
 		_window = new SdlWindow();
 
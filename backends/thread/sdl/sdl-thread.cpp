@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/thread/sdl/sdl-thread.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+#if defined(POSIX)
+#include <unistd.h>
+#endif
+
+/**
+ * Parameters of a new thread. SDL thread functions have a different
+ * signature than OSystem::ThreadProc, so we start them through
+ * threadEntry().
+ */
+struct SdlThreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+static int SDLCALL threadEntry(void *data) {
+	SdlThreadStart start = *(SdlThreadStart *)data;
+	delete (SdlThreadStart *)data;
+
+	start.proc(start.param);
+	return 0;
+}
+
+OSystem::ThreadRef SdlThreadManager::createThread(OSystem::ThreadProc proc, void *param, const char *name) {
+	SdlThreadStart *start = new SdlThreadStart;
+	start->proc = proc;
+	start->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_Thread *thread = SDL_CreateThread(threadEntry, name, start);
+#else
+	SDL_Thread *thread = SDL_CreateThread(threadEntry, start);
+#endif
+
+	if (!thread)
+		delete start;
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void SdlThreadManager::joinThread(OSystem::ThreadRef thread) {
+	SDL_WaitThread((SDL_Thread *)thread, NULL);
+}
+
+OSystem::ConditionRef SdlThreadManager::createCondition() {
+	return (OSystem::ConditionRef)SDL_CreateCond();
+}
+
+void SdlThreadManager::waitCondition(OSystem::ConditionRef cond, OSystem::MutexRef mutex) {
+	SDL_CondWait((SDL_cond *)cond, (SDL_mutex *)mutex);
+}
+
+void SdlThreadManager::signalCondition(OSystem::ConditionRef cond) {
+	SDL_CondSignal((SDL_cond *)cond);
+}
+
+void SdlThreadManager::broadcastCondition(OSystem::ConditionRef cond) {
+	SDL_CondBroadcast((SDL_cond *)cond);
+}
+
+void SdlThreadManager::deleteCondition(OSystem::ConditionRef cond) {
+	SDL_DestroyCond((SDL_cond *)cond);
+}
+
+int SdlThreadManager::getCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return SDL_GetCPUCount();
+#elif defined(POSIX) && defined(_SC_NPROCESSORS_ONLN)
+	// SDL 1.2 cannot tell, so ask the system
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+#else
+	return 1;
+#endif
+}
+
+#endif
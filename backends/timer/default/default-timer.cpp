@@ -31,81 +31,123 @@ struct TimerSlot {
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint64 nextFireTime;	// in microseconds
+	uint32 sequence;	// orders slots with the same nextFireTime
+	uint heapIndex;	// position in the queue
 
-	TimerSlot *next;
+	uint32 calls;
+	uint32 maxDuration;	// in milliseconds
+	uint32 maxLateness;	// in milliseconds
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
 
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
+DefaultTimerManager::DefaultTimerManager() :
+	_sequence(0), _firingSlot(0) {
+}
 
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+DefaultTimerManager::~DefaultTimerManager() {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _queue.size(); ++i)
+		delete _queue[i];
+	_queue.clear();
+	_slots.clear();
 }
 
+bool DefaultTimerManager::firesBefore(const TimerSlot *a, const TimerSlot *b) const {
+	// Timers due at the same time fire in the order they were (re)scheduled
+	if (a->nextFireTime != b->nextFireTime)
+		return a->nextFireTime < b->nextFireTime;
+	return (int32)(a->sequence - b->sequence) < 0;
+}
 
-DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _queue[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!firesBefore(slot, _queue[parent]))
+			break;
+		_queue[index] = _queue[parent];
+		_queue[index]->heapIndex = index;
+		index = parent;
+	}
+	_queue[index] = slot;
+	slot->heapIndex = index;
+}
 
-	_head = new TimerSlot();
-	memset(_head, 0, sizeof(TimerSlot));
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _queue[index];
+	const uint size = _queue.size();
+	while (true) {
+		uint child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && firesBefore(_queue[child + 1], _queue[child]))
+			++child;
+		if (!firesBefore(_queue[child], slot))
+			break;
+		_queue[index] = _queue[child];
+		_queue[index]->heapIndex = index;
+		index = child;
+	}
+	_queue[index] = slot;
+	slot->heapIndex = index;
 }
 
-DefaultTimerManager::~DefaultTimerManager() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::insertSlot(TimerSlot *slot) {
+	slot->sequence = _sequence++;
+	_queue.push_back(slot);
+	siftUp(_queue.size() - 1);
+}
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+void DefaultTimerManager::removeSlot(TimerSlot *slot) {
+	const uint index = slot->heapIndex;
+	TimerSlot *last = _queue.back();
+	_queue.pop_back();
+
+	// Fill the gap with the last slot, which may need to move either way
+	if (last != slot) {
+		_queue[index] = last;
+		last->heapIndex = index;
+		siftUp(index);
+		siftDown(last->heapIndex);
 	}
-	_head = 0;
 }
 
 void DefaultTimerManager::handler() {
 	Common::StackLock lock(_mutex);
 
-	uint32 curTime = g_system->getMillis(true);
+	const uint32 curTime = g_system->getMillis(true);
+	const uint64 curTimeMicro = (uint64)curTime * 1000;
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+	while (!_queue.empty() && _queue[0]->nextFireTime < curTimeMicro) {
+		TimerSlot *slot = _queue[0];
+		const uint32 lateness = (uint32)((curTimeMicro - slot->nextFireTime) / 1000);
+
+		// Update the fire time and move the TimerSlot to its new place in the
+		// priority queue. The fire time is kept in microseconds, so timers
+		// with intervals which are not a multiple of a millisecond do not
+		// drift.
 		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
-		}
-		insertPrioQueue(_head, slot);
+		slot->nextFireTime += slot->interval;
+		slot->sequence = _sequence++;
+		siftDown(0);
 
 		// Invoke the timer callback
 		assert(slot->callback);
+		_firingSlot = slot;
+		const uint32 startTime = g_system->getMillis(true);
 		slot->callback(slot->refCon);
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+		// The callback may have removed its own timer
+		if (_firingSlot) {
+			const uint32 duration = g_system->getMillis(true) - startTime;
+			++slot->calls;
+			slot->maxDuration = MAX(slot->maxDuration, duration);
+			slot->maxLateness = MAX(slot->maxLateness, lateness);
+		}
+		_firingSlot = 0;
 	}
 }
 
@@ -118,12 +160,10 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 			error("Different callbacks are referred by same name (%s)", id.c_str());
 		}
 	}
-	TimerSlotMap::const_iterator i;
 
-	for (i = _callbacks.begin(); i != _callbacks.end(); ++i) {
-		if (i->_value == callback) {
-			error("Same callback added twice (old name: %s, new name: %s)", i->_key.c_str(), id.c_str());
-		}
+	TimerProcMap::const_iterator i = _slots.find(callback);
+	if (i != _slots.end()) {
+		error("Same callback added twice (old name: %s, new name: %s)", i->_value->id.c_str(), id.c_str());
 	}
 	_callbacks[id] = callback;
 
@@ -132,11 +172,13 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	slot->nextFireTime = (uint64)g_system->getMillis() * 1000 + interval;
+	slot->calls = 0;
+	slot->maxDuration = 0;
+	slot->maxLateness = 0;
 
-	insertPrioQueue(_head, slot);
+	insertSlot(slot);
+	_slots[callback] = slot;
 
 	return true;
 }
@@ -144,19 +186,17 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	TimerProcMap::iterator i = _slots.find(callback);
+	if (i == _slots.end())
+		return;
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
-		}
-	}
+	TimerSlot *slot = i->_value;
+	_slots.erase(i);
+	removeSlot(slot);
+	if (_firingSlot == slot)
+		_firingSlot = 0;
 
-	// We need to remove all names referencing the timer proc here.
+	// We need to remove the name referencing the timer proc here.
 	//
 	// Else we run into troubles, when the client code removes and readds timer
 	// callbacks.
@@ -168,8 +208,28 @@ void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	// name and causing installTimerProc to error out.
 	// A good test case is running a SCUMM with ALSA output and then a KYRA
 	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	//
+	// Since installTimerProc allows neither reusing a name for a different
+	// callback nor installing a callback twice, the slot's name is the only
+	// one referencing the callback.
+	_callbacks.erase(slot->id);
+
+	delete slot;
+}
+
+Common::TimerManager::TimerStatsList DefaultTimerManager::getTimerStats() {
+	Common::StackLock lock(_mutex);
+
+	TimerStatsList list;
+	for (uint i = 0; i < _queue.size(); ++i) {
+		const TimerSlot *slot = _queue[i];
+		TimerStats stats;
+		stats.id = slot->id;
+		stats.interval = slot->interval;
+		stats.calls = slot->calls;
+		stats.maxDuration = slot->maxDuration;
+		stats.maxLateness = slot->maxLateness;
+		list.push_back(stats);
 	}
+	return list;
 }
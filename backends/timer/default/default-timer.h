@@ -23,6 +23,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -34,15 +35,35 @@ class DefaultTimerManager : public Common::TimerManager {
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
+	struct TimerProc_Hash {
+		uint operator()(TimerProc proc) const { return (uint)(size_t)proc; }
+	};
+	typedef Common::HashMap<TimerProc, TimerSlot *, TimerProc_Hash> TimerProcMap;
+
 	Common::Mutex _mutex;
-	TimerSlot *_head;
 	TimerSlotMap _callbacks;
 
+	/** Installed timers, as a binary min-heap ordered by their next fire time */
+	Common::Array<TimerSlot *> _queue;
+	/** Installed timers by callback; there is at most one slot per callback */
+	TimerProcMap _slots;
+	/** Counter used to order timers which fire at the same time */
+	uint32 _sequence;
+	/** Timer whose callback is currently running, if it has not been removed */
+	TimerSlot *_firingSlot;
+
+	bool firesBefore(const TimerSlot *a, const TimerSlot *b) const;
+	void siftUp(uint index);
+	void siftDown(uint index);
+	void insertSlot(TimerSlot *slot);
+	void removeSlot(TimerSlot *slot);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
+	virtual TimerStatsList getTimerStats();
 
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
@@ -136,10 +136,16 @@ static const char HELP_STRING[] =
 	"                           atari, macintosh)\n"
 #ifdef ENABLE_EVENTRECORDER
 	"  --record-mode=MODE       Specify record mode for event recorder (record, playback,\n"
-	"                           passthrough [default])\n"
+	"                           bench, passthrough [default]). bench plays back as\n"
+	"                           fast as possible and reports the time taken\n"
 	"  --record-file-name=FILE  Specify record file name\n"
 	"  --disable-display        Disable any gfx output. Used for headless events\n"
 	"                           playback by Event Recorder\n"
+#endif
+#ifdef USE_NULL_DRIVER
+	"  --bench-log=FILE         Run without delays, logging the time spent per frame\n"
+	"                           to FILE\n"
+	"  --bench-frames=NUM       Quit after NUM frames when benchmarking\n"
 #endif
 	"\n"
 #if defined(ENABLE_SKY) || defined(ENABLE_QUEEN)
@@ -491,6 +497,14 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			END_OPTION
 #endif
 
+#ifdef USE_NULL_DRIVER
+			DO_LONG_OPTION("bench-log")
+			END_OPTION
+
+			DO_LONG_OPTION_INT("bench-frames")
+			END_OPTION
+#endif
+
 			DO_LONG_OPTION("opl-driver")
 			END_OPTION
 
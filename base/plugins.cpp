@@ -445,6 +445,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -519,13 +520,20 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 	GameList candidates;
 	EnginePlugin::List plugins;
 	EnginePlugin::List::const_iterator iter;
+	// Let all engines share the file listings and MD5s
+	DetectionPass pass;
 	PluginManager::instance().loadFirstPlugin();
 	do {
 		plugins = getPlugins();
 		// Iterate over all known games and for each check if it might be
 		// the game in the presented directory.
 		for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-			candidates.push_back((**iter)->detectGames(fslist));
+			if ((**iter)->isDetectionThreadSafe()) {
+				candidates.push_back((**iter)->detectGames(fslist));
+			} else {
+				Common::StackLock lock(DetectionMan.getDetectorMutex());
+				candidates.push_back((**iter)->detectGames(fslist));
+			}
 		}
 	} while (PluginManager::instance().loadNextPlugin());
 	return candidates;
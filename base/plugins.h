@@ -337,6 +337,12 @@ public:
 	virtual bool loadPluginFromGameId(const Common::String &gameId) { return false; }
 	virtual void updateConfigWithFileName(const Common::String &gameId) {}
 
+	/**
+	 * Returns whether all engine plugins stay in memory during detection,
+	 * so EngineManager::detectGames() may be called from several threads.
+	 */
+	virtual bool allowsConcurrentDetection() const { return true; }
+
 	// Functions used only by the cached PluginManager
 	virtual void loadAllPlugins();
 	void unloadAllPlugins();
@@ -367,6 +373,8 @@ public:
 	virtual void updateConfigWithFileName(const Common::String &gameId);
 
 	virtual void loadAllPlugins() {} 	// we don't allow this
+
+	virtual bool allowsConcurrentDetection() const { return false; }
 };
 
 #endif
@@ -22,11 +22,111 @@
 
 #include "common/archive.h"
 #include "common/fs.h"
+#include "common/memstream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 
 namespace Common {
 
+/**
+ * Reads a member of an archive into memory. The stream is created on the
+ * thread calling SearchSet::prefetch(), only reading it happens in run().
+ */
+class PrefetchJob : public Job {
+public:
+	PrefetchJob(SeekableReadStream *stream, uint32 size)
+		: _stream(stream), _data((byte *)malloc(size)), _size(size), _success(false) {}
+
+	~PrefetchJob() {
+		delete _stream;
+		free(_data);
+	}
+
+	virtual void run() {
+		if (_data)
+			_success = _stream->read(_data, _size) == _size && !_stream->err();
+		delete _stream;
+		_stream = 0;
+	}
+
+	/** Take over the data, which then has to be freed by the caller. */
+	byte *releaseData() {
+		byte *data = _data;
+		_data = 0;
+		return data;
+	}
+
+	uint32 getSize() const { return _size; }
+	bool isSuccessful() const { return _success; }
+
+private:
+	SeekableReadStream *_stream;
+	byte *_data;
+	uint32 _size;
+	bool _success;
+};
+
+/** The data of a prefetched member, shared by the streams reading it */
+struct PrefetchBuffer {
+	byte *data;
+	uint32 size;
+
+	PrefetchBuffer(byte *d, uint32 s) : data(d), size(s) {}
+	~PrefetchBuffer() { free(data); }
+};
+
+struct PrefetchEntry {
+	String name;
+	uint32 size;
+	Future<PrefetchJob> job;
+	/** The data once it has been read, after which the job is dropped */
+	SharedPtr<PrefetchBuffer> buffer;
+
+	PrefetchEntry(const String &n, uint32 s, const Future<PrefetchJob> &j) : name(n), size(s), job(j) {}
+
+	bool isReady() const {
+		return !job.isValid() || job.isReady();
+	}
+
+	/**
+	 * Wait until the member has been read. Afterwards buffer holds its data,
+	 * unless reading failed.
+	 */
+	void wait() {
+		if (!job.isValid())
+			return;
+
+		PrefetchJob &result = job.get();
+		if (result.isSuccessful())
+			buffer = SharedPtr<PrefetchBuffer>(new PrefetchBuffer(result.releaseData(), result.getSize()));
+		job = Future<PrefetchJob>();
+	}
+};
+
+/**
+ * Stream on the data of a prefetched member, which keeps the data alive
+ * even if the member is dropped from the cache in the meantime. It does not
+ * refer to the job which read the data, so it may outlive the thread pool.
+ */
+class PrefetchedReadStream : public MemoryReadStream {
+public:
+	PrefetchedReadStream(const SharedPtr<PrefetchBuffer> &buffer)
+		: MemoryReadStream(buffer->data, buffer->size), _buffer(buffer) {}
+
+private:
+	SharedPtr<PrefetchBuffer> _buffer;
+};
+
+bool PrefetchHandle::isReady() const {
+	return _entry && _entry->isReady();
+}
+
+void PrefetchHandle::wait() const {
+	if (_entry)
+		_entry->wait();
+}
+
 GenericArchiveMember::GenericArchiveMember(const String &name, const Archive *parent)
 	: _parent(parent), _name(name) {
 }
@@ -92,6 +192,46 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
+}
+
+void SearchSet::invalidateIndex() {
+	_index.clear(true);
+	clearPrefetchCache();
+}
+
+Archive *SearchSet::lookupIndex(const String &name) const {
+	NameIndex::const_iterator i = _index.find(name);
+	if (i == _index.end()) {
+		++_indexMisses;
+		return 0;
+	}
+
+	return i->_value;
+}
+
+Archive *SearchSet::findArchive(const String &name) const {
+	if (name.empty())
+		return 0;
+
+	Archive *arc = lookupIndex(name);
+	if (arc) {
+		if (arc->hasFile(name)) {
+			++_indexHits;
+			return arc;
+		}
+		++_indexStale;
+	}
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(name)) {
+			_index[name] = it->_arc;
+			return it->_arc;
+		}
+	}
+
+	return 0;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -173,6 +313,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -187,6 +328,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -206,16 +348,7 @@ void SearchSet::setPriority(const String &name, int priority) {
 }
 
 bool SearchSet::hasFile(const String &name) const {
-	if (name.empty())
-		return false;
-
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
-	}
-
-	return false;
+	return findArchive(name) != 0;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -239,32 +372,131 @@ int SearchSet::listMembers(ArchiveMemberList &list) const {
 }
 
 const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
-	if (name.empty())
+	Archive *arc = findArchive(name);
+	if (!arc)
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
-
-	return ArchiveMemberPtr();
+	return arc->getMember(name);
 }
 
 SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) const {
 	if (name.empty())
 		return 0;
 
+	PrefetchList::iterator entry = findPrefetched(name);
+	if (entry != _prefetched.end()) {
+		SharedPtr<PrefetchEntry> ptr = *entry;
+		_prefetched.erase(entry);
+		ptr->wait();
+		if (ptr->buffer) {
+			_prefetched.push_front(ptr);
+			return new PrefetchedReadStream(ptr->buffer);
+		}
+
+		// Reading failed, so try again the usual way
+		_prefetchedSize -= ptr->size;
+	}
+
+	Archive *arc = lookupIndex(name);
+	if (arc) {
+		SeekableReadStream *stream = arc->createReadStreamForMember(name);
+		if (stream) {
+			++_indexHits;
+			return stream;
+		}
+		++_indexStale;
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
-		if (stream)
+		if (stream) {
+			_index[name] = it->_arc;
 			return stream;
+		}
 	}
 
 	return 0;
 }
 
+bool SearchSet::canReadMemberInBackground(const String &name) const {
+	Archive *arc = findArchive(name);
+	return arc && arc->canReadMemberInBackground(name);
+}
+
+SearchSet::PrefetchList::iterator SearchSet::findPrefetched(const String &name) const {
+	PrefetchList::iterator it = _prefetched.begin();
+	for (; it != _prefetched.end(); ++it) {
+		if ((*it)->name.equalsIgnoreCase(name))
+			break;
+	}
+	return it;
+}
+
+bool SearchSet::makePrefetchRoom(uint32 size) {
+	if (size > _prefetchCacheSize)
+		return false;
+
+	PrefetchList::iterator it = _prefetched.reverse_begin();
+	while (_prefetchedSize > _prefetchCacheSize - size && it != _prefetched.end()) {
+		// Waiting for members which are still being read would stall the
+		// caller, so only finished ones are dropped
+		if ((*it)->isReady()) {
+			_prefetchedSize -= (*it)->size;
+			it = _prefetched.reverse_erase(it);
+		} else {
+			--it;
+		}
+	}
+
+	return _prefetchedSize <= _prefetchCacheSize - size;
+}
+
+PrefetchHandle SearchSet::prefetch(const String &name) {
+	PrefetchList::iterator entry = findPrefetched(name);
+	if (entry != _prefetched.end()) {
+		SharedPtr<PrefetchEntry> ptr = *entry;
+		_prefetched.erase(entry);
+		_prefetched.push_front(ptr);
+		return PrefetchHandle(ptr);
+	}
+
+	Archive *arc = findArchive(name);
+	if (!arc || !arc->canReadMemberInBackground(name))
+		return PrefetchHandle();
+
+	SeekableReadStream *stream = arc->createReadStreamForMember(name);
+	if (!stream)
+		return PrefetchHandle();
+
+	const int32 size = stream->size();
+	if (size < 0 || !makePrefetchRoom(size)) {
+		delete stream;
+		return PrefetchHandle();
+	}
+
+	Future<PrefetchJob> job = ThreadPool::instance().async(new PrefetchJob(stream, size));
+	SharedPtr<PrefetchEntry> ptr(new PrefetchEntry(name, size, job));
+	_prefetched.push_front(ptr);
+	_prefetchedSize += size;
+	return PrefetchHandle(ptr);
+}
+
+void SearchSet::setPrefetchCacheSize(uint32 size) {
+	_prefetchCacheSize = size;
+	makePrefetchRoom(0);
+}
+
+void SearchSet::clearPrefetchCache() {
+	// Members which are still being read are left to finish on their own
+	// rather than waited for
+	for (PrefetchList::iterator it = _prefetched.begin(); it != _prefetched.end(); ++it)
+		(*it)->job.detach();
+
+	_prefetched.clear();
+	_prefetchedSize = 0;
+}
+
 
 SearchManager::SearchManager() {
 	clear();    // Force a reset
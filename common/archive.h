@@ -24,6 +24,8 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -117,6 +119,39 @@ public:
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Check whether the stream created for the given member may be read on
+	 * another thread while this archive keeps being used on the calling
+	 * thread, which SearchSet::prefetch() relies on. This is only the case
+	 * if the streams of the archive do not share any state, e.g. for plain
+	 * files, so it is false by default.
+	 */
+	virtual bool canReadMemberInBackground(const String &name) const { return false; }
+};
+
+
+struct PrefetchEntry;
+
+/**
+ * Handle to a member which is read ahead by SearchSet::prefetch().
+ */
+class PrefetchHandle {
+public:
+	PrefetchHandle() {}
+	explicit PrefetchHandle(const SharedPtr<PrefetchEntry> &entry) : _entry(entry) {}
+
+	/** @return false if the member could not be prefetched */
+	bool isValid() const { return _entry; }
+
+	/** @return true once the member has been read into memory */
+	bool isReady() const;
+
+	/** Wait until the member has been read into memory. */
+	void wait() const;
+
+private:
+	SharedPtr<PrefetchEntry> _entry;
 };
 
 
@@ -126,6 +161,16 @@ public:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet *DOES* guarantee that searches are performed in *DESCENDING*
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * Successful lookups are remembered in a case insensitive name index, so
+ * repeated lookups of the same name go straight to the archive which served it
+ * instead of querying every archive in the set. The index is flushed whenever
+ * the set of archives or their priorities change.
+ *
+ * Members can also be read ahead with prefetch(). Prefetched members are kept
+ * in memory, up to a total of getPrefetchCacheSize() bytes, and are served
+ * from there by createReadStreamForMember(). The least recently used members
+ * are dropped first when the cache is full.
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -146,7 +191,38 @@ class SearchSet : public Archive {
 	// Add an archive keeping the list sorted by descending priority.
 	void insert(const Node& node);
 
+	typedef HashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> NameIndex;
+	mutable NameIndex _index;
+	mutable uint32 _indexHits;
+	mutable uint32 _indexMisses;
+	mutable uint32 _indexStale;
+
+	// Look up the archive which last served the given name, or 0 if unknown.
+	// Names which no archive had are not remembered, as some archives serve
+	// members they do not list.
+	Archive *lookupIndex(const String &name) const;
+
+	// Find the archive containing the given name, going through the index.
+	Archive *findArchive(const String &name) const;
+
+	// Prefetched members, most recently used first
+	typedef List<SharedPtr<PrefetchEntry> > PrefetchList;
+	mutable PrefetchList _prefetched;
+	mutable uint32 _prefetchedSize;
+	uint32 _prefetchCacheSize;
+
+	PrefetchList::iterator findPrefetched(const String &name) const;
+
+	// Drop finished prefetched members until size more bytes fit into the cache.
+	bool makePrefetchRoom(uint32 size);
+
 public:
+	enum {
+		/** Default limit for the memory used by prefetched members */
+		kDefaultPrefetchCacheSize = 32 * 1024 * 1024
+	};
+
+	SearchSet() : _indexHits(0), _indexMisses(0), _indexStale(0), _prefetchedSize(0), _prefetchCacheSize(kDefaultPrefetchCacheSize) {}
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -230,6 +306,61 @@ public:
 	 */
 	void setPriority(const String& name, int priority);
 
+	/**
+	 * Forget all remembered name lookups. This needs to be called if a file
+	 * which was already found is added to another archive in the set with a
+	 * higher priority. Changes to the set itself flush the index
+	 * automatically, and names which were not found are never remembered.
+	 */
+	void invalidateIndex();
+
+	/** Number of lookups which were answered through the name index. */
+	uint32 getIndexHits() const { return _indexHits; }
+
+	/** Number of lookups which had to search through the archives. */
+	uint32 getIndexMisses() const { return _indexMisses; }
+
+	/**
+	 * Number of remembered archives which did not have the name any more,
+	 * so that the archives had to be searched again.
+	 */
+	uint32 getIndexStale() const { return _indexStale; }
+
+	/**
+	 * Start reading the given member into memory on a background thread, so
+	 * that opening it later on does not have to wait for the disk. This is
+	 * meant for hinting at files which will be needed soon, e.g. the data
+	 * of the next scene.
+	 *
+	 * Only members of archives which support reading in the background (see
+	 * Archive::canReadMemberInBackground()) are prefetched. If the backend
+	 * does not support threads, the member is read right away.
+	 *
+	 * @return a handle to wait for the member to be read, which is invalid
+	 *         if the member does not exist, can not be read in the
+	 *         background or does not fit into the cache
+	 */
+	PrefetchHandle prefetch(const String &name);
+
+	/**
+	 * Set the maximum number of bytes used by prefetched members. Members
+	 * which are still being read are never dropped, so the limit only
+	 * applies to new prefetch() calls.
+	 */
+	void setPrefetchCacheSize(uint32 size);
+
+	/** @return the maximum number of bytes used by prefetched members */
+	uint32 getPrefetchCacheSize() const { return _prefetchCacheSize; }
+
+	/** @return the number of bytes currently used by prefetched members */
+	uint32 getPrefetchedSize() const { return _prefetchedSize; }
+
+	/**
+	 * Drop all prefetched members. Those which are still being read are
+	 * finished and freed in the background, so this never waits.
+	 */
+	void clearPrefetchCache();
+
 	virtual bool hasFile(const String &name) const;
 	virtual int listMatchingMembers(ArchiveMemberList &list, const String &pattern) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
@@ -238,9 +369,12 @@ public:
 
 	/**
 	 * Implements createReadStreamForMember from Archive base class. The current policy is
-	 * opening the first file encountered that matches the name.
+	 * opening the first file encountered that matches the name. Prefetched
+	 * members are served from memory.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	virtual bool canReadMemberInBackground(const String &name) const;
 };
 
 
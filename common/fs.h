@@ -213,6 +213,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Get the size of the file referred by this node and the time it was last
+	 * modified, without opening it. Used to tell whether data derived from the
+	 * file, e.g. its MD5, is still up to date. Not all backends support this.
+	 *
+	 * @param size Set to the size of the file.
+	 * @param modificationTime Set to the modification time, in seconds since an arbitrary epoch.
+	 *
+	 * @return true if successful, false otherwise.
+	 */
+	bool getFileStatus(uint32 &size, uint32 &modificationTime) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -222,6 +234,17 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a SeekableReadStream instance for a file which is only read,
+	 * such as a game data archive. Backends may map such files into memory,
+	 * so the file must not be modified or truncated while the stream
+	 * exists. Do not use this for savegames or other files which ScummVM
+	 * writes to.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -349,6 +372,12 @@ public:
 	 * for success.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/**
+	 * Files are opened independently of each other, so they can always be
+	 * read in the background.
+	 */
+	virtual bool canReadMemberInBackground(const String &name) const { return true; }
 };
 
 
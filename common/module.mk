@@ -29,10 +29,12 @@ MODULE_OBJS := \
 	random.o \
 	rational.o \
 	rendermode.o \
+	resourcecache.o \
 	str.o \
 	stream.o \
 	system.o \
 	textconsole.o \
+	threadpool.o \
 	tokenizer.o \
 	translation.o \
 	unarj.o \
@@ -44,6 +44,8 @@ PlaybackFile::PlaybackFile() : _tmpRecordFile(_tmpBuffer, kRecordBuffSize), _tmp
 	_headerDumped = false;
 	_recordCount = 0;
 	_eventsSize = 0;
+	_checkedScreenshots = 0;
+	_failedScreenshots = 0;
 	memset(_tmpBuffer, 1, kRecordBuffSize);
 
 	_playbackParseState = kFileStateCheckFormat;
@@ -70,6 +72,8 @@ bool PlaybackFile::openRead(const String &fileName) {
 	close();
 	_header.fileName = fileName;
 	_eventsSize = 0;
+	_checkedScreenshots = 0;
+	_failedScreenshots = 0;
 	_tmpPlaybackFile.seek(0);
 	_readStream = wrapBufferedSeekableReadStream(g_system->getSavefileManager()->openForLoading(fileName), 128 * 1024, DisposeAfterUse::YES);
 	if (_readStream == NULL) {
@@ -702,7 +706,9 @@ void PlaybackFile::checkRecordedMD5() {
 	}
 	uint32 seconds = g_system->getMillis(true) / 1000;
 	String screenTime = String::format("%.2d:%.2d:%.2d", seconds / 3600 % 24, seconds / 60 % 60, seconds % 60);
+	_checkedScreenshots++;
 	if (memcmp(savedMD5, currentMD5, 16) != 0) {
+		_failedScreenshots++;
 		debugC(1, kDebugLevelEventRec, "playback:action=\"Check screenshot\" time=%s result = fail", screenTime.c_str());
 		warning("Recorded and current screenshots are different");
 	} else {
@@ -126,6 +126,11 @@ public:
 
 	bool isEventsBufferEmpty();
 	PlaybackFileHeader &getHeader() {return _header;}
+
+	/** Number of recorded screen checksums compared during playback */
+	int getCheckedScreenshots() const { return _checkedScreenshots; }
+	/** Number of recorded screen checksums which did not match during playback */
+	int getFailedScreenshots() const { return _failedScreenshots; }
 	void updateHeader();
 	void addSaveFile(const String &fileName, InSaveFile *saveStream);
 private:
@@ -143,6 +148,8 @@ private:
 	byte _tmpBuffer[kRecordBuffSize];
 	PlaybackFileHeader _header;
 	PlaybackFileState _playbackParseState;
+	int _checkedScreenshots;
+	int _failedScreenshots;
 
 	void skipHeader();
 	bool parseHeader();
@@ -0,0 +1,50 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/resourcecache.h"
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+const char *const ResourceCacheBase::kBudgetConfigKey = "resource_cache_kb";
+
+uint32 ResourceCacheBase::getConfiguredBudget(uint32 defaultBudget) {
+	if (!ConfMan.hasKey(kBudgetConfigKey))
+		return defaultBudget;
+
+	const int budgetKB = ConfMan.getInt(kBudgetConfigKey);
+	if (budgetKB <= 0 || budgetKB > 0x3FFFFF) {
+		warning("Ignoring invalid %s %d", kBudgetConfigKey, budgetKB);
+		return defaultBudget;
+	}
+
+	return budgetKB * 1024;
+}
+
+void ResourceCacheBase::printStatistics(const char *name) const {
+	debug("%s: %u bytes cached of %u budget, %u bytes pinned; %u hits, %u misses, %u evictions",
+		name, _size, _budget, _pinnedSize, _stats.hits, _stats.misses, _stats.evictions);
+}
+
+} // End of namespace Common
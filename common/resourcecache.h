@@ -0,0 +1,312 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_RESOURCECACHE_H
+#define COMMON_RESOURCECACHE_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+namespace Common {
+
+/**
+ * Bookkeeping shared by all ResourceCache instances: the budget, the byte
+ * counts and the statistics.
+ */
+class ResourceCacheBase : NonCopyable {
+public:
+	struct Statistics {
+		uint32 hits;      ///< Requests for resources found in the cache
+		uint32 misses;    ///< Resources which had to be loaded
+		uint32 evictions; ///< Resources released to stay within the budget
+
+		Statistics() : hits(0), misses(0), evictions(0) {}
+	};
+
+	/**
+	 * Config key which sets the budget of all resource caches, in KB. It can
+	 * be set globally or per game.
+	 */
+	static const char *const kBudgetConfigKey;
+
+	explicit ResourceCacheBase(uint32 budget) : _budget(budget), _size(0), _pinnedSize(0) {}
+
+	/** Get the number of bytes unpinned resources may take. */
+	uint32 getBudget() const { return _budget; }
+
+	/**
+	 * Get the budget set by the user through kBudgetConfigKey, or the given
+	 * default if there is none.
+	 */
+	static uint32 getConfiguredBudget(uint32 defaultBudget);
+
+	/** Get the number of bytes taken by unpinned resources. */
+	uint32 getSize() const { return _size; }
+
+	/** Get the number of bytes taken by pinned resources. */
+	uint32 getPinnedSize() const { return _pinnedSize; }
+
+	const Statistics &getStatistics() const { return _stats; }
+	void resetStatistics() { _stats = Statistics(); }
+
+	/** Write the sizes and the statistics to the debug output. */
+	void printStatistics(const char *name) const;
+
+protected:
+	uint32 _budget;
+	uint32 _size;
+	uint32 _pinnedSize;
+	Statistics _stats;
+};
+
+/**
+ * Least recently used cache policy for resources of varying size.
+ *
+ * The cache does not own the resources. It keeps track of their size and of
+ * the order they were used in, and when the resources exceed the budget it
+ * tells its owner, through evict(), which ones to release, the least recently
+ * used first.
+ *
+ * Resources in use can be pinned. Pinned resources are never evicted and are
+ * accounted separately, so the budget only restricts the memory taken by
+ * resources kept for later use.
+ */
+template<class T>
+class ResourceCache : public ResourceCacheBase {
+public:
+	struct Entry {
+		T *resource;
+		uint32 size;
+		uint pins;
+	};
+
+	typedef typename List<Entry>::const_iterator const_iterator;
+
+	explicit ResourceCache(uint32 budget) : ResourceCacheBase(budget) {}
+	virtual ~ResourceCache() {}
+
+	/**
+	 * Set the number of bytes unpinned resources may take, evicting
+	 * resources if needed.
+	 */
+	void setBudget(uint32 budget) {
+		_budget = budget;
+		evictOld();
+	}
+
+	/** Iterate over the cached resources, the most recently used first. */
+	const_iterator begin() const { return _entries.begin(); }
+	const_iterator end() const { return _entries.end(); }
+
+	uint getCount() const { return _index.size(); }
+
+	bool contains(T *resource) const { return _index.contains(resource); }
+
+	uint getPins(T *resource) const {
+		typename Index::const_iterator it = _index.find(resource);
+		return it != _index.end() ? it->_value->pins : 0;
+	}
+
+	/**
+	 * Add a resource which has just been loaded as the most recently used
+	 * one, and evict old resources if the budget is exceeded. This counts as
+	 * a miss.
+	 */
+	void add(T *resource, uint32 size) {
+		_stats.misses++;
+
+		typename Index::iterator it = _index.find(resource);
+		if (it != _index.end()) {
+			// Reloaded while still cached; only its size may have changed
+			setEntrySize(*it->_value, size);
+			moveToFront(it->_value);
+		} else {
+			Entry entry = { resource, size, 0 };
+			_entries.push_front(entry);
+			_index[resource] = _entries.begin();
+			_size += size;
+		}
+
+		evictOld();
+	}
+
+	/**
+	 * Mark a cached resource as the most recently used one. This counts as a
+	 * hit.
+	 */
+	void touch(T *resource) {
+		typename Index::iterator it = _index.find(resource);
+		assert(it != _index.end());
+
+		_stats.hits++;
+		moveToFront(it->_value);
+	}
+
+	/** Change the size of a cached resource. */
+	void resize(T *resource, uint32 size) {
+		typename Index::iterator it = _index.find(resource);
+		assert(it != _index.end());
+
+		setEntrySize(*it->_value, size);
+		evictOld();
+	}
+
+	/** Remove a resource from the cache, without evicting it. */
+	void remove(T *resource) {
+		typename Index::iterator it = _index.find(resource);
+		if (it == _index.end())
+			return;
+
+		const Entry &entry = *it->_value;
+		if (entry.pins)
+			_pinnedSize -= entry.size;
+		else
+			_size -= entry.size;
+
+		_entries.erase(it->_value);
+		_index.erase(it);
+	}
+
+	/** Protect a cached resource from eviction. Pins are counted. */
+	void pin(T *resource) {
+		typename Index::iterator it = _index.find(resource);
+		assert(it != _index.end());
+
+		Entry &entry = *it->_value;
+		if (!entry.pins++) {
+			_size -= entry.size;
+			_pinnedSize += entry.size;
+		}
+	}
+
+	/**
+	 * Release a pin. A resource which is no longer pinned becomes the most
+	 * recently used one. Nothing is evicted here, so the caller may still
+	 * use the resource; call evictOld() once done with it.
+	 */
+	void unpin(T *resource) {
+		typename Index::iterator it = _index.find(resource);
+		assert(it != _index.end());
+
+		Entry &entry = *it->_value;
+		assert(entry.pins);
+		if (!--entry.pins) {
+			_pinnedSize -= entry.size;
+			_size += entry.size;
+			moveToFront(it->_value);
+		}
+	}
+
+	/**
+	 * Evict the least recently used unpinned resources until they fit into
+	 * the budget. The most recently used resource is kept in any case, as it
+	 * has just been requested.
+	 */
+	void evictOld() {
+		Array<T *> evicted;
+
+		typename List<Entry>::iterator it = _entries.end();
+		while (_size > _budget && it != _entries.begin()) {
+			--it;
+			if (it->pins || it == _entries.begin())
+				continue;
+
+			it = removeEntry(it, evicted);
+		}
+
+		evictResources(evicted);
+	}
+
+	/** Evict all unpinned resources. */
+	void evictAll() {
+		Array<T *> evicted;
+
+		typename List<Entry>::iterator it = _entries.begin();
+		while (it != _entries.end()) {
+			if (it->pins)
+				++it;
+			else
+				it = removeEntry(it, evicted);
+		}
+
+		evictResources(evicted);
+	}
+
+protected:
+	/**
+	 * Release a resource the cache decided to evict. The resource has
+	 * already been removed from the cache.
+	 */
+	virtual void evict(T *resource) = 0;
+
+private:
+	struct PointerHash {
+		uint operator()(const T *resource) const { return (uint)((size_t)resource >> 3); }
+	};
+
+	typedef HashMap<T *, typename List<Entry>::iterator, PointerHash> Index;
+
+	List<Entry> _entries;
+	Index _index;
+
+	void moveToFront(typename List<Entry>::iterator it) {
+		if (it == _entries.begin())
+			return;
+
+		_entries.push_front(*it);
+		_entries.erase(it);
+		_index[_entries.front().resource] = _entries.begin();
+	}
+
+	void setEntrySize(Entry &entry, uint32 size) {
+		if (entry.pins)
+			_pinnedSize += size - entry.size;
+		else
+			_size += size - entry.size;
+		entry.size = size;
+	}
+
+	typename List<Entry>::iterator removeEntry(typename List<Entry>::iterator it, Array<T *> &evicted) {
+		evicted.push_back(it->resource);
+
+		_size -= it->size;
+		_index.erase(it->resource);
+		return _entries.erase(it);
+	}
+
+	// Releasing a resource may well touch other resources in the cache, so
+	// this is only done once the cache is consistent again
+	void evictResources(const Array<T *> &evicted) {
+		for (uint i = 0; i < evicted.size(); i++) {
+			_stats.evictions++;
+			evict(evicted[i]);
+		}
+	}
+};
+
+} // End of namespace Common
+
+#endif
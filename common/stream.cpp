@@ -102,6 +102,13 @@ bool MemoryReadStream::seek(int32 offs, int whence) {
 	return true;	// FIXME: STREAM REWRITE
 }
 
+const byte *MemoryReadStream::getRange(uint32 offset, uint32 size) const {
+	if (offset > _size || size > _size - offset)
+		return 0;
+
+	return _ptrOrig + offset;
+}
+
 bool MemoryWriteStreamDynamic::seek(int32 offs, int whence) {
 	// Pre-Condition
 	assert(_pos <= _size);
@@ -261,6 +268,13 @@ bool SeekableSubReadStream::seek(int32 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getRange(uint32 offset, uint32 size) const {
+	if (offset > _end - _begin || size > _end - _begin - offset)
+		return 0;
+
+	return _parentStream->getRange(_begin + offset, size);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
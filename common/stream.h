@@ -527,6 +527,21 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Get direct access to a range of the stream data, without copying it.
+	 * This is only supported by streams which keep all their data in memory,
+	 * e.g. MemoryReadStream and memory mapped files, and substreams of them.
+	 * The stream position is not changed.
+	 *
+	 * The returned data stays valid as long as the stream exists.
+	 *
+	 * @param offset	start of the range, relative to the start of the stream
+	 * @param size	size of the range in bytes
+	 * @return a pointer to the data, or 0 if the range is not within the
+	 *         stream or the stream does not support direct access
+	 */
+	virtual const byte *getRange(uint32 offset, uint32 size) const { return 0; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
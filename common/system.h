@@ -1099,6 +1099,83 @@ public:
 	//@}
 
 
+	/**
+	 * @name Thread handling
+	 * Optional support for worker threads, used by Common::ThreadPool to
+	 * spread CPU heavy work over multiple cores. Engines should not create
+	 * threads themselves, but submit jobs to a thread pool instead.
+	 *
+	 * Backends without thread support keep the default implementations, in
+	 * which case createThread() always fails and thread pools do all their
+	 * work on the calling thread.
+	 */
+	//@{
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueCondition *ConditionRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Start a new thread.
+	 *
+	 * @param proc	the function to run on the new thread
+	 * @param param	an arbitrary pointer passed to proc
+	 * @param name	a name for the thread, for debugging purposes
+	 * @return the newly created thread, or 0 if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param, const char *name) { return 0; }
+
+	/**
+	 * Wait until the given thread has finished and free it.
+	 * @param thread	the thread to wait for.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Create a new condition variable.
+	 * @return the newly created condition variable, or 0 if an error occurred.
+	 */
+	virtual ConditionRef createCondition() { return 0; }
+
+	/**
+	 * Atomically unlock the mutex and wait until the condition variable is
+	 * signalled, then lock the mutex again. Spurious wakeups are possible,
+	 * so callers have to check the condition they wait for in a loop.
+	 *
+	 * @note The mutex must be locked exactly once by the calling thread.
+	 *
+	 * @param cond	the condition variable to wait on.
+	 * @param mutex	the mutex protecting the condition.
+	 */
+	virtual void waitCondition(ConditionRef cond, MutexRef mutex) {}
+
+	/**
+	 * Wake up one of the threads waiting on the condition variable.
+	 * @param cond	the condition variable to signal.
+	 */
+	virtual void signalCondition(ConditionRef cond) {}
+
+	/**
+	 * Wake up all threads waiting on the condition variable.
+	 * @param cond	the condition variable to signal.
+	 */
+	virtual void broadcastCondition(ConditionRef cond) {}
+
+	/**
+	 * Delete the given condition variable. No thread may be waiting on it.
+	 * @param cond	the condition variable to delete.
+	 */
+	virtual void deleteCondition(ConditionRef cond) {}
+
+	/**
+	 * @return the number of CPU cores available, or 1 if unknown.
+	 */
+	virtual int getCPUCount() { return 1; }
+
+	//@}
+
+
 
 	/** @name Sound */
 	//@{
@@ -0,0 +1,261 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/threadpool.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(ThreadPool);
+
+ThreadPool::ThreadPool(int threads)
+	: _mutex(0), _workAvailable(0), _jobDone(0), _nextQueue(0), _pending(0), _quit(false) {
+	// Without a backend, e.g. in the unit tests, jobs run when submitted
+	if (threads < 0)
+		threads = g_system ? g_system->getCPUCount() - 1 : 0;
+	if (threads <= 0)
+		return;
+
+	_mutex = g_system->createMutex();
+	_workAvailable = g_system->createCondition();
+	_jobDone = g_system->createCondition();
+	if (!_mutex || !_workAvailable || !_jobDone)
+		return;
+
+	// Keep the mutex locked, so the workers don't start before their
+	// queues are complete
+	g_system->lockMutex(_mutex);
+	for (int i = 0; i < threads; ++i) {
+		Worker *worker = new Worker;
+		worker->pool = this;
+		worker->index = i;
+		worker->thread = g_system->createThread(workerProc, worker, "ScummVM Worker");
+		if (!worker->thread) {
+			delete worker;
+			break;
+		}
+		_workers.push_back(worker);
+	}
+	g_system->unlockMutex(_mutex);
+
+	if (_workers.empty())
+		warning("ThreadPool: Could not create any worker threads");
+}
+
+ThreadPool::~ThreadPool() {
+	if (!_workers.empty()) {
+		waitAll();
+
+		g_system->lockMutex(_mutex);
+		_quit = true;
+		g_system->unlockMutex(_mutex);
+		g_system->broadcastCondition(_workAvailable);
+
+		// Workers look into each other's queues, so only delete them once
+		// all have stopped
+		for (uint i = 0; i < _workers.size(); ++i)
+			g_system->joinThread(_workers[i]->thread);
+		for (uint i = 0; i < _workers.size(); ++i)
+			delete _workers[i];
+	}
+
+	if (_jobDone)
+		g_system->deleteCondition(_jobDone);
+	if (_workAvailable)
+		g_system->deleteCondition(_workAvailable);
+	if (_mutex)
+		g_system->deleteMutex(_mutex);
+}
+
+void ThreadPool::submit(Job *job) {
+	job->_owned = true;
+	enqueue(job);
+}
+
+void ThreadPool::enqueue(Job *job) {
+	// Without workers, do the work right away
+	if (_workers.empty()) {
+		runJob(job);
+		return;
+	}
+
+	g_system->lockMutex(_mutex);
+	_workers[_nextQueue]->queue.push_back(job);
+	_nextQueue = (_nextQueue + 1) % _workers.size();
+	++_pending;
+	g_system->unlockMutex(_mutex);
+
+	g_system->signalCondition(_workAvailable);
+}
+
+Job *ThreadPool::takeJob(uint preferred) {
+	List<Job *> &own = _workers[preferred]->queue;
+	if (!own.empty()) {
+		Job *job = own.front();
+		own.pop_front();
+		return job;
+	}
+
+	for (uint i = 1; i < _workers.size(); ++i) {
+		List<Job *> &other = _workers[(preferred + i) % _workers.size()]->queue;
+		if (!other.empty()) {
+			Job *job = other.back();
+			other.pop_back();
+			return job;
+		}
+	}
+
+	return 0;
+}
+
+bool ThreadPool::removeJob(const Job *job) {
+	for (uint i = 0; i < _workers.size(); ++i) {
+		List<Job *> &queue = _workers[i]->queue;
+		for (List<Job *>::iterator j = queue.begin(); j != queue.end(); ++j) {
+			if (*j == job) {
+				queue.erase(j);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::runJob(Job *job) {
+	job->run();
+
+	// The job may be deleted by its future as soon as it is marked done.
+	// It may also have been handed over to the pool while it was running.
+	bool owned;
+	if (_workers.empty()) {
+		job->_done = true;
+		owned = job->_owned;
+	} else {
+		g_system->lockMutex(_mutex);
+		job->_done = true;
+		owned = job->_owned;
+		--_pending;
+		g_system->unlockMutex(_mutex);
+		g_system->broadcastCondition(_jobDone);
+	}
+
+	if (owned)
+		delete job;
+}
+
+bool ThreadPool::disown(Job *job) {
+	if (_workers.empty())
+		return false;
+
+	g_system->lockMutex(_mutex);
+	bool running = false;
+	if (removeJob(job)) {
+		// Nobody waits for the results, so don't run it at all
+		job->_done = true;
+		--_pending;
+	} else if (!job->_done) {
+		job->_owned = true;
+		running = true;
+	}
+	g_system->unlockMutex(_mutex);
+
+	if (!running)
+		g_system->broadcastCondition(_jobDone);
+	return running;
+}
+
+bool ThreadPool::isDone(const Job &job) {
+	if (_workers.empty())
+		return job._done;
+
+	g_system->lockMutex(_mutex);
+	const bool done = job._done;
+	g_system->unlockMutex(_mutex);
+	return done;
+}
+
+void ThreadPool::wait(const Job &job) {
+	if (_workers.empty()) {
+		assert(job._done);
+		return;
+	}
+
+	g_system->lockMutex(_mutex);
+	while (!job._done) {
+		// Only the job itself is taken from the queues. Running other jobs
+		// in the meantime could keep the caller busy for much longer than
+		// the job it waits for.
+		if (removeJob(&job)) {
+			g_system->unlockMutex(_mutex);
+			runJob(const_cast<Job *>(&job));
+			g_system->lockMutex(_mutex);
+		} else {
+			// The job is running on a worker
+			g_system->waitCondition(_jobDone, _mutex);
+		}
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+void ThreadPool::waitAll() {
+	if (_workers.empty())
+		return;
+
+	// All jobs have to finish anyway, so help with any of them
+	g_system->lockMutex(_mutex);
+	while (_pending) {
+		Job *other = takeJob(0);
+		if (other) {
+			g_system->unlockMutex(_mutex);
+			runJob(other);
+			g_system->lockMutex(_mutex);
+		} else {
+			g_system->waitCondition(_jobDone, _mutex);
+		}
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+void ThreadPool::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	worker->pool->workerLoop(worker->index);
+}
+
+void ThreadPool::workerLoop(uint index) {
+	g_system->lockMutex(_mutex);
+	while (true) {
+		Job *job = takeJob(index);
+		if (job) {
+			g_system->unlockMutex(_mutex);
+			runJob(job);
+			g_system->lockMutex(_mutex);
+		} else if (_quit) {
+			break;
+		} else {
+			g_system->waitCondition(_workAvailable, _mutex);
+		}
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+} // End of namespace Common
@@ -0,0 +1,267 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/system.h"
+
+namespace Common {
+
+class ThreadPool;
+
+/**
+ * A unit of work which can be run by a ThreadPool.
+ *
+ * Subclasses keep their input and their results as members and implement
+ * run(), which may be called on any thread. It must not touch data used by
+ * other threads without proper locking, and must not access the screen,
+ * the event queue or other OSystem services apart from mutexes.
+ */
+class Job : NonCopyable {
+	friend class ThreadPool;
+	template<class T> friend class Future;
+
+	bool _done;
+	bool _owned;
+	bool _detached;
+
+public:
+	Job() : _done(false), _owned(false), _detached(false) {}
+	virtual ~Job() {}
+
+	/** Do the actual work. */
+	virtual void run() = 0;
+};
+
+/**
+ * Job which calls a plain function.
+ */
+class FunctionJob : public Job {
+public:
+	typedef void (*Proc)(void *param);
+
+	FunctionJob(Proc proc, void *param) : _proc(proc), _param(param) {}
+	virtual void run() { _proc(_param); }
+
+private:
+	Proc _proc;
+	void *_param;
+};
+
+/**
+ * Handle to a job submitted with ThreadPool::async(). T is the job class,
+ * and get() gives access to its results once it has finished.
+ *
+ * Futures can be copied, but only within the thread which submitted the job.
+ * When the last copy is destroyed, the job is waited for (if it has not
+ * finished yet) and deleted, unless the future has been detached.
+ */
+template<class T>
+class Future {
+public:
+	Future() : _pool(0) {}
+	Future(ThreadPool *pool, const SharedPtr<T> &job) : _pool(pool), _job(job) {}
+
+	/** @return true if this refers to a job */
+	bool isValid() const { return _job; }
+
+	/** @return true if the job has finished, i.e. get() will not block */
+	bool isReady() const;
+
+	/**
+	 * Wait for the job to finish, running it on the calling thread if no
+	 * worker has started it yet, and return it.
+	 */
+	T &get() const;
+
+	/**
+	 * Do not wait for the job when the last copy of the future is
+	 * destroyed. A job which has not been started yet is dropped then, and
+	 * one which is running is deleted by the pool once it has finished.
+	 * This is only safe for jobs which do not refer to data of the caller.
+	 */
+	void detach() {
+		if (_job)
+			_job->_detached = true;
+	}
+
+private:
+	ThreadPool *_pool;
+	SharedPtr<T> _job;
+};
+
+/**
+ * A pool of worker threads for running CPU heavy jobs, e.g. video decoding
+ * or image scaling, in parallel.
+ *
+ * Every worker has its own job queue; submitted jobs are distributed over
+ * them in turn. Workers take jobs from the front of their own queue and,
+ * once it is empty, steal from the back of the others. A thread waiting for
+ * a job which is still queued runs that job itself, so nested waits cannot
+ * deadlock the pool. It does not run other queued jobs, so a short wait
+ * never ends up doing unrelated, longer work.
+ *
+ * If the backend does not support threads, or the pool is created without
+ * workers, jobs are run immediately when they are submitted.
+ *
+ * The shared pool, sized to the number of CPU cores, is available through
+ * ThreadPool::instance(). Engines must wait for all their jobs to finish
+ * before they quit, as the code of queued jobs may be unloaded with the
+ * engine plugin.
+ */
+class ThreadPool : public Singleton<ThreadPool> {
+public:
+	/**
+	 * @param threads number of worker threads; -1 uses one less than the
+	 *                number of CPU cores, as the thread submitting the jobs
+	 *                usually has work left to do, too.
+	 */
+	explicit ThreadPool(int threads = -1);
+
+	/** Waits for all jobs to finish and stops the workers. */
+	~ThreadPool();
+
+	/** @return the number of worker threads; 0 if jobs run when submitted */
+	uint getThreadCount() const { return _workers.size(); }
+
+	/**
+	 * Queue a job which nobody waits for. The pool takes ownership of the
+	 * job and deletes it after it has run.
+	 */
+	void submit(Job *job);
+
+	/** Queue a call of proc(param), see submit(Job *). */
+	void submit(FunctionJob::Proc proc, void *param) { submit(new FunctionJob(proc, param)); }
+
+	/**
+	 * Queue a job and return a future for it, which takes ownership of the
+	 * job.
+	 */
+	template<class T>
+	Future<T> async(T *job) {
+		SharedPtr<T> ptr(job, JobDeleter(this));
+		enqueue(job);
+		return Future<T>(this, ptr);
+	}
+
+	/** @return true if the given job has finished */
+	bool isDone(const Job &job);
+
+	/**
+	 * Wait until the given job has finished. If no worker has started the
+	 * job yet, it is run on the calling thread.
+	 */
+	void wait(const Job &job);
+
+	/**
+	 * Wait until all jobs have finished, running queued jobs on the calling
+	 * thread in the meantime.
+	 */
+	void waitAll();
+
+private:
+	struct Worker {
+		ThreadPool *pool;
+		uint index;
+		OSystem::ThreadRef thread;
+		List<Job *> queue;
+	};
+
+	/** Deleter for jobs owned by futures */
+	struct JobDeleter {
+		ThreadPool *pool;
+
+		JobDeleter(ThreadPool *p) : pool(p) {}
+
+		template<class T>
+		void operator()(T *job) {
+			if (job->_detached && pool->disown(job))
+				return;
+			pool->wait(*job);
+			delete job;
+		}
+	};
+
+	Array<Worker *> _workers;
+
+	OSystem::MutexRef _mutex;
+	/** Signalled when jobs are queued or the workers have to quit */
+	OSystem::ConditionRef _workAvailable;
+	/** Signalled when a job has finished */
+	OSystem::ConditionRef _jobDone;
+
+	/** Queue receiving the next submitted job */
+	uint _nextQueue;
+	/** Jobs which have been queued, but have not finished yet */
+	uint _pending;
+	bool _quit;
+
+	void enqueue(Job *job);
+
+	/**
+	 * Take the next job, preferably from the given worker's queue. Must be
+	 * called with the mutex locked.
+	 * @return the job, or 0 if all queues are empty
+	 */
+	Job *takeJob(uint preferred);
+
+	/**
+	 * Remove a job from the queues. Must be called with the mutex locked.
+	 * @return false if the job was not queued, i.e. it has been started
+	 */
+	bool removeJob(const Job *job);
+
+	/**
+	 * Hand a job over to the pool, which deletes it once it has run. A job
+	 * which has not been started yet is not run at all.
+	 * @return false if the job is finished and has to be deleted by the
+	 *         caller
+	 */
+	bool disown(Job *job);
+
+	/** Run a job and mark it finished. Must be called with the mutex unlocked. */
+	void runJob(Job *job);
+
+	static void workerProc(void *param);
+	void workerLoop(uint index);
+};
+
+template<class T>
+bool Future<T>::isReady() const {
+	return !_job || _pool->isDone(*_job);
+}
+
+template<class T>
+T &Future<T>::get() const {
+	_pool->wait(*_job);
+	return *_job;
+}
+
+} // End of namespace Common
+
+#endif
@@ -24,6 +24,7 @@
 #define COMMON_TIMER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/str.h"
 #include "common/noncopyable.h"
 
@@ -55,6 +56,24 @@ public:
 	 * and no instance of this callback will be running anymore.
 	 */
 	virtual void removeTimerProc(TimerProc proc) = 0;
+
+	/**
+	 * Statistics on an installed timer, for debugging purposes.
+	 */
+	struct TimerStats {
+		String id;
+		int32 interval;      ///< the interval in which the timer is invoked (in microseconds)
+		uint32 calls;        ///< number of times the callback has been invoked
+		uint32 maxDuration;  ///< longest time spent in the callback (in milliseconds)
+		uint32 maxLateness;  ///< largest delay of an invocation behind schedule (in milliseconds)
+	};
+	typedef Array<TimerStats> TimerStatsList;
+
+	/**
+	 * Return statistics on all installed timers. Timer managers which do
+	 * not gather any return an empty list.
+	 */
+	virtual TimerStatsList getTimerStats() { return TimerStatsList(); }
 };
 
 } // End of namespace Common
@@ -103,9 +103,13 @@ typedef struct {
 
 #endif  // !USE_ZLIB
 
+#include "common/array.h"
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -382,6 +386,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with open member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +549,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +601,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -644,7 +649,8 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The stream itself is released through _streamRef once the last member
+	// stream referencing it is gone.
 	delete s;
 	return UNZ_OK;
 }
@@ -1419,6 +1425,259 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+enum {
+	/**
+	 * Deflated members up to this size are still inflated into memory in
+	 * one go. For those, the one-shot inflate is cheaper than keeping a
+	 * z_stream, its window and an input buffer around for the lifetime of
+	 * the stream.
+	 */
+	kZipInlineInflateLimit = 64 * 1024,
+
+	/** Minimal distance (in uncompressed bytes) between two inflate checkpoints. */
+	kZipCheckpointInterval = 256 * 1024,
+
+	/** Maximal number of inflate checkpoints kept per member stream. */
+	kZipMaxCheckpoints = 32
+};
+
+/**
+ * A stored (uncompressed) ZIP member. The data is read straight from the
+ * archive stream; the stream reference keeps the archive data alive even if
+ * the ZipArchive is deleted before this stream.
+ */
+class ZipStoredReadStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archiveStream;
+
+public:
+	ZipStoredReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archiveStream.get(), begin, end, DisposeAfterUse::NO), _archiveStream(archiveStream) {
+	}
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * A deflated ZIP member which is inflated on demand.
+ *
+ * Every stream has its own z_stream and input buffer and seeks the archive
+ * stream before each refill, so any number of members can be read at the
+ * same time. If the archive is mapped into memory, the compressed data is
+ * inflated in place instead. While inflating, the inflate state is saved every
+ * _checkpointInterval bytes, so seeking backwards only has to re-inflate
+ * from the closest checkpoint instead of the start of the member.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	struct Checkpoint {
+		uint32 outPos;      ///< position in the uncompressed data
+		uint32 inPos;       ///< position in the compressed data
+		uLong crc;          ///< crc32 of the uncompressed data up to outPos
+		z_stream state;
+	};
+
+	SharedPtr<SeekableReadStream> _archiveStream;
+	const byte *_inData;    ///< compressed data, if the archive is mapped into memory
+	const uint32 _dataStart;
+	const uint32 _compressedSize;
+	const uint32 _uncompressedSize;
+	const uLong _expectedCrc;
+
+	z_stream _stream;
+	byte _inBuf[UNZ_BUFSIZE];
+	uint32 _inPos;
+	uint32 _pos;
+	uLong _crc;
+	int _zlibErr;
+	bool _eos;
+
+	Array<Checkpoint *> _checkpoints;
+	uint32 _checkpointInterval;
+
+	uint32 nextCheckpointPos() const {
+		if (_checkpoints.size() >= kZipMaxCheckpoints)
+			return _uncompressedSize;
+		return MIN<uint32>((_checkpoints.size() + 1) * _checkpointInterval, _uncompressedSize);
+	}
+
+	void addCheckpoint() {
+		Checkpoint *cp = new Checkpoint();
+		if (inflateCopy(&cp->state, &_stream) != Z_OK) {
+			delete cp;
+			// Stop taking further checkpoints; seeking will still work by
+			// restarting from an earlier one.
+			_checkpointInterval = _uncompressedSize + 1;
+			return;
+		}
+		cp->outPos = _pos;
+		cp->inPos = _inPos - _stream.avail_in;
+		cp->crc = _crc;
+		_checkpoints.push_back(cp);
+	}
+
+	bool restart(const Checkpoint *cp) {
+		if (cp) {
+			inflateEnd(&_stream);
+			_zlibErr = inflateCopy(&_stream, const_cast<z_stream *>(&cp->state));
+			_inPos = cp->inPos;
+			_pos = cp->outPos;
+			_crc = cp->crc;
+		} else {
+			_zlibErr = inflateReset(&_stream);
+			_inPos = 0;
+			_pos = 0;
+			_crc = 0;
+		}
+		_stream.next_in = _inBuf;
+		_stream.avail_in = 0;
+		return _zlibErr == Z_OK;
+	}
+
+	/** Inflate exactly len bytes (unless an error occurs) into dst. */
+	uint32 inflateBlock(byte *dst, uint32 len) {
+		_stream.next_out = dst;
+		_stream.avail_out = len;
+
+		while (_zlibErr == Z_OK && _stream.avail_out) {
+			if (_stream.avail_in == 0 && _inPos < _compressedSize && _inData) {
+				// Mapped archives are inflated in place
+				_stream.next_in = const_cast<byte *>(_inData + _inPos);
+				_stream.avail_in = _compressedSize - _inPos;
+				_inPos = _compressedSize;
+			} else if (_stream.avail_in == 0 && _inPos < _compressedSize) {
+				uint32 toRead = MIN<uint32>(UNZ_BUFSIZE, _compressedSize - _inPos);
+				_archiveStream->seek(_dataStart + _inPos, SEEK_SET);
+				uint32 bytesRead = _archiveStream->read(_inBuf, toRead);
+				if (bytesRead != toRead) {
+					_zlibErr = Z_ERRNO;
+					break;
+				}
+				_inPos += bytesRead;
+				_stream.next_in = _inBuf;
+				_stream.avail_in = bytesRead;
+			}
+
+			_zlibErr = inflate(&_stream, Z_SYNC_FLUSH);
+			// Running out of input before the end of the member means the
+			// archive is truncated.
+			if (_zlibErr == Z_BUF_ERROR && _stream.avail_in == 0 && _inPos >= _compressedSize)
+				_zlibErr = Z_DATA_ERROR;
+			else if (_zlibErr == Z_BUF_ERROR)
+				_zlibErr = Z_OK;
+		}
+
+		uint32 produced = len - _stream.avail_out;
+		_crc = crc32(_crc, dst, produced);
+		_pos += produced;
+
+		if (_pos == _uncompressedSize && _crc != _expectedCrc) {
+			warning("ZipInflateReadStream: CRC mismatch in archive member");
+			_zlibErr = Z_DATA_ERROR;
+		}
+
+		return produced;
+	}
+
+public:
+	ZipInflateReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 dataStart,
+	                     uint32 compressedSize, uint32 uncompressedSize, uLong crc)
+		: _archiveStream(archiveStream), _inData(archiveStream->getRange(dataStart, compressedSize)),
+		  _dataStart(dataStart), _compressedSize(compressedSize),
+		  _uncompressedSize(uncompressedSize), _expectedCrc(crc), _stream(), _inPos(0), _pos(0),
+		  _crc(0), _eos(false) {
+		_checkpointInterval = MAX<uint32>(kZipCheckpointInterval, _uncompressedSize / kZipMaxCheckpoints + 1);
+
+		// Negative MAX_WBITS tells zlib there's no zlib header
+		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_stream.next_in = _inBuf;
+		_stream.avail_in = 0;
+	}
+
+	~ZipInflateReadStream() {
+		for (uint i = 0; i < _checkpoints.size(); ++i) {
+			inflateEnd(&_checkpoints[i]->state);
+			delete _checkpoints[i];
+		}
+		inflateEnd(&_stream);
+	}
+
+	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
+	void clearErr() {
+		// only reset _eos; inflate errors are not recoverable
+		_eos = false;
+	}
+
+	bool eos() const { return _eos; }
+	int32 pos() const { return _pos; }
+	int32 size() const { return _uncompressedSize; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		byte *dst = (byte *)dataPtr;
+		uint32 total = 0;
+
+		while (dataSize > 0 && _zlibErr == Z_OK && _pos < _uncompressedSize) {
+			uint32 checkpointPos = nextCheckpointPos();
+			uint32 chunk = dataSize;
+			if (_pos < checkpointPos)
+				chunk = MIN(chunk, checkpointPos - _pos);
+			else
+				chunk = MIN(chunk, _uncompressedSize - _pos);
+
+			uint32 produced = inflateBlock(dst, chunk);
+			dst += produced;
+			total += produced;
+			dataSize -= produced;
+
+			if (_pos == checkpointPos && _pos < _uncompressedSize && _zlibErr == Z_OK)
+				addCheckpoint();
+		}
+
+		if (dataSize > 0)
+			_eos = true;
+
+		return total;
+	}
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		int32 newPos = 0;
+		switch (whence) {
+		case SEEK_SET:
+			newPos = offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_END:
+			newPos = _uncompressedSize + offset;
+			break;
+		}
+
+		if (newPos < 0 || (uint32)newPos > _uncompressedSize)
+			return false;
+
+		// Find the closest checkpoint at or before the target. Restart from
+		// it when seeking backwards, or when it lets us skip some inflating.
+		const Checkpoint *cp = 0;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= (uint32)newPos; ++i)
+			cp = _checkpoints[i];
+
+		if ((uint32)newPos < _pos || (cp && cp->outPos > _pos)) {
+			if (!restart(cp))
+				return false;
+		}
+
+		// Inflate forward to the requested position
+		byte tmpBuf[4096];
+		while (!err() && _pos < (uint32)newPos) {
+			if (read(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos)) == 0)
+				break;
+		}
+
+		_eos = false;
+		return _pos == (uint32)newPos;
+	}
+};
+
+#endif
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
@@ -1489,17 +1748,40 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	unz_s *const s = (unz_s *)_zipFile;
+	const unz_file_info &fileInfo = s->cur_file_info;
+
+	uInt iSizeVar;
+	uLong offsetLocalExtraField;
+	uInt sizeLocalExtraField;
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar, &offsetLocalExtraField, &sizeLocalExtraField) != UNZ_OK)
 		return 0;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+	const uint32 dataStart = s->cur_file_info_internal.offset_curfile + s->byte_before_the_zipfile +
+	                         SIZEZIPLOCALHEADER + iSizeVar;
+
+	// Stored members are handed out as a window into the archive stream.
+	if (fileInfo.compression_method == 0) {
+		if (fileInfo.compressed_size != fileInfo.uncompressed_size)
+			return 0;
+		return new ZipStoredReadStream(s->_streamRef, dataStart, dataStart + fileInfo.uncompressed_size);
+	}
+
+#ifdef USE_ZLIB
+	if (fileInfo.compression_method == Z_DEFLATED && fileInfo.uncompressed_size > kZipInlineInflateLimit)
+		return new ZipInflateReadStream(s->_streamRef, dataStart, fileInfo.compressed_size,
+		                                fileInfo.uncompressed_size, fileInfo.crc);
+#endif
+
+	// Small members are cheaper to inflate into memory in one go.
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
 	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
+		unzCloseCurrentFile(_zipFile);
 		free(buffer);
 		return 0;
 	}
@@ -1510,11 +1792,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -1522,7 +1799,8 @@ Archive *makeZipArchive(const String &name) {
 }
 
 Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+	// ZIP archives are game or theme data, which is never written to
+	return makeZipArchive(node.createMappedReadStream());
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream) {
@@ -54,6 +54,10 @@ Archive *makeZipArchive(const FSNode &node);
  * ZipArchive is deleted.
  *
  * May return 0 in case of a failure. In this case stream will still be deleted.
+ *
+ * Member streams created by the archive read directly from this stream and
+ * share ownership of it, so they stay valid after the ZipArchive is deleted.
+ * Larger deflated members are inflated on demand rather than up front.
  */
 Archive *makeZipArchive(SeekableReadStream *stream);
 
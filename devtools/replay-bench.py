@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+# encoding: utf-8
+#
+# Plays back a corpus of event recorder files as fast as possible, without
+# display, and collects the time each one took and whether the screens matched
+# the recorded ones. It is meant for a binary of the headless null backend
+# (configure --backend=null --enable-eventrecorder), whose clock and mixer
+# only follow the recording, so runs are reproducible.
+#
+# Recordings are named <target>.r<NN>, as created by the event recorder, and
+# are looked up in the save path, like ScummVM does. The results are written
+# as CSV, one line per recording. The script fails if any recording could not
+# be played back to the end or if any screen differed.
+#
+# --frame-logs also writes the per frame CSV log of the null backend for each
+# recording, named <recording>.csv. Other options are passed on to ScummVM;
+# recordings which end in a dialog of the engine need the --bench-frames they
+# were recorded with, as the recorder does not record events sent to dialogs.
+#
+# Example:
+#   devtools/replay-bench.py --scummvm=./scummvm --savepath=~/recordings \
+#       --output=results.csv --frame-logs=frames
+import sys
+import os
+import re
+import csv
+import argparse
+import subprocess
+
+RESULT_FIELDS = ('result', 'replayed_ms', 'wall_ms', 'cpu_ms', 'max_rss_kb', 'checked_screens', 'failed_screens')
+RECORDING_PATTERN = re.compile(r'^(.+)\.r\d\d$')
+
+def findRecordings(savePath):
+	recordings = []
+	for filename in sorted(os.listdir(savePath)):
+		match = RECORDING_PATTERN.match(filename)
+		if match:
+			recordings.append((filename, match.group(1)))
+	return recordings
+
+def playBack(scummvm, savePath, frameLogs, extraArgs, filename, target):
+	args = [scummvm, '--savepath=' + savePath, '--record-mode=bench', '--record-file-name=' + filename,
+		'--disable-display=1']
+	if frameLogs:
+		args.append('--bench-log=' + os.path.join(frameLogs, filename + '.csv'))
+	args += extraArgs + [target]
+	process = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+	output = process.communicate()[0]
+
+	# The event recorder ends the process once the recording is done, so the
+	# exit code tells nothing; look for the benchmark report instead
+	for line in output.splitlines():
+		if 'playback:action=benchmark' in line:
+			values = dict(re.findall(r'(\w+)=(\S+)', line))
+			return [values.get(field, '') for field in RESULT_FIELDS]
+
+	return ['crashed'] + [''] * (len(RESULT_FIELDS) - 1)
+
+def main():
+	parser = argparse.ArgumentParser(description='Play back event recorder files and report the time taken.')
+	parser.add_argument('--scummvm', default='./scummvm', help='ScummVM binary, built with the event recorder')
+	parser.add_argument('--savepath', required=True, help='directory holding the recordings')
+	parser.add_argument('--output', help='CSV file to write, standard output if not given')
+	parser.add_argument('--frame-logs', help='directory for the frame logs of the null backend')
+	parser.add_argument('recordings', nargs='*', help='recordings to play back, all in the save path if none given')
+	args, extraArgs = parser.parse_known_args()
+
+	savePath = os.path.expanduser(args.savepath)
+	frameLogs = os.path.expanduser(args.frame_logs) if args.frame_logs else None
+	if frameLogs and not os.path.isdir(frameLogs):
+		os.makedirs(frameLogs)
+	if args.recordings:
+		recordings = []
+		for filename in args.recordings:
+			match = RECORDING_PATTERN.match(filename)
+			if not match:
+				print ("Not a recording name: " + filename)
+				return 1
+			recordings.append((filename, match.group(1)))
+	else:
+		recordings = findRecordings(savePath)
+
+	output = open(args.output, 'w') if args.output else sys.stdout
+	writer = csv.writer(output)
+	writer.writerow(('recording', 'target') + RESULT_FIELDS)
+
+	failures = 0
+	for filename, target in recordings:
+		row = playBack(args.scummvm, savePath, frameLogs, extraArgs, filename, target)
+		writer.writerow([filename, target] + row)
+		output.flush()
+		if row[0] != 'success' or row[-1] != '0':
+			failures += 1
+
+	if output is not sys.stdout:
+		output.close()
+
+	if failures:
+		sys.stderr.write("%d of %d recordings failed\n" % (failures, len(recordings)))
+		return 1
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -23,14 +23,13 @@
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
-#include "common/macresman.h"
-#include "common/md5.h"
 #include "common/config-manager.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "gui/EventRecorder.h"
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "engines/obsolete.h"
 
 static GameDescriptor toGameDescriptor(const ADGameDescription &g, const PlainGameDescriptor *sg) {
@@ -164,6 +163,7 @@ GameList AdvancedMetaEngine::detectGames(const Common::FSList &fslist) const {
 
 	if (matches.empty()) {
 		// Use fallback detector if there were no matches by other means
+		Common::StackLock lock(DetectionMan.getDetectorMutex());
 		const ADGameDescription *fallbackDesc = fallbackDetect(allFiles, fslist);
 		if (fallbackDesc != 0) {
 			GameDescriptor desc(toGameDescriptor(*fallbackDesc, _gameIds));
@@ -259,6 +259,8 @@ Common::Error AdvancedMetaEngine::createInstance(OSystem *syst, Engine **engine)
 	if (files.empty())
 		return Common::kNoGameDataFoundError;
 
+	DetectionPass pass;
+
 	// Compose a hashmap of all files in fslist.
 	FileMap allFiles;
 	composeFileHashMap(allFiles, files, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
@@ -371,7 +373,7 @@ void AdvancedMetaEngine::composeFileHashMap(FileMap &allFiles, const Common::FSL
 			if (!matched)
 				continue;
 
-			if (!file->getChildren(files, Common::FSNode::kListAll))
+			if (!DetectionMan.getChildren(*file, files))
 				continue;
 
 			composeFileHashMap(allFiles, files, depth - 1, tstr);
@@ -390,14 +392,9 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	// file and as one with resource fork.
 
 	if (game.flags & ADGF_MACRESFORK) {
-		Common::MacResManager macResMan;
-
-		if (!macResMan.open(parent, fname))
+		if (!DetectionMan.getResForkProperties(parent, fname, _md5Bytes, fileProps))
 			return false;
 
-		fileProps.md5 = macResMan.computeResForkMD5AsString(_md5Bytes);
-		fileProps.size = macResMan.getResForkDataSize();
-
 		if (fileProps.size != 0)
 			return true;
 	}
@@ -405,14 +402,7 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
-	Common::File testFile;
-
-	if (!testFile.open(allFiles[fname]))
-		return false;
-
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
-	return true;
+	return DetectionMan.getFileProperties(allFiles[fname], _md5Bytes, fileProps);
 }
 
 ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
@@ -530,6 +520,7 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 	// We didn't find a match
 	if (matched.empty()) {
 		if (!filesProps.empty() && gotAnyMatchesWithAllFiles) {
+			Common::StackLock lock(DetectionMan.getDetectorMutex());
 			reportUnknown(parent, filesProps);
 		}
 
@@ -275,6 +275,12 @@ public:
 
 	virtual GameList detectGames(const Common::FSList &fslist) const;
 
+	/**
+	 * The MD5 based detection is thread safe. Fallback detectors often fill
+	 * in static descriptions, so they are run one at a time.
+	 */
+	virtual bool isDetectionThreadSafe() const { return true; }
+
 	virtual Common::Error createInstance(OSystem *syst, Engine **engine) const;
 
 	virtual const ExtraGuiOptions getExtraGuiOptions(const Common::String &target) const;
@@ -0,0 +1,283 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/detectioncache.h"
+
+#include "common/debug.h"
+#include "common/file.h"
+#include "common/macresman.h"
+#include "common/md5.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const char *const kCacheFileName = "detection.cache";
+static const char *const kCacheHeader = "ScummVM detection cache 1";
+
+DetectionCache::DetectionCache() : _passDepth(0), _concurrentPasses(0), _loaded(false), _dirty(false) {
+}
+
+void DetectionCache::beginPass(bool concurrent) {
+	Common::StackLock lock(_mutex);
+	_passDepth++;
+	if (concurrent)
+		_concurrentPasses++;
+}
+
+void DetectionCache::endPass(bool concurrent) {
+	Common::StackLock lock(_mutex);
+
+	assert(_passDepth > 0);
+	if (concurrent)
+		_concurrentPasses--;
+	if (--_passDepth > 0)
+		return;
+
+	_listings.clear();
+	_resForks.clear();
+
+	// Only keep the file properties which can be validated later
+	for (FileEntryMap::iterator i = _files.begin(); i != _files.end(); ++i)
+		if (!i->_value.persistent)
+			_files.erase(i);
+
+	if (_dirty)
+		save();
+}
+
+bool DetectionCache::getChildren(const Common::FSNode &dir, Common::FSList &list) {
+	const Common::String path = dir.getPath();
+
+	_mutex.lock();
+	const bool usePass = _passDepth > 0 && _concurrentPasses == 0;
+	if (usePass) {
+		ListingMap::const_iterator cached = _listings.find(path);
+		if (cached != _listings.end()) {
+			list = cached->_value;
+			_mutex.unlock();
+			return true;
+		}
+	}
+	_mutex.unlock();
+
+	if (!dir.getChildren(list, Common::FSNode::kListAll))
+		return false;
+
+	if (usePass) {
+		Common::StackLock lock(_mutex);
+		_listings[path] = list;
+	}
+
+	return true;
+}
+
+bool DetectionCache::getFileProperties(const Common::FSNode &file, uint md5Bytes, ADFileProperties &props) {
+	const Common::String key = Common::String::format("%u:%s", md5Bytes, file.getPath().c_str());
+
+	uint32 size, modificationTime;
+	const bool persistent = file.getFileStatus(size, modificationTime);
+
+	_mutex.lock();
+	load();
+
+	const bool usePass = _passDepth > 0;
+
+	FileEntryMap::const_iterator cached = _files.find(key);
+	if (cached != _files.end()) {
+		const FileEntry &entry = cached->_value;
+
+		// Without a modification time, entries are only valid for one pass
+		if (persistent ? (entry.persistent && entry.size == size && entry.modificationTime == modificationTime) : usePass) {
+			props.size = (int32)entry.size;
+			// Copy the characters, as strings share their buffers without locking
+			props.md5 = entry.md5.c_str();
+			_mutex.unlock();
+			return true;
+		}
+	}
+	_mutex.unlock();
+
+	Common::File testFile;
+
+	if (!testFile.open(file))
+		return false;
+
+	props.size = (int32)testFile.size();
+	props.md5 = Common::computeStreamMD5AsString(testFile, md5Bytes);
+
+	if (persistent || usePass) {
+		Common::StackLock lock(_mutex);
+
+		FileEntry &entry = _files[key];
+		entry.size = props.size;
+		entry.modificationTime = persistent ? modificationTime : 0;
+		entry.persistent = persistent;
+		entry.md5 = props.md5.c_str();
+
+		// Saved when the pass ends
+		if (persistent)
+			_dirty = true;
+	}
+
+	return true;
+}
+
+bool DetectionCache::getResForkProperties(const Common::FSNode &parent, const Common::String &fname, uint md5Bytes, ADFileProperties &props) {
+	// The resource fork may be stored in one of several files, so it is not
+	// saved to disk
+	const Common::String key = Common::String::format("%u:%s/%s", md5Bytes, parent.getPath().c_str(), fname.c_str());
+
+	_mutex.lock();
+	const bool usePass = _passDepth > 0;
+	if (usePass) {
+		ResForkMap::const_iterator cached = _resForks.find(key);
+		if (cached != _resForks.end()) {
+			props.size = cached->_value.size;
+			props.md5 = cached->_value.md5.c_str();
+			_mutex.unlock();
+			return props.size >= 0;
+		}
+	}
+	_mutex.unlock();
+
+	Common::MacResManager macResMan;
+
+	if (macResMan.open(parent, fname)) {
+		props.md5 = macResMan.computeResForkMD5AsString(md5Bytes);
+		props.size = macResMan.getResForkDataSize();
+	} else {
+		props.md5.clear();
+		props.size = -1;
+	}
+
+	if (usePass) {
+		Common::StackLock lock(_mutex);
+
+		ADFileProperties &entry = _resForks[key];
+		entry.size = props.size;
+		entry.md5 = props.md5.c_str();
+	}
+
+	return props.size >= 0;
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+
+	// Command line detection runs before the backend is initialized
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	_loaded = true;
+
+	Common::InSaveFile *in = saveFileMan->openForLoading(kCacheFileName);
+	if (!in)
+		return;
+
+	if (in->readLine() != kCacheHeader) {
+		warning("Ignoring detection cache of an unknown version");
+		delete in;
+		return;
+	}
+
+	// Each line holds the MD5 length, the size, the modification time, the
+	// MD5 and the path of a file, separated by tabs
+	while (!in->eos() && !in->err()) {
+		const Common::String line = in->readLine();
+		if (line.empty())
+			continue;
+
+		const char *p = line.c_str();
+		char *end;
+
+		const uint md5Bytes = strtoul(p, &end, 10);
+		if (*end != '\t')
+			continue;
+
+		FileEntry entry;
+		entry.persistent = true;
+
+		entry.size = strtoul(end + 1, &end, 10);
+		if (*end != '\t')
+			continue;
+
+		entry.modificationTime = strtoul(end + 1, &end, 10);
+		if (*end != '\t')
+			continue;
+
+		p = end + 1;
+		const char *tab = strchr(p, '\t');
+		if (!tab)
+			continue;
+
+		entry.md5 = Common::String(p, tab);
+		_files[Common::String::format("%u:%s", md5Bytes, tab + 1)] = entry;
+	}
+
+	debug(2, "Read %d entries from the detection cache", _files.size());
+	delete in;
+}
+
+void DetectionCache::save() {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	// Merge the saved entries first, if they have not been read yet
+	load();
+
+	_dirty = false;
+
+	Common::OutSaveFile *out = saveFileMan->openForSaving(kCacheFileName, false);
+	if (!out) {
+		warning("Could not save the detection cache");
+		return;
+	}
+
+	out->writeString(kCacheHeader);
+	out->writeByte('\n');
+
+	for (FileEntryMap::const_iterator i = _files.begin(); i != _files.end(); ++i) {
+		const FileEntry &entry = i->_value;
+		if (!entry.persistent)
+			continue;
+
+		// The key is the MD5 length and the path, separated by a colon
+		const Common::String &key = i->_key;
+		const char *path = strchr(key.c_str(), ':') + 1;
+		const Common::String md5Bytes(key.c_str(), path - 1);
+
+		out->writeString(Common::String::format("%s\t%u\t%u\t%s\t%s\n", md5Bytes.c_str(),
+				entry.size, entry.modificationTime, entry.md5.c_str(), path));
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not save the detection cache");
+
+	delete out;
+}
@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+#include "engines/advancedDetector.h"
+
+/**
+ * Cache of the file properties needed for detecting games, shared by all
+ * engines.
+ *
+ * During a detection pass, e.g. one EngineManager::detectGames() call, all
+ * directory listings and file properties are kept in memory, so each file is
+ * only hashed once, however many engines look at it. Outside of a pass, only
+ * the properties saved to disk are used.
+ *
+ * The MD5s of files whose modification time the backend can tell are also
+ * saved to disk, together with the file size and modification time, so they
+ * don't need to be computed again as long as the file does not change.
+ *
+ * The cache may be used by several threads at once. As FSNodes may not be
+ * shared between threads, each directory must only be detected by one thread
+ * at a time, though.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	DetectionCache();
+
+	/**
+	 * Start a detection pass. Passes may be nested, the cache is only
+	 * cleared and saved when the outermost one ends.
+	 *
+	 * @param concurrent	true if directories are listed by several threads
+	 *			during the pass. Listings are not kept then, as the
+	 *			FSNodes in them would be shared between threads.
+	 */
+	void beginPass(bool concurrent = false);
+
+	/** End a detection pass. */
+	void endPass(bool concurrent = false);
+
+	/**
+	 * List all files and directories in dir, like FSNode::getChildren(). The
+	 * listing is kept until the end of the current detection pass.
+	 */
+	bool getChildren(const Common::FSNode &dir, Common::FSList &list);
+
+	/**
+	 * Get the size of a file and the MD5 of its first md5Bytes bytes, or of
+	 * all of it if md5Bytes is 0.
+	 */
+	bool getFileProperties(const Common::FSNode &file, uint md5Bytes, ADFileProperties &props);
+
+	/**
+	 * Get the size and MD5 of the resource fork of the file fname in the
+	 * directory parent, see Common::MacResManager::computeResForkMD5AsString().
+	 *
+	 * @return false if the file could not be opened; props.size is 0 if the
+	 *         file has no resource fork.
+	 */
+	bool getResForkProperties(const Common::FSNode &parent, const Common::String &fname, uint md5Bytes, ADFileProperties &props);
+
+	/**
+	 * Mutex to lock while running detection code which is not thread safe,
+	 * see MetaEngine::isDetectionThreadSafe().
+	 */
+	Common::Mutex &getDetectorMutex() { return _detectorMutex; }
+
+private:
+	struct FileEntry {
+		uint32 size;
+		uint32 modificationTime;
+		bool persistent; ///< Is the modification time known, so the entry can be saved?
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, FileEntry> FileEntryMap;
+	typedef Common::HashMap<Common::String, Common::FSList> ListingMap;
+	typedef Common::HashMap<Common::String, ADFileProperties> ResForkMap;
+
+	Common::Mutex _mutex; ///< Guards all members below.
+	Common::Mutex _detectorMutex;
+
+	int _passDepth;
+	int _concurrentPasses; ///< Number of active passes listing on several threads.
+
+	FileEntryMap _files;  ///< File properties, keyed by MD5 length and path.
+	ListingMap _listings; ///< Directory listings of the current pass.
+	ResForkMap _resForks; ///< Resource fork properties of the current pass.
+
+	bool _loaded; ///< Has the cache file been read?
+	bool _dirty;  ///< Are there persistent entries not yet saved?
+
+	void load();
+	void save();
+};
+
+/** Shortcut for accessing the detection cache. */
+#define DetectionMan DetectionCache::instance()
+
+/**
+ * Auxiliary class to begin and end a detection pass on the stack.
+ */
+class DetectionPass {
+public:
+	DetectionPass(bool concurrent = false) : _concurrent(concurrent) { DetectionMan.beginPass(concurrent); }
+	~DetectionPass() { DetectionMan.endPass(_concurrent); }
+
+private:
+	bool _concurrent;
+};
+
+#endif
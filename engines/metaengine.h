@@ -81,6 +81,13 @@ public:
 	 */
 	virtual GameList detectGames(const Common::FSList &fslist) const = 0;
 
+	/**
+	 * Returns whether detectGames() may run on several threads at once, for
+	 * different directories. If not, the engine manager makes sure that only
+	 * one such detector runs at a time.
+	 */
+	virtual bool isDetectionThreadSafe() const { return false; }
+
 	/**
 	 * Tries to instantiate an engine instance based on the settings of
 	 * the currently active ConfMan target. That is, the MetaEngine should
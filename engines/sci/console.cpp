@@ -69,6 +69,8 @@ namespace Sci {
 int g_debug_sleeptime_factor = 1;
 int g_debug_simulated_key = 0;
 bool g_debug_track_mouse_clicks = false;
+bool g_debug_validate_vm = false;
+bool g_debug_keep_decoded_instructions = true;
 
 // Refer to the "addresses" command on how to pass address parameters
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest, bool mayBeValue);
@@ -84,6 +86,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
+	registerVar("validate_vm",		&g_debug_validate_vm);
 	// FIXME: This actually passes an enum type instead of an integer but no
 	// precaution is taken to assure that all assigned values are in the range
 	// of the enum type. We should handle this more carefully...
@@ -113,6 +116,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -160,6 +164,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -221,6 +226,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("vm_benchmark",		WRAP_METHOD(Console, cmdVMBenchmark));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -334,6 +340,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
+	debugPrintf("validate_vm: Warns about accesses to invalid variables and properties, which are otherwise ignored\n");
 	debugPrintf("weak_validations: Turns some validation errors into warnings\n");
 	debugPrintf("script_abort_flag: Set to 1 to abort script execution. Set to 2 to force a replay afterwards\n");
 	debugPrintf("\n");
@@ -369,6 +376,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows the memory use and hit rate of the resource cache\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -411,6 +419,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times and released memory of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -454,7 +463,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" bp_function / bpe - Sets a breakpoint on the execution of the specified exported function\n");
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
-	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" script_steps - Shows the number of executed SCI operations and decoded instructions\n");
+	debugPrintf(" vm_benchmark - Measures the executed SCI operations per second of a method\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1016,6 +1026,30 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	Common::ResourceCacheBase &cache = _engine->getResMan()->getLRU();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache.resetStatistics();
+		debugPrintf("Resource cache statistics reset\n");
+		return true;
+	}
+
+	if (argc != 1) {
+		debugPrintf("Shows the memory use and hit rate of the resource cache.\n");
+		debugPrintf("The budget can be changed with the %s config key.\n", Common::ResourceCacheBase::kBudgetConfigKey);
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const Common::ResourceCacheBase::Statistics &stats = cache.getStatistics();
+	debugPrintf("Budget: %u KB\n", cache.getBudget() / 1024);
+	debugPrintf("Cached: %u KB, locked: %u KB\n", cache.getSize() / 1024, cache.getPinnedSize() / 1024);
+	debugPrintf("Hits: %u, misses: %u, evictions: %u\n", stats.hits, stats.misses, stats.evictions);
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2604,6 +2638,36 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStatistics &stats = _engine->_gamestate->_gcStats;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	}
+
+	if (argc != 1) {
+		debugPrintf("Shows the pause times and released memory of the garbage collector.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Collections: %u, %u of them while the game was idle\n", stats.runs, stats.idleRuns);
+	const int countDown = _engine->_gamestate->gcCountDown;
+	if (countDown > 0)
+		debugPrintf("Next collection due in %d kernel calls\n", countDown);
+	else
+		debugPrintf("Next collection due while idle, or in %d kernel calls at the latest\n",
+		            MAX(countDown + _engine->_gamestate->scriptGCInterval, 0));
+	debugPrintf("Pause: last %u ms, longest %u ms, average %u ms\n", stats.lastPause, stats.maxPause,
+	            stats.runs ? stats.totalPause / stats.runs : 0);
+	debugPrintf("Released by the last collection: %u objects, %u bytes\n", stats.lastFreed, stats.lastFreedBytes);
+	debugPrintf("Released in total: %u objects, %u KB\n", stats.totalFreed, (uint)(stats.totalFreedBytes / 1024));
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3080,6 +3144,94 @@ bool Console::cmdViewAccumulatorObject(int argc, const char **argv) {
 
 bool Console::cmdScriptSteps(int argc, const char **argv) {
 	debugPrintf("Number of executed SCI operations: %d\n", _engine->_gamestate->scriptStepCounter);
+
+	// Compared to the executed operations, this shows how often the
+	// decoded instructions are reused
+	uint decoded = 0, size = 0;
+	for (uint i = 0; i < _engine->_gamestate->_segMan->_heap.size(); i++) {
+		SegmentObj *mobj = _engine->_gamestate->_segMan->_heap[i];
+		if (mobj && mobj->getType() == SEG_TYPE_SCRIPT) {
+			decoded += ((Script *)mobj)->getDecodedInstructionCount();
+			size += ((Script *)mobj)->getDecodedInstructionSize();
+		}
+	}
+	debugPrintf("Decoded instructions in loaded scripts: %u (%u bytes)\n", decoded, size);
+	return true;
+}
+
+bool Console::cmdVMBenchmark(int argc, const char **argv) {
+	if (argc < 3) {
+		debugPrintf("Sends a message to an object repeatedly, and shows the number of SCI operations\n");
+		debugPrintf("executed per second, with and without keeping the decoded instructions.\n");
+		debugPrintf("The message is sent without parameters, and changes the game state like \"send\".\n");
+		debugPrintf("Usage: %s <object> <selector name> [<count>]\n", argv[0]);
+		debugPrintf("Example: %s ?fooScript doit 1000\n", argv[0]);
+		return true;
+	}
+
+	EngineState *s = _engine->_gamestate;
+	reg_t object;
+
+	if (parse_reg_t(s, argv[1], &object, false)) {
+		debugPrintf("Invalid address \"%s\" passed.\n", argv[1]);
+		debugPrintf("Check the \"addresses\" command on how to use addresses\n");
+		return true;
+	}
+
+	const int selectorId = _engine->getKernel()->findSelector(argv[2]);
+	if (selectorId < 0) {
+		debugPrintf("Unknown selector: \"%s\"\n", argv[2]);
+		return true;
+	}
+
+	if (!s->_segMan->getObject(object)) {
+		debugPrintf("Address \"%04x:%04x\" is not an object\n", PRINT_REG(object));
+		return true;
+	}
+
+	if (lookupSelector(s->_segMan, object, selectorId, NULL, NULL) != kSelectorMethod) {
+		debugPrintf("Object has no method \"%s\"\n", argv[2]);
+		return true;
+	}
+
+	const int count = (argc > 3) ? atoi(argv[3]) : 100;
+	const reg_t oldAcc = s->r_acc;
+
+	for (int pass = 0; pass < 2; pass++) {
+		// Start both passes without decoded instructions, so that they
+		// execute the same instructions
+		for (uint i = 0; i < s->_segMan->_heap.size(); i++) {
+			SegmentObj *mobj = s->_segMan->_heap[i];
+			if (mobj && mobj->getType() == SEG_TYPE_SCRIPT)
+				((Script *)mobj)->dropDecodedInstructions();
+		}
+		g_debug_keep_decoded_instructions = (pass == 1);
+
+		const int steps = s->scriptStepCounter;
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < count; i++) {
+			// Same as "send" without parameters
+			StackPtr stackframe = s->_executionStack.back().sp;
+			stackframe[0] = make_reg(0, selectorId);
+			stackframe[1] = NULL_REG;
+
+			ExecStack *oldXStack = &s->_executionStack.back();
+			if (send_selector(s, object, object, stackframe + 2, 2, stackframe) != oldXStack) {
+				s->_executionStackPosChanged = true;
+				run_vm(s);
+				s->xs = oldXStack;
+			}
+		}
+		const uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+		const int executed = s->scriptStepCounter - steps;
+
+		debugPrintf("%s: %d operations in %u ms, %u operations per second\n",
+			pass ? "Decoded once" : "Decoded on each execution", executed, time,
+			(uint)((uint64)executed * 1000 / time));
+	}
+
+	s->r_acc = oldAcc;
+	g_debug_keep_decoded_instructions = true;
 	return true;
 }
 
@@ -92,6 +92,8 @@ struct DebugState {
 extern int g_debug_sleeptime_factor;
 extern int g_debug_simulated_key;
 extern bool g_debug_track_mouse_clicks;
+extern bool g_debug_validate_vm;
+extern bool g_debug_keep_decoded_instructions;
 
 } // End of namespace Sci
 
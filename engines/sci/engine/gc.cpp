@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -112,13 +113,16 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	// We do this one by hand since the stack doesn't know the current execution stack
 	Common::List<ExecStack>::const_iterator iter = s->_executionStack.reverse_begin();
 
-	// Skip fake kernel stack frame if it's on top
+	// Skip fake kernel stack frame if it's on top. The arguments of the
+	// kernel call are above the stack pointer of its caller, so keep its
+	// stack pointer, as the kernel function may still use them.
+	StackPtr sp = iter->sp;
 	if ((*iter).type == EXEC_STACK_TYPE_KERNEL)
 		--iter;
 
 	assert((iter != s->_executionStack.end()) && ((*iter).type != EXEC_STACK_TYPE_KERNEL));
 
-	const StackPtr sp = iter->sp;
+	sp = MAX(sp, iter->sp);
 
 	for (reg_t *pos = s->stack_base; pos < sp; pos++)
 		wm.push(*pos);
@@ -181,6 +185,11 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	GCStatistics &stats = s->_gcStats;
+	const uint32 startTime = g_system->getMillis();
+	uint32 freed = 0, freedBytes = 0;
+
+	s->gcCountDown = s->scriptGCInterval;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -213,6 +222,11 @@ void run_gc(EngineState *s) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
+					const uint size = mobj->getFreeableSize(addr);
+					if (size) {
+						freed++;
+						freedBytes += size;
+					}
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
@@ -226,6 +240,16 @@ void run_gc(EngineState *s) {
 
 	delete activeRefs;
 
+	stats.runs++;
+	stats.lastPause = g_system->getMillis() - startTime;
+	stats.maxPause = MAX(stats.maxPause, stats.lastPause);
+	stats.totalPause += stats.lastPause;
+	stats.lastFreed = freed;
+	stats.lastFreedBytes = freedBytes;
+	stats.totalFreed += freed;
+	stats.totalFreedBytes += freedBytes;
+	debugC(kDebugLevelGC, "[GC] Released %u objects, %u bytes in %u ms", freed, freedBytes, stats.lastPause);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -235,4 +259,17 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+uint32 run_gc_idle(EngineState *s, uint32 idleTime) {
+	if (s->gcCountDown > 0 || s->_gcStats.lastPause > idleTime)
+		return 0;
+
+	// Roots are only known while the VM is inside a kernel call
+	if (s->_executionStack.empty() || s->_executionStack.back().type != EXEC_STACK_TYPE_KERNEL)
+		return 0;
+
+	run_gc(s);
+	s->_gcStats.idleRuns++;
+	return s->_gcStats.lastPause;
+}
+
 } // End of namespace Sci
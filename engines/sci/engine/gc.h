@@ -55,6 +55,24 @@ AddrSet *findAllActiveReferences(EngineState *s);
  */
 void run_gc(EngineState *s);
 
+/**
+ * Runs garbage collection if one is due and the last one took no longer than
+ * the given time, so the pause falls into time the game would otherwise spend
+ * waiting. Collections which are due but never fit are run by the VM once
+ * they are overdue. This only moves the full collection, it does no less work.
+ *
+ * Must only be called from within kernel functions, at a point where they
+ * hold no heap references other than their arguments, as nothing else is
+ * rooted: the end of kFrameOut, the event loop throttling of kGetEvent and
+ * kGameIsRestarting. Transitions and kEditText throttle while they hold
+ * bitmaps only referenced from C++, so they and the palette fades, which are
+ * called from all over the engine, don't collect.
+ * @param s        The state in which we should gc
+ * @param idleTime The time available, in ms
+ * @return the time spent collecting, in ms
+ */
+uint32 run_gc_idle(EngineState *s, uint32 idleTime);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
@@ -102,7 +102,7 @@ reg_t kGetEvent(EngineState *s, int argc, reg_t *argv) {
 		// throttling the VM.
 		if (++s->_eventCounter > 2) {
 			g_sci->_gfxFrameout->updateScreen();
-			s->speedThrottler(10); // 10ms is an arbitrary value
+			s->speedThrottler(10, true); // 10ms is an arbitrary value
 			s->_throttleTrigger = true;
 		}
 	} else {
@@ -109,7 +109,7 @@ reg_t kGameIsRestarting(EngineState *s, int argc, reg_t *argv) {
 		break;
 	}
 
-	s->speedThrottler(neededSleep);
+	s->speedThrottler(neededSleep, true);
 	return s->r_acc;
 }
 
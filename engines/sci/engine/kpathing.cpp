@@ -24,6 +24,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -111,10 +112,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Number of the vertex in the AvoidPathCache, -1 if not cached
+	int _cacheId;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		_cacheId = -1;
 	}
 };
 
@@ -221,8 +226,26 @@ struct Polygon {
 	// Circular list of vertices
 	CircularVertexList vertices;
 
+	// Bounding box of the vertices
+	Common::Point _boundsMin, _boundsMax;
+
+	// Bit of the polygon in the AvoidPathCache, 0 if not cached
+	uint32 _cacheMask;
+
 public:
-	Polygon(int t) : type(t) {
+	Polygon(int t) : type(t), _cacheMask(0) {
+	}
+
+	void updateBounds() {
+		Vertex *vertex;
+
+		_boundsMin = _boundsMax = vertices.first()->v;
+		CLIST_FOREACH(vertex, &vertices) {
+			_boundsMin.x = MIN(_boundsMin.x, vertex->v.x);
+			_boundsMin.y = MIN(_boundsMin.y, vertex->v.y);
+			_boundsMax.x = MAX(_boundsMax.x, vertex->v.x);
+			_boundsMax.y = MAX(_boundsMax.y, vertex->v.y);
+		}
 	}
 
 	~Polygon() {
@@ -257,7 +280,19 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Visibility graph cache, NULL if not used for this call
+	AvoidPathCache *_cache;
+
+	// Bits of the polygons of this call in the cache
+	uint32 _cacheMask;
+
+	// Set if polygons with edges are not in the cache
+	bool _uncachedPolygons;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
+		_cache = NULL;
+		_cacheMask = 0;
+		_uncachedPolygons = false;
 		vertex_start = NULL;
 		vertex_end = NULL;
 		vertex_index = NULL;
@@ -659,6 +694,145 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether the line between two vertices passes through the inside
+ * of the polygons of either vertex right at the vertex
+ * Parameters: (Vertex *) a, b: The vertices
+ * Returns   : (bool) true if the line leaves a or b through the inside of its polygon
+ */
+static bool hidden_locally(Vertex *a, Vertex *b) {
+	return inside(b->v, a) || inside(a->v, b);
+}
+
+/**
+ * Determines whether an edge of a polygon blocks the line of sight between
+ * two points
+ * Parameters: (const Polygon *) polygon: The polygon
+ *             (const Common::Point &) a, b: The line (a, b)
+ * Returns   : (bool) true if the line intersects an edge of the polygon, or
+ *                    passes through one of its vertices into its inside
+ */
+static bool polygon_blocks(const Polygon *polygon, const Common::Point &a, const Common::Point &b) {
+	const int16 minX = MIN(a.x, b.x), maxX = MAX(a.x, b.x);
+	const int16 minY = MIN(a.y, b.y), maxY = MAX(a.y, b.y);
+
+	// Neither touching a vertex nor intersecting an edge is possible outside
+	// of the bounding box of the line, so skip polygons and edges which
+	// do not overlap it. This does not hold for lines of zero length, for
+	// which between() gives odd results we need to keep.
+	const bool cull = (a != b);
+
+	if (cull && (polygon->_boundsMax.x < minX || polygon->_boundsMin.x > maxX || polygon->_boundsMax.y < minY || polygon->_boundsMin.y > maxY))
+		return false;
+
+	Vertex *edge;
+
+	CLIST_FOREACH(edge, &polygon->vertices) {
+		const Common::Point &c = edge->v;
+		const Common::Point &d = CLIST_NEXT(edge)->v;
+
+		if (cull && ((c.x < minX && d.x < minX) || (c.x > maxX && d.x > maxX) || (c.y < minY && d.y < minY) || (c.y > maxY && d.y > maxY)))
+			continue;
+
+		if (between(a, b, c)) {
+			// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+			if ((inside(a, edge)) || (inside(b, edge)))
+				return true;
+
+			// This edge won't properly intersect, so we continue
+			continue;
+		}
+
+		if (intersect_proper(a, b, c, d))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Determines whether two vertices are visible from each other, testing all
+ * polygons
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Vertex *) a, b: The vertices
+ * Returns   : (bool) true if a and b are visible from each other
+ */
+static bool is_visible(PathfindingState *s, Vertex *a, Vertex *b) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if (hidden_locally(a, b))
+		return false;
+
+	// Check for intersecting edges
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		if (VERTEX_HAS_EDGES((*it)->vertices.first()) && polygon_blocks(*it, a->v, b->v))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Determines whether two cached vertices are visible from each other, only
+ * testing the polygons which have not been tested for them in earlier calls
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Vertex *) a, b: The vertices, both in the cache
+ * Returns   : (bool) true if a and b are visible from each other
+ */
+static bool is_visible_cached(PathfindingState *s, Vertex *a, Vertex *b) {
+	AvoidPathCache *cache = s->_cache;
+	const int row = MIN(a->_cacheId, b->_cacheId);
+	const int column = MAX(a->_cacheId, b->_cacheId);
+
+	Common::Array<AvoidPathCache::Pair> &rowPairs = cache->pairs[row];
+	if (rowPairs.empty())
+		rowPairs.resize(cache->vertices - row - 1);
+	AvoidPathCache::Pair &pair = rowPairs[column - row - 1];
+
+	// Visibility does not depend on the direction of the line, so a single
+	// pair serves both vertices
+	const bool known = (pair.local != AvoidPathCache::kLocalUnknown);
+	if (!known)
+		pair.local = hidden_locally(a, b) ? AvoidPathCache::kLocalHidden : AvoidPathCache::kLocalVisible;
+
+	if (pair.local == AvoidPathCache::kLocalHidden || (pair.blockingPolygons & s->_cacheMask)) {
+		if (known)
+			cache->hits++;
+		else
+			cache->misses++;
+		return false;
+	}
+
+	if (!(s->_cacheMask & ~pair.testedPolygons)) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+
+		for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+			const Polygon *polygon = *it;
+
+			if (!polygon->_cacheMask || (pair.testedPolygons & polygon->_cacheMask))
+				continue;
+
+			pair.testedPolygons |= polygon->_cacheMask;
+			if (polygon_blocks(polygon, a->v, b->v)) {
+				pair.blockingPolygons |= polygon->_cacheMask;
+				return false;
+			}
+		}
+	}
+
+	if (s->_uncachedPolygons) {
+		for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+			const Polygon *polygon = *it;
+
+			if (!polygon->_cacheMask && VERTEX_HAS_EDGES(polygon->vertices.first()) && polygon_blocks(polygon, a->v, b->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -671,30 +845,16 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		if (vertex == vertex_cur)
 			continue;
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
+		bool visible;
+		if (s->_cache && vertex_cur->_cacheId >= 0 && vertex->_cacheId >= 0)
+			visible = is_visible_cached(s, vertex_cur, vertex);
+		else
+			visible = is_visible(s, vertex_cur, vertex);
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1186,40 +1346,165 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
- * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
- *             (Common::Point) start: The start point
- *             (Common::Point) end: The end point
- *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ * Looks up a polygon in the visibility graph cache, adding it if it is new
+ * Parameters: (AvoidPathCache *) cache: The cache
+ *             (Polygon *) polygon: The polygon
+ * Returns   : (int) The index of the polygon in the cache, or -1 if the cache is full
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
-	Polygon *polygon;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
+static int find_cached_polygon(AvoidPathCache *cache, Polygon *polygon) {
+	const uint size = polygon->vertices.size();
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
+	for (uint i = 0; i < cache->polygons.size(); i++) {
+		const Common::Array<Common::Point> &points = cache->polygons[i].points;
 
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+		if (points.size() != size)
+			continue;
 
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
+		uint j = 0;
+		Vertex *vertex;
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			if (vertex->v != points[j])
+				break;
+			j++;
+		}
+
+		if (j == size)
+			return i;
+	}
+
+	if (cache->polygons.size() == AvoidPathCache::kMaxPolygons || cache->vertices + size > AvoidPathCache::kMaxVertices)
+		return -1;
+
+	AvoidPathCache::CachedPolygon cachedPolygon;
+	Vertex *vertex;
+	CLIST_FOREACH(vertex, &polygon->vertices) {
+		cachedPolygon.points.push_back(vertex->v);
+	}
+	cachedPolygon.firstVertex = cache->vertices;
+	cache->polygons.push_back(cachedPolygon);
+
+	cache->vertices += size;
+	cache->pairs.resize(cache->vertices);
+
+	// Rows in use are sized for the vertices they have seen so far
+	for (uint i = 0; i < cachedPolygon.firstVertex; i++) {
+		if (!cache->pairs[i].empty())
+			cache->pairs[i].resize(cache->vertices - i - 1);
+	}
+
+	return cache->polygons.size() - 1;
+}
+
+/**
+ * Removes the cache assignments of a polygon and its vertices
+ * Parameters: (Polygon *) polygon: The polygon
+ */
+static void uncache_polygon(Polygon *polygon) {
+	Vertex *vertex;
+
+	polygon->_cacheMask = 0;
+	CLIST_FOREACH(vertex, &polygon->vertices) {
+		vertex->_cacheId = -1;
+	}
+}
+
+/**
+ * Assigns the polygons and vertices of the pathfinding state to their
+ * entries in the visibility graph cache. Must be called before the start
+ * and end points are merged into the polygons, as vertices inserted for them
+ * are not cached. If the polygons do not fit into the cache, it is emptied;
+ * if they don't fit into an empty cache, the cache is not used.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (AvoidPathCache *) cache: The cache
+ */
+static void cache_polygons(PathfindingState *s, AvoidPathCache *cache) {
+	for (int attempt = 0; attempt < 2; attempt++) {
+		s->_cacheMask = 0;
+
+		PolygonList::iterator it;
+		for (it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+			Polygon *polygon = *it;
+
+			if (!VERTEX_HAS_EDGES(polygon->vertices.first()))
+				continue;
+
+			const int index = find_cached_polygon(cache, polygon);
+			if (index < 0)
+				break;
+
+			polygon->_cacheMask = 1u << index;
+			s->_cacheMask |= polygon->_cacheMask;
+
+			int cacheId = cache->polygons[index].firstVertex;
+			Vertex *vertex;
+			CLIST_FOREACH(vertex, &polygon->vertices) {
+				vertex->_cacheId = cacheId++;
 			}
+		}
 
-			node = s->_segMan->lookupNode(node->succ);
+		if (it == s->polygons.end()) {
+			s->_cache = cache;
+			return;
+		}
+
+		debugC(kDebugLevelAvoidPath, "AvoidPath: Visibility graph cache full, emptying it");
+		cache->clear();
+	}
+
+	// Too many polygons for the cache, don't use it at all
+	s->_cacheMask = 0;
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it)
+		uncache_polygon(*it);
+}
+
+/**
+ * Takes the polygons which had an edge split up by the start or end point
+ * out of the visibility graph cache for this call, as they no longer match
+ * the cached polygons.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void uncache_split_polygons(PathfindingState *s) {
+	if (!s->_cache)
+		return;
+
+	s->_cacheMask = 0;
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
+
+		if (!polygon->_cacheMask)
+			continue;
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			if (vertex->_cacheId < 0)
+				break;
+		}
+
+		if (vertex) {
+			uncache_polygon(polygon);
+			s->_uncachedPolygons = true;
+		} else {
+			s->_cacheMask |= polygon->_cacheMask;
 		}
 	}
+}
 
+/**
+ * Prepares the polygons of a pathfinding state for pathfinding: moves the
+ * start and end points out of barred areas, merges them into the polygons,
+ * assigns the polygons to the visibility graph cache and builds the vertex
+ * index
+ * Parameters: (PathfindingState *) pf_s: The pathfinding state holding the polygons
+ *             (EngineState *) s: The game state, NULL if no game specific
+ *                                workarounds are to be applied
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ *             (AvoidPathCache *) cache: The visibility graph cache, NULL to
+ *                                       not use one
+ * Returns   : (bool) true on success, false otherwise
+ */
+static bool prepare_polygon_set(PathfindingState *pf_s, EngineState *s, Common::Point start, Common::Point end, int opt, AvoidPathCache *cache) {
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
 
@@ -1227,8 +1512,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	if (!new_start) {
 		warning("AvoidPath: Couldn't fixup start position for pathfinding");
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	Common::Point *new_end = fixup_end_point(pf_s, end);
@@ -1236,8 +1520,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	if (!new_end) {
 		warning("AvoidPath: Couldn't fixup end position for pathfinding");
 		delete new_start;
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	if (opt == 0) {
@@ -1259,8 +1542,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 				warning("AvoidPath: error finding nearest intersection");
 				delete new_start;
 				delete new_end;
-				delete pf_s;
-				return NULL;
+				return false;
 			}
 
 			if (err == PF_OK)
@@ -1269,36 +1551,87 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	} else {
 		// WORKAROUND LSL5 room 660. Priority glitch due to us choosing a different path
 		// than SSCI. Happens when Patti walks to the control room.
-		if (g_sci->getGameId() == GID_LSL5 && (s->currentRoomNumber() == 660) && (Common::Point(67, 131) == *new_start) && (Common::Point(229, 101) == *new_end)) {
+		if (s && g_sci->getGameId() == GID_LSL5 && (s->currentRoomNumber() == 660) && (Common::Point(67, 131) == *new_start) && (Common::Point(229, 101) == *new_end)) {
 			debug(1, "[avoidpath] Applying fix for priority problem in LSL5, room 660");
 			pf_s->_prependPoint = new_start;
 			new_start = new Common::Point(77, 107);
 		}
 	}
 
+	if (cache)
+		cache_polygons(pf_s, cache);
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
 
+	uncache_split_polygons(pf_s);
+
 	delete new_start;
 	delete new_end;
 
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	int count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
 	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
-		polygon = *it;
+		Polygon *polygon = *it;
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
 			pf_s->vertex_index[count++] = vertex;
 		}
+
+		polygon->updateBounds();
 	}
 
 	pf_s->vertices = count;
 
+	return true;
+}
+
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	if (!prepare_polygon_set(pf_s, s, start, end, opt, s->_avoidPathCache)) {
+		delete pf_s;
+		return NULL;
+	}
+
 	return pf_s;
 }
 
@@ -1372,7 +1705,7 @@ static void AStar(PathfindingState *s) {
 			// add this workaround for that scene in QFG1VGA, until our algorithm matches
 			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
 			// in that scene.
-			bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
+			bool qfg1VgaWorkaround = (g_sci && g_sci->getGameId() == GID_QFG1VGA &&
 									  g_sci->getEngineState()->currentRoomNumber() == 81);
 
 			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
@@ -1408,81 +1741,107 @@ static reg_t allocateOutputArray(SegManager *segMan, int size) {
 }
 
 /**
- * Stores the final path in newly allocated dynmem
+ * Collects the points of the final path
  * Parameters: (PathfindingState *) p: The pathfinding state
- *             (EngineState *) s: The game state
- * Returns   : (reg_t) Pointer to dynmem containing path
+ *             (Common::Array<Common::Point> &) path: Receives the points
  */
-static reg_t output_path(PathfindingState *p, EngineState *s) {
-	int path_len = 0;
-	reg_t output;
+static void collect_path(PathfindingState *p, Common::Array<Common::Point> &path) {
 	Vertex *vertex = p->vertex_end;
-	int unreachable = vertex->path_prev == NULL;
-
-	if (!unreachable) {
-		while (vertex) {
-			// Compute path length
-			path_len++;
-			vertex = vertex->path_prev;
-		}
-	}
 
-	// Allocate memory for path, plus 3 extra for appended point, prepended point and sentinel
-	output = allocateOutputArray(s->_segMan, path_len + 3);
-	SegmentRef arrayRef = s->_segMan->dereference(output);
-	assert(arrayRef.isValid() && !arrayRef.skipByte);
-
-	if (unreachable) {
+	if (!vertex->path_prev) {
 		// If pathfinding failed we only return the path up to vertex_start
 
 		if (p->_prependPoint)
-			writePoint(arrayRef, 0, *p->_prependPoint);
+			path.push_back(*p->_prependPoint);
 		else
-			writePoint(arrayRef, 0, p->vertex_start->v);
-
-		writePoint(arrayRef, 1, p->vertex_start->v);
-		writePoint(arrayRef, 2, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
+			path.push_back(p->vertex_start->v);
 
-		return output;
+		path.push_back(p->vertex_start->v);
+		return;
 	}
 
-	int offset = 0;
-
 	if (p->_prependPoint)
-		writePoint(arrayRef, offset++, *p->_prependPoint);
+		path.push_back(*p->_prependPoint);
+
+	int path_len = 0;
+	for (; vertex; vertex = vertex->path_prev)
+		path_len++;
+
+	const uint offset = path.size();
+	path.resize(offset + path_len);
 
 	vertex = p->vertex_end;
 	for (int i = path_len - 1; i >= 0; i--) {
-		writePoint(arrayRef, offset + i, vertex->v);
+		path[offset + i] = vertex->v;
 		vertex = vertex->path_prev;
 	}
-	offset += path_len;
 
 	if (p->_appendPoint)
-		writePoint(arrayRef, offset++, *p->_appendPoint);
+		path.push_back(*p->_appendPoint);
+}
+
+/**
+ * Stores the final path in newly allocated dynmem
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (EngineState *) s: The game state
+ * Returns   : (reg_t) Pointer to dynmem containing path
+ */
+static reg_t output_path(PathfindingState *p, EngineState *s) {
+	Common::Array<Common::Point> path;
+	collect_path(p, path);
+
+	// Allocate memory for path, plus the sentinel
+	reg_t output = allocateOutputArray(s->_segMan, path.size() + 1);
+	SegmentRef arrayRef = s->_segMan->dereference(output);
+	assert(arrayRef.isValid() && !arrayRef.skipByte);
+
+	for (uint i = 0; i < path.size(); i++)
+		writePoint(arrayRef, i, path[i]);
 
 	// Sentinel
-	writePoint(arrayRef, offset, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
+	writePoint(arrayRef, path.size(), Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
 
 	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath)) {
 		debug("\nReturning path:");
 
-		SegmentRef outputList = s->_segMan->dereference(output);
-		if (!outputList.isValid() || outputList.skipByte) {
-			warning("output_path: Polygon data pointer is invalid, skipping polygon");
-			return output;
-		}
-
-		for (int i = 0; i < offset; i++) {
-			Common::Point pt = readPoint(outputList, i);
-			debugN(-1, " (%i, %i)", pt.x, pt.y);
-		}
+		for (uint i = 0; i < path.size(); i++)
+			debugN(-1, " (%i, %i)", path[i].x, path[i].y);
 		debug(";\n");
 	}
 
 	return output;
 }
 
+Common::Array<Common::Point> findAvoidPath(const Common::Array<AvoidPathPolygon> &polygons, Common::Point start, Common::Point end, int width, int height, int opt, AvoidPathCache *cache) {
+	PathfindingState *p = new PathfindingState(width, height);
+
+	// Build the polygons like convert_polygon does
+	for (uint i = 0; i < polygons.size(); i++) {
+		const Common::Array<Common::Point> &points = polygons[i].points;
+
+		if (points.empty())
+			continue;
+
+		Polygon *polygon = new Polygon(polygons[i].type);
+
+		for (uint j = 0; j < points.size(); j++)
+			polygon->vertices.insertHead(new Vertex(points[j]));
+
+		fix_vertex_order(polygon);
+		p->polygons.push_back(polygon);
+	}
+
+	Common::Array<Common::Point> path;
+
+	if (prepare_polygon_set(p, NULL, start, end, opt, cache)) {
+		AStar(p);
+		collect_path(p, path);
+	}
+
+	delete p;
+	return path;
+}
+
 reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	Common::Point start = Common::Point(argv[0].toSint16(), argv[1].toSint16());
 
@@ -1564,6 +1923,9 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 		// Apply Dijkstra
 		AStar(p);
 
+		debugC(kDebugLevelAvoidPath, "AvoidPath: Visibility graph cache: %u hits, %u misses so far",
+			s->_avoidPathCache->hits, s->_avoidPathCache->misses);
+
 		output = output_path(p, s);
 		delete p;
 
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+/**
+ * Visibility graph of the polygons passed to kAvoidPath, kept across calls.
+ *
+ * Games call kAvoidPath over and over with the same obstacles, but the set of
+ * polygons taking part in each call varies, as polygons containing the start
+ * point are dropped. The cache therefore holds a pool of polygons, identified
+ * by their points, and numbers all their vertices. For each pair of vertices
+ * it remembers whether the vertices hide each other locally, and which of the
+ * pooled polygons have been tested for, and found, blocking the line between
+ * them. A pair is visible in a call if it is not hidden locally and none of the
+ * polygons in that call blocks it; polygons not tested before are tested when
+ * needed, so a change of polygons only costs the tests against the new ones.
+ */
+struct AvoidPathCache {
+	enum {
+		kMaxPolygons = 32,  ///< Limited by the width of the polygon masks
+		kMaxVertices = 256  ///< Limits the pairs to kMaxVertices^2 / 2, about 384KB
+	};
+
+	enum {
+		kLocalUnknown = 0,
+		kLocalVisible = 1,
+		kLocalHidden = 2
+	};
+
+	struct Pair {
+		uint32 testedPolygons;   ///< Polygons tested for blocking the pair
+		uint32 blockingPolygons; ///< Tested polygons found blocking the pair
+		byte local;              ///< kLocalUnknown, kLocalVisible or kLocalHidden
+
+		Pair() : testedPolygons(0), blockingPolygons(0), local(kLocalUnknown) {}
+	};
+
+	struct CachedPolygon {
+		Common::Array<Common::Point> points;
+		uint firstVertex; ///< Number of the first vertex of the polygon
+	};
+
+	Common::Array<CachedPolygon> polygons;
+
+	/**
+	 * Pairs of vertices, one row for each vertex. A pair is stored in the
+	 * row of its lower vertex number, which only holds the pairs with the
+	 * higher numbers. Rows are sized on first use.
+	 */
+	Common::Array<Common::Array<Pair> > pairs;
+	uint vertices; ///< Number of vertices in all pooled polygons
+
+	uint32 hits;   ///< Pairs answered without any geometric test
+	uint32 misses; ///< Pairs which needed geometric tests
+
+	AvoidPathCache() : vertices(0), hits(0), misses(0) {}
+
+	void clear() {
+		polygons.clear();
+		pairs.clear();
+		vertices = 0;
+	}
+};
+
+/**
+ * A polygon passed to findAvoidPath(), in the form the scripts pass them to
+ * kAvoidPath.
+ */
+struct AvoidPathPolygon {
+	int type; ///< SCI polygon type, e.g. 2 for barred access
+	Common::Array<Common::Point> points;
+
+	AvoidPathPolygon(int type_) : type(type_) {}
+};
+
+/**
+ * Computes the path which kAvoidPath returns for the given polygons, without
+ * the workarounds for single games. This lets tests and benchmarks run the
+ * pathfinder without a game.
+ *
+ * @param cache  the visibility graph cache to use, or NULL to not use one
+ * @return the points of the path, without the sentinel; empty if the start
+ *         or end point could not be fixed up, where kAvoidPath returns the
+ *         direct path
+ */
+Common::Array<Common::Point> findAvoidPath(const Common::Array<AvoidPathPolygon> &polygons, Common::Point start, Common::Point end, int width, int height, int opt, AvoidPathCache *cache);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -28,6 +28,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"
+#include "sci/engine/vm.h"
 
 #include "common/util.h"
 
@@ -73,6 +74,48 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	dropDecodedInstructions();
+}
+
+void Script::dropDecodedInstructions() {
+	_instructions.clear();
+	_instructionIndex.clear();
+}
+
+static void readInstruction(const byte *buf, uint32 offset, PMachineInstruction &instruction) {
+	instruction.size = readPMachineInstruction(buf, instruction.extOpcode, instruction.opparams);
+
+	// Resolve relative branches, the same way the program counter is advanced
+	switch (instruction.extOpcode >> 1) {
+	case op_bt:
+	case op_bnt:
+	case op_jmp:
+	case op_call:
+		instruction.target = offset + instruction.size + instruction.opparams[0];
+		break;
+	default:
+		instruction.target = 0;
+		break;
+	}
+}
+
+const PMachineInstruction &Script::decodeInstruction(uint32 offset) {
+	// The index numbers instructions with 16 bits. Further instructions, and
+	// all of them while the decoding is being benchmarked, are decoded on
+	// each execution.
+	if (!g_debug_keep_decoded_instructions || _instructions.size() == 0xFFFF) {
+		readInstruction(getBuf(offset), offset, _uncachedInstruction);
+		return _uncachedInstruction;
+	}
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(getBufSize());
+
+	_instructions.push_back(PMachineInstruction());
+	readInstruction(getBuf(offset), offset, _instructions.back());
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
 }
 
 enum {
@@ -69,6 +69,16 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A p-machine instruction, as decoded by readPMachineInstruction().
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint32 target; /**< Offset jumped to by op_bt, op_bnt, op_jmp and op_call */
+	uint16 size; /**< Length of the instruction in bytes */
+	byte extOpcode; /**< Opcode, with the lowest bit set for byte sized operands */
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -94,6 +104,21 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/** The instructions decoded so far */
+	Common::Array<PMachineInstruction> _instructions;
+
+	/**
+	 * The number of the instruction at each offset into the script buffer,
+	 * plus one, or 0 if no instruction was decoded there. Allocated when the
+	 * first instruction is decoded.
+	 */
+	Common::Array<uint16> _instructionIndex;
+
+	/** The last instruction which was decoded without keeping it */
+	PMachineInstruction _uncachedInstruction;
+
+	const PMachineInstruction &decodeInstruction(uint32 offset);
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -118,6 +143,33 @@ public:
 	}
 
 	const byte *getBuf(uint offset = 0) const { return _buf->getUnsafeDataAt(offset); }
+
+	/**
+	 * Gets the instruction at the given offset into the script buffer. Each
+	 * instruction is only decoded the first time it is executed, as code
+	 * and data are mixed in the buffer. The result is valid until the next
+	 * call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset) {
+		if (offset < _instructionIndex.size()) {
+			const uint16 number = _instructionIndex[offset];
+			if (number)
+				return _instructions[number - 1];
+		}
+
+		return decodeInstruction(offset);
+	}
+
+	/** Forgets all decoded instructions, so that they are decoded again */
+	void dropDecodedInstructions();
+
+	/** @return the number of instructions decoded by getInstruction() */
+	uint getDecodedInstructionCount() const { return _instructions.size(); }
+
+	/** @return the memory used for the decoded instructions, in bytes */
+	uint getDecodedInstructionSize() const {
+		return _instructions.size() * sizeof(PMachineInstruction) + _instructionIndex.size() * sizeof(uint16);
+	}
 	SciSpan<const byte> getSpan(uint offset) const { return _buf->subspan(offset); }
 
 	int getScriptNumber() const { return _nr; }
@@ -139,6 +191,7 @@ public:
 	virtual SegmentRef dereference(reg_t pointer);
 	virtual reg_t findCanonicAddress(SegManager *segMan, reg_t sub_addr) const;
 	virtual void freeAtAddress(SegManager *segMan, reg_t sub_addr);
+	virtual uint getFreeableSize(reg_t sub_addr) const { return _markedAsDeleted ? getBufSize() : 0; }
 	virtual Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const;
 	virtual Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const;
 
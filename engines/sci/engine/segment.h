@@ -123,6 +123,14 @@ public:
 	 */
 	virtual void freeAtAddress(SegManager *segMan, reg_t sub_addr) {}
 
+	/**
+	 * Reports the number of bytes freeAtAddress() would release.
+	 * Used by the garbage collector for its statistics.
+	 * @param sub_addr		address (within the given segment) to check
+	 * @return the size in bytes, or 0 if nothing would be released
+	 */
+	virtual uint getFreeableSize(reg_t sub_addr) const { return 0; }
+
 	/**
 	 * Iterates over and reports all addresses within the segment.
 	 * Used by the garbage collector.
@@ -306,6 +314,10 @@ public:
 		return tmp;
 	}
 
+	virtual uint getFreeableSize(reg_t sub_addr) const {
+		return isValidEntry(sub_addr.getOffset()) ? sizeof(T) : 0;
+	}
+
 	uint size() const { return _table.size(); }
 
 	T &at(uint index) { return *_table[index].data; }
@@ -321,6 +333,11 @@ struct CloneTable : public SegmentObjTable<Clone> {
 	CloneTable() : SegmentObjTable<Clone>(SEG_TYPE_CLONES) {}
 
 	virtual void freeAtAddress(SegManager *segMan, reg_t sub_addr);
+	virtual uint getFreeableSize(reg_t sub_addr) const {
+		if (!isValidEntry(sub_addr.getOffset()))
+			return 0;
+		return sizeof(Clone) + at(sub_addr.getOffset()).getVarCount() * sizeof(reg_t);
+	}
 	virtual Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const;
 
 	virtual void saveLoadWithSerializer(Common::Serializer &ser);
@@ -376,6 +393,11 @@ struct HunkTable : public SegmentObjTable<Hunk> {
 	virtual void freeAtAddress(SegManager *segMan, reg_t sub_addr) {
 		freeEntry(sub_addr.getOffset());
 	}
+	virtual uint getFreeableSize(reg_t sub_addr) const {
+		if (!isValidEntry(sub_addr.getOffset()))
+			return 0;
+		return sizeof(Hunk) + at(sub_addr.getOffset()).size;
+	}
 
 	virtual void saveLoadWithSerializer(Common::Serializer &ser);
 };
@@ -405,6 +427,7 @@ public:
 		const reg_t r = make_reg(segId, 0);
 		return Common::Array<reg_t>(&r, 1);
 	}
+	virtual uint getFreeableSize(reg_t sub_addr) const { return _size; }
 
 	virtual void saveLoadWithSerializer(Common::Serializer &ser);
 };
@@ -905,6 +928,11 @@ protected:
 struct ArrayTable : public SegmentObjTable<SciArray> {
 	ArrayTable() : SegmentObjTable<SciArray>(SEG_TYPE_ARRAY) {}
 
+	virtual uint getFreeableSize(reg_t sub_addr) const {
+		if (!isValidEntry(sub_addr.getOffset()))
+			return 0;
+		return sizeof(SciArray) + at(sub_addr.getOffset()).byteSize();
+	}
 	virtual Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const;
 
 	void saveLoadWithSerializer(Common::Serializer &ser);
@@ -1191,6 +1219,12 @@ public:
 struct BitmapTable : public SegmentObjTable<SciBitmap> {
 	BitmapTable() : SegmentObjTable<SciBitmap>(SEG_TYPE_BITMAP) {}
 
+	virtual uint getFreeableSize(reg_t sub_addr) const {
+		if (!isValidEntry(sub_addr.getOffset()))
+			return 0;
+		return sizeof(SciBitmap) + at(sub_addr.getOffset()).getRawSize();
+	}
+
 	SegmentRef dereference(reg_t pointer) {
 		SegmentRef ret;
 		ret.isRaw = true;
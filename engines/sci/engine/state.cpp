@@ -24,8 +24,10 @@
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -68,13 +70,15 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan),
-	_dirseeker() {
+	_dirseeker(),
+	_avoidPathCache(new AvoidPathCache()) {
 
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _avoidPathCache;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -121,13 +125,17 @@ void EngineState::reset(bool isRestoring) {
 	_videoState.reset();
 }
 
-void EngineState::speedThrottler(uint32 neededSleep) {
+void EngineState::speedThrottler(uint32 neededSleep, bool collectGarbage) {
 	if (_throttleTrigger) {
 		uint32 curTime = g_system->getMillis();
 		uint32 duration = curTime - _throttleLastTime;
 
 		if (duration < neededSleep) {
-			g_sci->sleep(neededSleep - duration);
+			// Collect garbage while waiting anyway, if a collection is due
+			if (collectGarbage)
+				duration += run_gc_idle(this, neededSleep - duration);
+			if (duration < neededSleep)
+				g_sci->sleep(neededSleep - duration);
 			_throttleLastTime = g_system->getMillis();
 		} else {
 			_throttleLastTime = curTime;
@@ -43,6 +43,7 @@ class WriteStream;
 
 namespace Sci {
 
+struct AvoidPathCache;
 class FileHandle;
 class DirSeeker;
 class EventManager;
@@ -95,6 +96,30 @@ struct VideoState {
 	}
 };
 
+/**
+ * Statistics of the garbage collector, see the gc_stats console command.
+ */
+struct GCStatistics {
+	uint32 runs; //< Number of collections
+	uint32 idleRuns; //< Number of collections run while the game was waiting for the next frame
+	uint32 lastPause; //< Duration of the last collection, in ms
+	uint32 maxPause; //< Duration of the longest collection, in ms
+	uint32 totalPause; //< Duration of all collections, in ms
+	uint32 lastFreed; //< Number of objects released by the last collection
+	uint32 lastFreedBytes; //< Number of bytes released by the last collection
+	uint32 totalFreed; //< Number of objects released by all collections
+	uint64 totalFreedBytes; //< Number of bytes released by all collections
+
+	GCStatistics() { reset(); }
+
+	void reset() {
+		runs = idleRuns = 0;
+		lastPause = maxPause = totalPause = 0;
+		lastFreed = lastFreedBytes = totalFreed = 0;
+		totalFreedBytes = 0;
+	}
+};
+
 /**
  * Trace information about a VM function call.
  */
@@ -125,7 +150,13 @@ public:
 	uint32 lastWaitTime; /**< The last time the game invoked Wait() */
 	uint32 _screenUpdateTime;	/**< The last time the game updated the screen */
 
-	void speedThrottler(uint32 neededSleep);
+	/**
+	 * Sleeps for what remains of the given time since the last throttled call.
+	 * @param collectGarbage whether a due garbage collection may run in that
+	 * time. Only pass true where the calling kernel function holds no heap
+	 * references besides its arguments, see run_gc_idle().
+	 */
+	void speedThrottler(uint32 neededSleep, bool collectGarbage = false);
 	void wait(int16 ticks);
 
 #ifdef ENABLE_SCI32
@@ -201,6 +232,9 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCStatistics _gcStats;
+
+	AvoidPathCache *_avoidPathCache; /**< Visibility graph kept across kAvoidPath calls */
 
 	MessageState *_msgState;
 
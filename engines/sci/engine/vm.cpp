@@ -66,15 +66,20 @@ static reg_t &validate_property(EngineState *s, Object *obj, int index) {
 	else
 		index >>= 1;
 
-	if (index < 0 || (uint)index >= obj->getVarCount()) {
-		// This is same way sierra does it and there are some games, that contain such scripts like
-		//  iceman script 998 (fred::canBeHere, executed right at the start)
+	if ((uint)index < obj->getVarCount())
+		return obj->getVariableRef(index);
+
+	// This is same way sierra does it and there are some games, that contain such scripts like
+	//  iceman script 998 (fred::canBeHere, executed right at the start)
+	if (g_debug_validate_vm) {
+		warning("[VM] Invalid property #%d (out of [0..%d]) requested from object %04x:%04x (%s) in %s",
+			index, obj->getVarCount(), PRINT_REG(obj->getPos()), s->_segMan->getObjectName(obj->getPos()),
+			s->getCurrentCallOrigin().toString().c_str());
+	} else {
 		debugC(kDebugLevelVM, "[VM] Invalid property #%d (out of [0..%d]) requested from object %04x:%04x (%s)",
 			index, obj->getVarCount(), PRINT_REG(obj->getPos()), s->_segMan->getObjectName(obj->getPos()));
-		return dummyReg;
 	}
-
-	return obj->getVariableRef(index);
+	return dummyReg;
 }
 
 static StackPtr validate_stack_addr(EngineState *s, StackPtr sp) {
@@ -85,38 +90,51 @@ static StackPtr validate_stack_addr(EngineState *s, StackPtr sp) {
 		(int)(sp - s->stack_base), 0, (int)(s->stack_top - s->stack_base - 1));
 }
 
-static bool validate_variable(reg_t *r, reg_t *stack_base, int type, int max, int index) {
+static bool validate_invalid_variable(EngineState *s, reg_t *r, reg_t *stack_base, int type, int max, int index) {
 	const char *names[4] = {"global", "local", "temp", "param"};
 
-	if (index < 0 || index >= max) {
-		Common::String txt = Common::String::format(
-							"[VM] Attempt to use invalid %s variable %04x ",
-							names[type], index);
-		if (max == 0)
-			txt += "(variable type invalid)";
-		else
-			txt += Common::String::format("(out of range [%d..%d])", 0, max - 1);
-
-		if (type == VAR_PARAM || type == VAR_TEMP) {
-			int total_offset = r - stack_base;
-			if (total_offset < 0 || total_offset >= VM_STACK_SIZE) {
-				// Fatal, as the game is trying to do an OOB access
-				error("%s. [VM] Access would be outside even of the stack (%d); access denied", txt.c_str(), total_offset);
-				return false;
-			} else {
-				debugC(kDebugLevelVM, "%s", txt.c_str());
-				debugC(kDebugLevelVM, "[VM] Access within stack boundaries; access granted.");
-				return true;
-			}
+	Common::String txt = Common::String::format(
+						"[VM] Attempt to use invalid %s variable %04x ",
+						names[type], index);
+	if (max == 0)
+		txt += "(variable type invalid)";
+	else
+		txt += Common::String::format("(out of range [%d..%d])", 0, max - 1);
+
+	if (g_debug_validate_vm)
+		txt += Common::String::format(" in %s", s->getCurrentCallOrigin().toString().c_str());
+
+	bool granted = false;
+	if (type == VAR_PARAM || type == VAR_TEMP) {
+		int total_offset = r - stack_base;
+		if (total_offset < 0 || total_offset >= VM_STACK_SIZE) {
+			// Fatal, as the game is trying to do an OOB access
+			error("%s. [VM] Access would be outside even of the stack (%d); access denied", txt.c_str(), total_offset);
 		}
-		return false;
+		granted = true;
 	}
 
-	return true;
+	if (g_debug_validate_vm) {
+		warning("%s", txt.c_str());
+	} else {
+		debugC(kDebugLevelVM, "%s", txt.c_str());
+		if (granted)
+			debugC(kDebugLevelVM, "[VM] Access within stack boundaries; access granted.");
+	}
+	return granted;
+}
+
+static inline bool validate_variable(EngineState *s, int type, int index) {
+	// Out of range accesses only happen with script bugs, so the range check
+	// is all that is needed on the way to the variable
+	if ((uint)index < (uint)s->variablesMax[type])
+		return true;
+
+	return validate_invalid_variable(s, s->variables[type], s->stack_base, type, s->variablesMax[type], index);
 }
 
 static reg_t read_var(EngineState *s, int type, int index) {
-	if (validate_variable(s->variables[type], s->stack_base, type, s->variablesMax[type], index)) {
+	if (validate_variable(s, type, index)) {
 		if (s->variables[type][index].getSegment() == kUninitializedSegment) {
 			switch (type) {
 			case VAR_TEMP: {
@@ -156,7 +174,7 @@ static reg_t read_var(EngineState *s, int type, int index) {
 }
 
 static void write_var(EngineState *s, int type, int index, reg_t value) {
-	if (validate_variable(s->variables[type], s->stack_base, type, s->variablesMax[type], index)) {
+	if (validate_variable(s, type, index)) {
 
 		// WORKAROUND: This code is needed to work around a probable script bug, or a
 		// limitation of the original SCI engine, which can be observed in LSL5.
@@ -651,9 +669,13 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// Get opcode. The instruction is copied, as kernel calls may run
+		// scripts which decode more instructions.
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
+		const uint32 target = instruction.target;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		s->xs->addr.pc.incOffset(instruction.size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -789,7 +811,7 @@ void run_vm(EngineState *s) {
 		case op_bt: // 0x17 (23)
 			// Branch relative if true
 			if (s->r_acc.getOffset() || s->r_acc.getSegment())
-				s->xs->addr.pc.incOffset(opparams[0]);
+				s->xs->addr.pc.setOffset(target);
 
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_bt: request to jump past the end of script %d (offset %d, script is %d bytes)",
@@ -799,7 +821,7 @@ void run_vm(EngineState *s) {
 		case op_bnt: // 0x18 (24)
 			// Branch relative if not true
 			if (!(s->r_acc.getOffset() || s->r_acc.getSegment()))
-				s->xs->addr.pc.incOffset(opparams[0]);
+				s->xs->addr.pc.setOffset(target);
 
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_bnt: request to jump past the end of script %d (offset %d, script is %d bytes)",
@@ -807,7 +829,7 @@ void run_vm(EngineState *s) {
 			break;
 
 		case op_jmp: // 0x19 (25)
-			s->xs->addr.pc.incOffset(opparams[0]);
+			s->xs->addr.pc.setOffset(target);
 
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_jmp: request to jump past the end of script %d (offset %d, script is %d bytes)",
@@ -855,7 +877,7 @@ void run_vm(EngineState *s) {
 			           + 1 + s->r_rest;
 			StackPtr call_base = s->xs->sp - argc;
 
-			uint32 localCallOffset = s->xs->addr.pc.getOffset() + opparams[0];
+			uint32 localCallOffset = target;
 
 			int final_argc = (call_base->requireUint16()) + s->r_rest;
 			call_base[0] = make_reg(0, final_argc); // The first argument is argc
@@ -876,11 +898,11 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
+			// Run the garbage collector, if it is overdue. Collections are
+			// first given another interval to happen while the game waits
+			// for the next frame, see run_gc_idle().
+			if (s->gcCountDown-- <= -s->scriptGCInterval)
 				run_gc(s);
-			}
 
 			// Call kernel function
 			s->xs->sp -= (opparams[1] >> 1) + 1;
@@ -1136,10 +1136,11 @@ void GfxFrameout::kernelFrameOut(const bool shouldShowBits) {
 		frameOut(shouldShowBits);
 	}
 
-	throttle();
+	// The frame is done, nothing but the arguments is referenced from here
+	throttle(true);
 }
 
-void GfxFrameout::throttle() {
+void GfxFrameout::throttle(const bool collectGarbage) {
 	uint8 throttleTime;
 	if (_throttleState == 2) {
 		throttleTime = 16;
@@ -1149,7 +1150,7 @@ void GfxFrameout::throttle() {
 		++_throttleState;
 	}
 
-	g_sci->getEngineState()->speedThrottler(throttleTime);
+	g_sci->getEngineState()->speedThrottler(throttleTime, collectGarbage);
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
 
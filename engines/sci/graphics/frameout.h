@@ -325,8 +325,11 @@ public:
 	/**
 	 * Throttles the engine as necessary to maintain
 	 * 60fps output.
+	 *
+	 * @param collectGarbage whether a due garbage collection may run while
+	 * throttling, see EngineState::speedThrottler().
 	 */
-	void throttle();
+	void throttle(const bool collectGarbage = false);
 
 	/**
 	 * Updates the internal screen buffer for the next
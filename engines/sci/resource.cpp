@@ -216,6 +216,13 @@ void Resource::unalloc() {
 	_status = kResStatusNoMalloc;
 }
 
+void ResourceLRU::evict(Resource *res) {
+#ifdef SCI_VERBOSE_RESMAN
+	debug("resMan-debug: LRU: Freeing %s (%d bytes)", res->name().c_str(), res->size());
+#endif
+	res->unalloc();
+}
+
 void Resource::writeToStream(Common::WriteStream *stream) const {
 	stream->writeByte(getType() | 0x80); // 0x80 is required by old Sierra SCI, otherwise it wont accept the patch file
 	stream->writeByte(_headerSize);
@@ -954,10 +961,7 @@ ResourceManager::ResourceManager(const bool detectionMode) :
 	_detectionMode(detectionMode) {}
 
 void ResourceManager::init() {
-	_maxMemoryLRU = 256 * 1024; // 256KiB
-	_memoryLocked = 0;
-	_memoryLRU = 0;
-	_LRU.clear();
+	_LRU.setBudget(Common::ResourceCacheBase::getConfiguredBudget(256 * 1024)); // 256KiB
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1009,7 +1013,7 @@ void ResourceManager::init() {
 	// cache, leading to constant decompression of picture resources
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
-		_maxMemoryLRU = 4096 * 1024; // 4MiB
+		_LRU.setBudget(Common::ResourceCacheBase::getConfiguredBudget(4096 * 1024)); // 4MiB
 	}
 
 	switch (_viewType) {
@@ -1059,7 +1063,6 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		return;
 	}
 	_LRU.remove(res);
-	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
 
@@ -1068,43 +1071,24 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
-	_memoryLRU += res->size();
+	res->_status = kResStatusEnqueued;
+	_LRU.add(res, res->size());
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
 	      res->_id.toString().c_str(), res->size,
-	      _memoryLRU);
+	      _LRU.getSize());
 #endif
-	res->_status = kResStatusEnqueued;
 }
 
 void ResourceManager::printLRU() {
-	int mem = 0;
-	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
-	}
+	for (ResourceLRU::const_iterator it = _LRU.begin(); it != _LRU.end(); ++it)
+		debug("\t%s: %u bytes%s", it->resource->_id.toString().c_str(), it->size, it->pins ? " (locked)" : "");
 
-	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
+	_LRU.printStatistics("Resource cache");
 }
 
 void ResourceManager::freeOldResources() {
-	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
-		removeFromLRU(goner);
-		goner->unalloc();
-#ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
-#endif
-	}
+	_LRU.evictOld();
 }
 
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
@@ -1128,29 +1112,25 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 
 	if (retval->_status == kResStatusNoMalloc)
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
-
-	// Unless an error occurred, the resource is now either
-	// locked or allocated, but never queued or freed.
-
-	freeOldResources();
+	else if (retval->_status == kResStatusEnqueued || retval->_status == kResStatusLocked)
+		// The resource is moved to the 'most recent' position
+		// in the LRU cache because it has been requested again
+		_LRU.touch(retval);
+
+	// Newly loaded resources are added to the LRU cache at the
+	// 'most recent' position, which frees old resources if
+	// needed. Unless an error occurred, the resource is now
+	// either locked or enqueued.
+	if (retval->_status == kResStatusAllocated)
+		addToLRU(retval);
 
 	if (lock) {
-		if (retval->_status == kResStatusAllocated) {
+		if (retval->_status == kResStatusEnqueued) {
 			retval->_status = kResStatusLocked;
 			retval->_lockers = 0;
-			_memoryLocked += retval->_size;
+			_LRU.pin(retval);
 		}
 		retval->_lockers++;
-	} else if (retval->_status != kResStatusLocked) { // Don't lock it
-		if (retval->_status == kResStatusAllocated)
-			addToLRU(retval);
 	}
 
 	if (retval->data())
@@ -1170,9 +1150,8 @@ void ResourceManager::unlockResource(Resource *res) {
 	}
 
 	if (!--res->_lockers) { // No more lockers?
-		res->_status = kResStatusAllocated;
-		_memoryLocked -= res->size();
-		addToLRU(res);
+		res->_status = kResStatusEnqueued;
+		_LRU.unpin(res);
 	}
 
 	freeOldResources();
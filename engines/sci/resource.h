@@ -26,6 +26,7 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/resourcecache.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -300,6 +301,18 @@ protected:
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/**
+ * Cache of the data of loaded resources. Locked resources are pinned, all
+ * others are enqueued; evicting a resource frees its data.
+ */
+class ResourceLRU : public Common::ResourceCache<Resource> {
+public:
+	ResourceLRU() : Common::ResourceCache<Resource>(0) {}
+
+protected:
+	virtual void evict(Resource *res);
+};
+
 class IntMapResourceSource;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
@@ -384,6 +397,7 @@ public:
 	bool isGMTrackIncluded();
 	bool isSci11Mac() const { return _volVersion == kResVersionSci11Mac; }
 	ViewType getViewType() const { return _viewType; }
+	Common::ResourceCacheBase &getLRU() { return _LRU; }
 	const char *getMapVersionDesc() const { return versionDescription(_mapVersion); }
 	const char *getVolVersionDesc() const { return versionDescription(_volVersion); }
 	ResVersion getVolVersion() const { return _volVersion; }
@@ -458,17 +472,12 @@ public:
 protected:
 	bool _detectionMode;
 
-	// Maximum number of bytes to allow being allocated for resources
-	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
-	// for resources which are not explicitly locked. However, a warning will be
-	// issued whenever this limit is exceeded.
-	int _maxMemoryLRU;
-
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
-	int _memoryLocked;	///< Amount of resource bytes in locked memory
-	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	// The budget of the LRU cache will not be interpreted as a hard limit,
+	// only as a restriction for resources which are not explicitly locked.
+	ResourceLRU _LRU; ///< Last Resource Used cache
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -51,6 +51,11 @@ public:
 		return (_pImage != 0);
 	}
 
+	virtual uint32 getSize() const {
+		// Images are kept as 32 bit surfaces
+		return _pImage ? _pImage->getWidth() * _pImage->getHeight() * 4 : 0;
+	}
+
 	/**
 	    @brief Gibt die Breite des Bitmaps zurck.
 	*/
@@ -43,8 +43,11 @@ bool ImgLoader::decodePNGImage(const byte *fileDataPtr, uint fileSize, Graphics:
 	Common::MemoryReadStream *fileStr = new Common::MemoryReadStream(fileDataPtr, fileSize, DisposeAfterUse::NO);
 
 	::Image::PNGDecoder png;
-	if (!png.loadStream(*fileStr)) // the fileStr pointer, and thus pFileData will be deleted after this is done
-		error("Error while reading PNG image");
+	// This runs on worker threads too, so the callers report the error
+	if (!png.loadStream(*fileStr)) { // the fileStr pointer, and thus pFileData will be deleted after this is done
+		delete fileStr;
+		return false;
+	}
 
 	const Graphics::Surface *sourceSurface = png.getSurface();
 	Graphics::Surface *pngSurface = sourceSurface->convertTo(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), png.getPalette());
@@ -125,7 +125,18 @@ RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 		return;
 	}
 
-	// Uncompress the image
+	// Uncompress the image. PNG images are decoded on the thread pool, so
+	// that all the frames of an animation are decoded at the same time.
+	if (isPNG && fileSize >= 24 && READ_BE_UINT32(pFileData + 12) == MKTAG('I','H','D','R')) {
+		_surface.w = READ_BE_UINT32(pFileData + 16);
+		_surface.h = READ_BE_UINT32(pFileData + 20);
+		_surface.format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		_decodeJob = Common::ThreadPool::instance().async(new DecodeJob(pFileData, fileSize));
+		_doCleanup = true;
+		result = true;
+		return;
+	}
+
 	if (isPNG)
 		result = ImgLoader::decodePNGImage(pFileData, fileSize, &_surface);
 	else
@@ -183,6 +194,38 @@ RenderedImage::~RenderedImage() {
 	}
 }
 
+RenderedImage::DecodeJob::~DecodeJob() {
+	_surface.free();
+	delete[] _fileData;
+}
+
+void RenderedImage::DecodeJob::run() {
+	_result = ImgLoader::decodePNGImage(_fileData, _fileSize, &_surface);
+}
+
+void RenderedImage::finishDecode() {
+	if (!_decodeJob.isValid())
+		return;
+
+	// Take over the pixels of the decoded image
+	DecodeJob &job = _decodeJob.get();
+	if (!job._result) {
+		// Like a synchronous load, only that it fails on first use
+		error("Could not decode image.");
+	}
+	_surface.w = job._surface.w;
+	_surface.h = job._surface.h;
+	_surface.pitch = job._surface.pitch;
+	_surface.setPixels(job._surface.getPixels());
+	job._surface.setPixels(0);
+	_decodeJob = Common::Future<DecodeJob>();
+
+#if defined(SCUMM_LITTLE_ENDIAN)
+	// Makes sense for LE only at the moment
+	checkForTransparency();
+#endif
+}
+
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::fill(const Common::Rect *pFillRect, uint color) {
@@ -193,6 +236,8 @@ bool RenderedImage::fill(const Common::Rect *pFillRect, uint color) {
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, uint stride) {
+	finishDecode();
+
 	// Check if PixelData contains enough pixel to create an image with image size equals width * height
 	if (size < static_cast<uint>(_surface.w * _surface.h * 4)) {
 		error("PixelData vector is too small to define a 32 bit %dx%d image.", _surface.w, _surface.h);
@@ -212,6 +257,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 }
 
 void RenderedImage::replaceContent(byte *pixeldata, int width, int height) {
+	finishDecode();
+
 	_surface.w = width;
 	_surface.h = height;
 	_surface.pitch = width * 4;
@@ -220,6 +267,8 @@ void RenderedImage::replaceContent(byte *pixeldata, int width, int height) {
 // -----------------------------------------------------------------------------
 
 uint RenderedImage::getPixel(int x, int y) {
+	finishDecode();
+
 	error("GetPixel() is not supported. Returning black.");
 	return 0;
 }
@@ -227,12 +276,16 @@ uint RenderedImage::getPixel(int x, int y) {
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, RectangleList *updateRects) {
+	finishDecode();
+
 	_surface.blit(*_backSurface, posX, posY, (((flipping & 1) ? Graphics::FLIP_V : 0) | ((flipping & 2) ? Graphics::FLIP_H : 0)), pPartRect, color, width, height);
 
 	return true;
 }
 
 void RenderedImage::copyDirectly(int posX, int posY) {
+	finishDecode();
+
 	byte *data = (byte *)_surface.getPixels();
 	int w = _surface.w;
 	int h = _surface.h;
@@ -40,6 +40,7 @@
 #include "sword25/gfx/image/image.h"
 #include "sword25/gfx/graphicengine.h"
 #include "graphics/transparent_surface.h"
+#include "common/threadpool.h"
 
 namespace Sword25 {
 
@@ -109,16 +110,36 @@ public:
 	}
 
 	void setIsTransparent(bool isTransparent) { _isTransparent = isTransparent; }
-	virtual bool isSolid() const { return !_isTransparent; }
+	// Images are not known to be solid while they are being decoded
+	virtual bool isSolid() const { return !_decodeJob.isValid() && !_isTransparent; }
 
 private:
+	/**
+	 * Decodes a PNG image on a worker thread. The size of the image is read
+	 * from its header right away, its pixels are only waited for once they
+	 * are used.
+	 */
+	class DecodeJob : public Common::Job {
+	public:
+		DecodeJob(byte *fileData, uint fileSize) : _fileData(fileData), _fileSize(fileSize), _result(false) {}
+		virtual ~DecodeJob();
+		virtual void run();
+
+		byte *_fileData;
+		uint _fileSize;
+		Graphics::Surface _surface;
+		bool _result; ///< reported by finishDecode(), on the engine thread
+	};
+
 	Graphics::TransparentSurface _surface;
 	bool _doCleanup;
 	bool _isTransparent;
+	Common::Future<DecodeJob> _decodeJob;
 
 	Graphics::Surface *_backSurface;
 
 	void checkForTransparency();
+	void finishDecode();
 };
 
 } // End of namespace Sword25
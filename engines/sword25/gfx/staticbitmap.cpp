@@ -110,6 +110,10 @@ bool StaticBitmap::doRender(RectangleList *updateRects) {
 										 updateRects);
 	}
 
+	// The image may still have been decoding when the bitmap was created, so
+	// whether it is solid is only known now
+	_isSolid = bitmapResourcePtr->isSolid();
+
 	// Resource freigeben
 	bitmapResourcePtr->release();
 
@@ -37,32 +37,43 @@
 
 namespace Sword25 {
 
-// Sets the amount of resources that are simultaneously loaded.
-// This needs to be a relatively high number, as all the animation
-// frames in each scene are loaded as separate resources.
+// Sets the amount of memory taken by resources which are not in use, but
+// are kept loaded for later. This needs to be relatively high, as all the
+// animation frames in each scene are loaded as separate resources.
 // Also, George's walk states are all loaded here (150 files)
-#define SWORD25_RESOURCECACHE_MIN 400
-// The maximum number of loaded resources. If more than these resources
-// are loaded, the resource manager will start purging resources till it
-// hits the minimum limit above
-#define SWORD25_RESOURCECACHE_MAX 500
+#define SWORD25_RESOURCECACHE_BUDGET (64 * 1024 * 1024)
+
+ResourceManager::ResourceLRU::ResourceLRU(ResourceManager *manager) :
+	Common::ResourceCache<Resource>(SWORD25_RESOURCECACHE_BUDGET),
+	_manager(manager) {
+}
+
+void ResourceManager::ResourceLRU::evict(Resource *pResource) {
+	_manager->deleteResource(pResource);
+}
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_cache(this) {
+	_cache.setBudget(Common::ResourceCacheBase::getConfiguredBudget(SWORD25_RESOURCECACHE_BUDGET));
+}
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
 	emptyCache();
 
 	// All remaining resources are not released, so print warnings and release
-	Common::List<Resource *>::iterator iter = _resources.begin();
-	for (; iter != _resources.end(); ++iter) {
-		warning("Resource \"%s\" was not released.", (*iter)->getFileName().c_str());
+	Common::Array<Resource *> resources = getResources();
+	for (uint i = 0; i < resources.size(); ++i) {
+		warning("Resource \"%s\" was not released.", resources[i]->getFileName().c_str());
 
 		// Set the lock count to zero
-		while ((*iter)->getLockCount() > 0) {
-			(*iter)->release();
+		while (resources[i]->getLockCount() > 0) {
+			resources[i]->release();
 		};
 
 		// Delete the resource
-		delete(*iter);
+		deleteResource(resources[i]);
 	}
 }
 
@@ -86,76 +97,55 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  * Deletes resources as necessary until the specified memory limit is not being exceeded.
  */
 void ResourceManager::deleteResourcesIfNecessary() {
-	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
-		return;
+	// Release the resources which have not been accessed for the longest,
+	// as long as they are not locked
+	_cache.evictOld();
 
-	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
-	// The list is processed backwards in order to first release those resources that have been
-	// not been accessed for the longest
-	Common::List<Resource *>::iterator iter = _resources.end();
-	do {
-		--iter;
-
-		// The resource may be released only if it isn't locked
-		if ((*iter)->getLockCount() == 0)
-			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
-
-	// Are we still above the minimum? If yes, then start releasing locked resources
+	// Do locked resources alone exceed the limit? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (_cache.getPinnedSize() <= _cache.getBudget())
 		return;
 
-	iter = _resources.end();
-	do {
-		--iter;
+	Common::Array<Resource *> resources = getResources();
+	for (uint i = 0; i < resources.size() && _cache.getPinnedSize() > _cache.getBudget(); ++i) {
+		Resource *pResource = resources[i];
 
 		// Only unlock image/animation resources
-		if ((*iter)->getFileName().hasSuffix(".swf") ||
-			(*iter)->getFileName().hasSuffix(".png")) {
+		if (pResource->getFileName().hasSuffix(".swf") ||
+			pResource->getFileName().hasSuffix(".png")) {
 
-			warning("Forcibly unlocking %s", (*iter)->getFileName().c_str());
+			warning("Forcibly unlocking %s", pResource->getFileName().c_str());
 
 			// Forcibly unlock the resource
-			while ((*iter)->getLockCount() > 0)
-				(*iter)->release();
+			while (pResource->getLockCount() > 0)
+				pResource->release();
 
-			iter = deleteResource(*iter);
+			deleteResource(pResource);
 		}
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	}
 }
 
 /**
  * Releases all resources that are not locked.
  */
 void ResourceManager::emptyCache() {
-	// Scan through the resource list
-	Common::List<Resource *>::iterator iter = _resources.begin();
-	while (iter != _resources.end()) {
-		if ((*iter)->getLockCount() == 0) {
-			// Delete the resource
-			iter = deleteResource(*iter);
-		} else
-			++iter;
-	}
+	_cache.evictAll();
 }
 
 void ResourceManager::emptyThumbnailCache() {
 	// Scan through the resource list
-	Common::List<Resource *>::iterator iter = _resources.begin();
-	while (iter != _resources.end()) {
-		if ((*iter)->getFileName().hasPrefix("/saves")) {
+	Common::Array<Resource *> resources = getResources();
+	for (uint i = 0; i < resources.size(); ++i) {
+		if (resources[i]->getFileName().hasPrefix("/saves")) {
 			// Unlock the thumbnail
-			while ((*iter)->getLockCount() > 0)
-				(*iter)->release();
+			while (resources[i]->getLockCount() > 0)
+				resources[i]->release();
 			// Delete the thumbnail
-			iter = deleteResource(*iter);
-		} else
-			++iter;
+			deleteResource(resources[i]);
+		}
 	}
 }
 
@@ -172,10 +162,11 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	// Determine whether the resource is already loaded
 	// If the resource is found, it will be placed at the head of the resource list and returned
 	Resource *pResource = getResource(uniqueFileName);
-	if (!pResource)
+	if (pResource)
+		_cache.touch(pResource);
+	else
 		pResource = loadResource(uniqueFileName);
 	if (pResource) {
-		moveToFront(pResource);
 		(pResource)->addReference();
 		return pResource;
 	}
@@ -220,17 +211,16 @@ bool ResourceManager::precacheResource(const Common::String &fileName, bool forc
 
 #endif
 
-/**
- * Moves a resource to the top of the resource list
- * @param pResource     The resource
- */
-void ResourceManager::moveToFront(Resource *pResource) {
-	// Erase the resource from it's current position
-	_resources.erase(pResource->_iterator);
-	// Re-add the resource at the front of the list
-	_resources.push_front(pResource);
-	// Reset the resource iterator to the repositioned item
-	pResource->_iterator = _resources.begin();
+void ResourceManager::pinResource(Resource *pResource) {
+	// Resources may get locked while they are being loaded, before they are
+	// cached; loadResource() takes care of these
+	if (_cache.contains(pResource))
+		_cache.pin(pResource);
+}
+
+void ResourceManager::unpinResource(Resource *pResource) {
+	if (_cache.getPins(pResource))
+		_cache.unpin(pResource);
 }
 
 /**
@@ -253,13 +243,14 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 				return NULL;
 			}
 
-			// Add the resource to the front of the list
-			_resources.push_front(pResource);
-			pResource->_iterator = _resources.begin();
-
-			// Also store the resource in the hash table for quick lookup
+			// Store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
+			// Add the resource to the front of the cache
+			_cache.add(pResource, pResource->getSize());
+			if (pResource->getLockCount())
+				_cache.pin(pResource);
+
 			return pResource;
 		}
 	}
@@ -290,20 +281,33 @@ Common::String ResourceManager::getUniqueFileName(const Common::String &fileName
 }
 
 /**
- * Deletes a resource, removes it from the lists, and updates m_UsedMemory
+ * Deletes a resource and removes it from the cache and the hash table
  */
-Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pResource) {
+void ResourceManager::deleteResource(Resource *pResource) {
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
-	// Delete the resource from the resource list
-	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
+	// Delete the resource from the cache, unless it is being evicted
+	_cache.remove(pResource);
 
 	// Delete the resource
 	delete pResource;
+}
 
-	// Return the iterator
-	return result;
+/**
+ * Returns all loaded resources, the least recently used first
+ */
+Common::Array<Resource *> ResourceManager::getResources() const {
+	Common::Array<Resource *> resources;
+	resources.reserve(_cache.getCount());
+
+	ResourceLRU::const_iterator iter = _cache.end();
+	while (iter != _cache.begin()) {
+		--iter;
+		resources.push_back(iter->resource);
+	}
+
+	return resources;
 }
 
 /**
@@ -324,11 +328,13 @@ Resource *ResourceManager::getResource(const Common::String &uniquefileName) con
  * Writes the names of all currently locked resources to the log file
  */
 void ResourceManager::dumpLockedResources() {
-	for (Common::List<Resource *>::iterator iter = _resources.begin(); iter != _resources.end(); ++iter) {
-		if ((*iter)->getLockCount() > 0) {
-			debugC(kDebugResource, "%s", (*iter)->getFileName().c_str());
+	for (ResourceLRU::const_iterator iter = _cache.begin(); iter != _cache.end(); ++iter) {
+		if (iter->resource->getLockCount() > 0) {
+			debugC(kDebugResource, "%s", iter->resource->getFileName().c_str());
 		}
 	}
+
+	_cache.printStatistics("Resource cache");
 }
 
 } // End of namespace Sword25
@@ -35,6 +35,7 @@
 #include "common/list.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/resourcecache.h"
 
 #include "sword25/kernel/common.h"
 
@@ -48,6 +49,7 @@ class Kernel;
 
 class ResourceManager {
 	friend class Kernel;
+	friend class Resource;
 
 public:
 	/**
@@ -88,21 +90,45 @@ public:
 	 */
 	void dumpLockedResources();
 
+	/**
+	 * Returns the cache of loaded resources, for its statistics
+	 */
+	const Common::ResourceCacheBase &getCache() const {
+		return _cache;
+	}
+
 private:
+	/**
+	 * Cache of the loaded resources. Locked resources are pinned; evicting a
+	 * resource deletes it.
+	 */
+	class ResourceLRU : public Common::ResourceCache<Resource> {
+	public:
+		ResourceLRU(ResourceManager *manager);
+
+	protected:
+		virtual void evict(Resource *pResource);
+
+	private:
+		ResourceManager *_manager;
+	};
+
 	/**
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
-	 * Moves a resource to the top of the resource list
-	 * @param pResource     The resource
+	 * Protects a resource from being released, called when it gets locked
+	 */
+	void pinResource(Resource *pResource);
+
+	/**
+	 * Allows a resource to be released, called when its last lock is released
 	 */
-	void moveToFront(Resource *pResource);
+	void unpinResource(Resource *pResource);
 
 	/**
 	 * Loads a resource and updates the m_UsedMemory total
@@ -119,9 +145,14 @@ private:
 	Common::String getUniqueFileName(const Common::String &fileName) const;
 
 	/**
-	 * Deletes a resource, removes it from the lists, and updates m_UsedMemory
+	 * Deletes a resource and removes it from the cache and the hash table
+	 */
+	void deleteResource(Resource *pResource);
+
+	/**
+	 * Returns all loaded resources, the least recently used first
 	 */
-	Common::List<Resource *>::iterator deleteResource(Resource *pResource);
+	Common::Array<Resource *> getResources() const;
 
 	/**
 	 * Returns a pointer to a loaded resource. If any error occurs, NULL will be returned.
@@ -136,7 +167,7 @@ private:
 
 	Kernel *_kernelPtr;
 	Common::Array<ResourceService *> _resourceServices;
-	Common::List<Resource *> _resources;
+	ResourceLRU _cache;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
 };
@@ -31,6 +31,7 @@
 
 #include "sword25/kernel/resource.h"
 #include "sword25/kernel/kernel.h"
+#include "sword25/kernel/resmanager.h"
 #include "sword25/package/packagemanager.h"
 
 namespace Sword25 {
@@ -44,9 +45,15 @@ Resource::Resource(const Common::String &fileName, RESOURCE_TYPES type) :
 	_fileName = pPM->getAbsolutePath(fileName);
 }
 
+void Resource::addReference() {
+	if (!_refCount++)
+		Kernel::getInstance()->getResourceManager()->pinResource(this);
+}
+
 void Resource::release() {
 	if (_refCount) {
-		--_refCount;
+		if (!--_refCount)
+			Kernel::getInstance()->getResourceManager()->unpinResource(this);
 	} else
 		warning("Released unlocked resource \"%s\".", _fileName.c_str());
 }
@@ -59,9 +59,7 @@ public:
 	 * Prevents the resource from being released.
 	 * @remarks             This method allows a resource to be locked multiple times.
 	 **/
-	void addReference() {
-		++_refCount;
-	}
+	void addReference();
 
 	/**
 	 * Cancels a previous lock
@@ -92,6 +90,15 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns the approximate number of bytes the resource takes in memory
+	 */
+	virtual uint32 getSize() const {
+		// Only images are big enough to matter; everything else is
+		// accounted for as a small block
+		return 1024;
+	}
+
 protected:
 	virtual ~Resource() {}
 
@@ -99,7 +106,6 @@ private:
 	Common::String _fileName;          ///< The absolute filename
 	uint _refCount;          ///< The number of locks
 	uint _type;              ///< The type of the resource
-	Common::List<Resource *>::iterator _iterator;        ///< Points to the resource position in the LRU list
 };
 
 } // End of namespace Sword25
@@ -44,6 +44,7 @@
 #include "engines/wintermute/base/base_dynamic_buffer.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/font/base_font.h"
+#include "engines/wintermute/base/font/base_font_storage.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_object.h"
 #include "engines/wintermute/base/base_parser.h"
@@ -51,11 +52,13 @@
 #include "engines/wintermute/base/base_region.h"
 #include "engines/wintermute/base/base_scriptable.h"
 #include "engines/wintermute/base/base_sprite.h"
+#include "engines/wintermute/base/base_surface_storage.h"
 #include "engines/wintermute/base/base_viewport.h"
 #include "engines/wintermute/base/gfx/base_renderer.h"
 #include "engines/wintermute/base/scriptables/script_stack.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/base/scriptables/script.h"
+#include "engines/wintermute/base/sound/base_sound_manager.h"
 #include "engines/wintermute/ui/ui_window.h"
 #include "engines/wintermute/utils/utils.h"
 #include "engines/wintermute/wintermute.h"
@@ -548,9 +551,26 @@ bool AdScene::loadFile(const char *filename) {
 
 	setFilename(filename);
 
+	uint32 loadStart = g_system->getMillis();
+	uint32 surfacesLoaded = _gameRef->_surfaceStorage->_loadedCount;
+	uint32 surfacesShared = _gameRef->_surfaceStorage->_sharedCount;
+	uint32 fontsLoaded = _gameRef->_fontStorage->_loadedCount;
+	uint32 fontsShared = _gameRef->_fontStorage->_sharedCount;
+	uint32 soundsLoaded = _gameRef->_soundMgr->_loadedCount;
+
+	// decode the images of the scene in the background, rather than all at
+	// once when the scene is first drawn
+	_gameRef->_surfaceStorage->_queueLoads = true;
 	if (DID_FAIL(ret = loadBuffer(buffer, true))) {
 		_gameRef->LOG(0, "Error parsing SCENE file '%s'", filename);
 	}
+	_gameRef->_surfaceStorage->_queueLoads = false;
+
+	_gameRef->LOG(0, "Scene '%s' loaded in %d ms: %d surfaces loaded, %d shared; %d fonts loaded, %d shared; %d sounds loaded",
+	              filename, g_system->getMillis() - loadStart,
+	              _gameRef->_surfaceStorage->_loadedCount - surfacesLoaded, _gameRef->_surfaceStorage->_sharedCount - surfacesShared,
+	              _gameRef->_fontStorage->_loadedCount - fontsLoaded, _gameRef->_fontStorage->_sharedCount - fontsShared,
+	              _gameRef->_soundMgr->_loadedCount - soundsLoaded);
 
 	setFilename(filename);
 
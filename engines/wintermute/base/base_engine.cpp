@@ -51,8 +51,14 @@ void BaseEngine::init() {
 	_fileManager = new BaseFileManager(_language);
 	// Don't forget to register your random source
 	_rnd = new Common::RandomSource("Wintermute");
-	_classReg = new SystemClassRegistry();
-	_classReg->registerClasses();
+	initClassRegistry();
+}
+
+void BaseEngine::initClassRegistry() {
+	if (!_classReg) {
+		_classReg = new SystemClassRegistry();
+		_classReg->registerClasses();
+	}
 }
 
 BaseEngine::~BaseEngine() {
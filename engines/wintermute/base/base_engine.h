@@ -60,6 +60,10 @@ public:
 	BaseEngine();
 	~BaseEngine();
 	static void createInstance(const Common::String &targetName, const Common::String &gameId, Common::Language lang, WMETargetExecutable targetExecutable = LATEST_VERSION);
+	// Persistent objects register with the class registry when created.
+	// createInstance() sets it up along with the rest, this only creates the
+	// registry, which is enough to run scripts without any game data.
+	void initClassRegistry();
 
 	void setGameRef(BaseGame *gameRef) { _gameRef = gameRef; }
 
@@ -34,6 +34,7 @@
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/platform_osystem.h"
 #include "common/str.h"
+#include "common/threadpool.h"
 
 namespace Wintermute {
 
@@ -42,6 +43,10 @@ namespace Wintermute {
 //////////////////////////////////////////////////////////////////////
 BaseSurfaceStorage::BaseSurfaceStorage(BaseGame *inGame) : BaseClass(inGame) {
 	_lastCleanupTime = 0;
+	_loadedCount = 0;
+	_sharedCount = 0;
+	_queueLoads = false;
+	_averageLoadTime = 0;
 }
 
 
@@ -60,6 +65,8 @@ bool BaseSurfaceStorage::cleanup(bool warn) {
 		delete _surfaces[i];
 	}
 	_surfaces.clear();
+	_surfaceIndex.clear();
+	_loadQueue.clear();
 
 	return STATUS_OK;
 }
@@ -91,6 +98,11 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 		if (_surfaces[i] == surface) {
 			_surfaces[i]->_referenceCount--;
 			if (_surfaces[i]->_referenceCount <= 0) {
+				SurfaceIndex::iterator it = _surfaceIndex.find(surface->getFileNameStr());
+				if (it != _surfaceIndex.end() && it->_value == surface) {
+					_surfaceIndex.erase(it);
+				}
+				_loadQueue.remove(surface);
 				delete _surfaces[i];
 				_surfaces.remove_at(i);
 			}
@@ -103,11 +115,11 @@ bool BaseSurfaceStorage::removeSurface(BaseSurface *surface) {
 
 //////////////////////////////////////////////////////////////////////
 BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime, bool keepLoaded) {
-	for (uint32 i = 0; i < _surfaces.size(); i++) {
-		if (scumm_stricmp(_surfaces[i]->getFileName(), filename.c_str()) == 0) {
-			_surfaces[i]->_referenceCount++;
-			return _surfaces[i];
-		}
+	SurfaceIndex::iterator it = _surfaceIndex.find(filename);
+	if (it != _surfaceIndex.end()) {
+		it->_value->_referenceCount++;
+		_sharedCount++;
+		return it->_value;
 	}
 
 	if (!BaseFileManager::getEngineInstance()->hasFile(filename)) {
@@ -134,11 +146,39 @@ BaseSurface *BaseSurfaceStorage::addSurface(const Common::String &filename, bool
 	} else {
 		surface->_referenceCount = 1;
 		_surfaces.push_back(surface);
+		_surfaceIndex[filename] = surface;
+		_loadedCount++;
+		// Surfaces with a life time are only decoded when they are shown, as
+		// they are unloaded again after a while
+		if (_queueLoads && surface->_lifeTime <= 0) {
+			if (Common::ThreadPool::instance().getThreadCount() > 0) {
+				surface->startLoad();
+			} else {
+				_loadQueue.push_back(surface);
+			}
+		}
 		return surface;
 	}
 }
 
 
+//////////////////////////////////////////////////////////////////////
+void BaseSurfaceStorage::loadQueuedSurfaces(uint32 deadline) {
+	// Only decode another image if the one before suggests that it will be
+	// done before the deadline
+	uint32 time = g_system->getMillis();
+	while (!_loadQueue.empty() && (int32)(deadline - time) > (int32)_averageLoadTime) {
+		BaseSurface *surface = _loadQueue.front();
+		_loadQueue.pop_front();
+		surface->finishLoad();
+
+		uint32 now = g_system->getMillis();
+		_averageLoadTime = (_averageLoadTime * 3 + (now - time)) / 4;
+		time = now;
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////
 bool BaseSurfaceStorage::restoreAll() {
 	bool ret;
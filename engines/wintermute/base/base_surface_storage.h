@@ -31,6 +31,8 @@
 
 #include "engines/wintermute/base/base.h"
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/list.h"
 
 namespace Wintermute {
 class BaseSurface;
@@ -50,6 +52,23 @@ public:
 	virtual ~BaseSurfaceStorage();
 
 	Common::Array<BaseSurface *> _surfaces;
+
+	uint32 _loadedCount; // Surfaces loaded from a file
+	uint32 _sharedCount; // Requests answered with an already loaded surface
+
+	// While set, new surfaces start decoding on the thread pool. Without
+	// worker threads, they are queued to be decoded in the time left between
+	// frames by loadQueuedSurfaces() instead.
+	bool _queueLoads;
+	void loadQueuedSurfaces(uint32 deadline);
+private:
+	Common::List<BaseSurface *> _loadQueue;
+	uint32 _averageLoadTime; // Milliseconds, of the recently queued surfaces
+
+	// Loaded surfaces by their case-folded file name, so looking a surface up
+	// doesn't take longer as scenes add more of them
+	typedef Common::HashMap<Common::String, BaseSurface *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SurfaceIndex;
+	SurfaceIndex _surfaceIndex;
 };
 
 } // End of namespace Wintermute
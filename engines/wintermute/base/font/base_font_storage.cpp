@@ -41,6 +41,9 @@ IMPLEMENT_PERSISTENT(BaseFontStorage, true)
 
 //////////////////////////////////////////////////////////////////////////
 BaseFontStorage::BaseFontStorage(BaseGame *inGame) : BaseClass(inGame) {
+	_loadedCount = 0;
+	_sharedCount = 0;
+	_fontIndexValid = true;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -57,10 +60,25 @@ bool BaseFontStorage::cleanup(bool warn) {
 		delete _fonts[i];
 	}
 	_fonts.clear();
+	_fontIndex.clear();
+	_fontIndexValid = true;
 
 	return STATUS_OK;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void BaseFontStorage::rebuildIndex() {
+	_fontIndex.clear();
+	for (uint32 i = 0; i < _fonts.size(); i++) {
+		const char *filename = _fonts[i]->getFilename();
+		// The first font of a name wins, like the linear search used to do
+		if (filename && !_fontIndex.contains(filename)) {
+			_fontIndex[filename] = _fonts[i];
+		}
+	}
+	_fontIndexValid = true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool BaseFontStorage::initLoop() {
 	for (uint32 i = 0; i < _fonts.size(); i++) {
@@ -75,11 +93,15 @@ BaseFont *BaseFontStorage::addFont(const Common::String &filename) {
 		return nullptr;
 	}
 
-	for (uint32 i = 0; i < _fonts.size(); i++) {
-		if (scumm_stricmp(_fonts[i]->getFilename(), filename.c_str()) == 0) {
-			_fonts[i]->_refCount++;
-			return _fonts[i];
-		}
+	if (!_fontIndexValid) {
+		rebuildIndex();
+	}
+
+	FontIndex::iterator it = _fontIndex.find(filename);
+	if (it != _fontIndex.end()) {
+		it->_value->_refCount++;
+		_sharedCount++;
+		return it->_value;
 	}
 
 	/*
@@ -100,6 +122,8 @@ BaseFont *BaseFontStorage::addFont(const Common::String &filename) {
 	if (font) {
 		font->_refCount = 1;
 		_fonts.add(font);
+		_fontIndex[filename] = font;
+		_loadedCount++;
 	}
 	return font;
 }
@@ -115,6 +139,10 @@ bool BaseFontStorage::removeFont(BaseFont *font) {
 		if (_fonts[i] == font) {
 			_fonts[i]->_refCount--;
 			if (_fonts[i]->_refCount <= 0) {
+				FontIndex::iterator it = _fontIndex.find(font->getFilename() ? font->getFilename() : "");
+				if (it != _fontIndex.end() && it->_value == font) {
+					_fontIndex.erase(it);
+				}
 				delete _fonts[i];
 				_fonts.remove_at(i);
 			}
@@ -135,6 +163,12 @@ bool BaseFontStorage::persist(BasePersistenceManager *persistMgr) {
 	persistMgr->transferPtr(TMEMBER_PTR(_gameRef));
 	_fonts.persist(persistMgr);
 
+	if (!persistMgr->getIsSaving()) {
+		_fontIndexValid = false;
+		_loadedCount = 0;
+		_sharedCount = 0;
+	}
+
 	return STATUS_OK;
 }
 
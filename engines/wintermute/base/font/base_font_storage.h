@@ -33,6 +33,7 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/coll_templ.h"
+#include "common/hash-str.h"
 
 namespace Wintermute {
 
@@ -48,6 +49,18 @@ public:
 	virtual ~BaseFontStorage();
 	BaseArray<BaseFont *> _fonts;
 	bool initLoop();
+
+	uint32 _loadedCount; // Fonts loaded from a file
+	uint32 _sharedCount; // Requests answered with an already loaded font
+private:
+	// Loaded fonts by their case-folded file name. After loading a savegame
+	// the names of the fonts are only known once all objects are restored, so
+	// the index is then rebuilt on the next lookup.
+	typedef Common::HashMap<Common::String, BaseFont *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FontIndex;
+	FontIndex _fontIndex;
+	bool _fontIndexValid;
+
+	void rebuildIndex();
 };
 
 } // End of namespace Wintermute
@@ -46,12 +46,14 @@ BaseImage::BaseImage() {
 	_palette = nullptr;
 	_surface = nullptr;
 	_decoder = nullptr;
+	_stream = nullptr;
 	_deletableSurface = nullptr;
 }
 
 
 //////////////////////////////////////////////////////////////////////
 BaseImage::~BaseImage() {
+	delete _stream;
 	delete _decoder;
 	if (_deletableSurface) {
 		_deletableSurface->free();
@@ -60,6 +62,10 @@ BaseImage::~BaseImage() {
 }
 
 bool BaseImage::loadFile(const Common::String &filename) {
+	return readFile(filename) && decode();
+}
+
+bool BaseImage::readFile(const Common::String &filename) {
 	_filename = filename;
 	_filename.toLowercase();
 	if (filename.hasPrefix("savegame:") || _filename.hasSuffix(".bmp")) {
@@ -79,14 +85,28 @@ bool BaseImage::loadFile(const Common::String &filename) {
 		return false;
 	}
 
-	_decoder->loadStream(*file);
-	_surface = _decoder->getSurface();
-	_palette = _decoder->getPalette();
+	// The file manager must only be used on the engine thread, so decode()
+	// gets a copy of the file
+	_stream = file->readStream(file->size());
 	_fileManager->closeFile(file);
 
 	return true;
 }
 
+bool BaseImage::decode() {
+	if (!_stream) {
+		return false;
+	}
+
+	bool result = _decoder->loadStream(*_stream);
+	_surface = _decoder->getSurface();
+	_palette = _decoder->getPalette();
+	delete _stream;
+	_stream = nullptr;
+
+	return result;
+}
+
 byte BaseImage::getAlphaAt(int x, int y) const {
 	if (!_surface) {
 		return 0xFF;
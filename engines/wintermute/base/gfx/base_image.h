@@ -49,6 +49,10 @@ public:
 	~BaseImage();
 
 	bool loadFile(const Common::String &filename);
+	// loadFile() in two steps: readFile() reads the file into memory on the
+	// engine thread, then decode() may run on any thread
+	bool readFile(const Common::String &filename);
+	bool decode();
 	const Graphics::Surface *getSurface() const {
 		return _surface;
 	};
@@ -64,6 +68,7 @@ public:
 private:
 	Common::String _filename;
 	Image::ImageDecoder *_decoder;
+	Common::SeekableReadStream *_stream;
 	const Graphics::Surface *_surface;
 	Graphics::Surface *_deletableSurface;
 	const byte *_palette;
@@ -58,6 +58,15 @@ public:
 	virtual bool displayZoom(int x, int y, Rect32 rect, float zoomX, float zoomY, uint32 alpha = 0xFFFFFFFF, bool transparent = false, Graphics::TSpriteBlendMode blendMode = Graphics::BLEND_NORMAL, bool mirrorX = false, bool mirrorY = false) = 0;
 	virtual bool displayTiled(int x, int y, Rect32 rect, int numTimesX, int numTimesY) = 0;
 	virtual bool restore();
+	// Surfaces created from a file may decode it only when first used.
+	// startLoad() starts decoding it in the background, and finishLoad()
+	// decodes it right away or waits for the background decoding to finish.
+	virtual bool startLoad() {
+		return true;
+	}
+	virtual bool finishLoad() {
+		return true;
+	}
 	virtual bool create(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime = -1, bool keepLoaded = false) = 0;
 	virtual bool create(int width, int height);
 	virtual bool putSurface(const Graphics::Surface &surface, bool hasAlpha = false) {
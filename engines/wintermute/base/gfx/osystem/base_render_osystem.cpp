@@ -33,13 +33,15 @@
 #include "engines/wintermute/base/gfx/base_image.h"
 #include "engines/wintermute/math/math_util.h"
 #include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/font/base_font.h"
 #include "engines/wintermute/base/base_sprite.h"
 #include "common/system.h"
 #include "graphics/transparent_surface.h"
+#include "common/algorithm.h"
 #include "common/queue.h"
 #include "common/config-manager.h"
 
-#define DIRTY_RECT_LIMIT 800
+#define DIRTY_TILE_SIZE 32
 
 namespace Wintermute {
 
@@ -58,6 +60,9 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
 	_dirtyRect = nullptr;
+	_dirtyTilesX = _dirtyTilesY = 0;
+	_drawnPixels = _blendedPixels = _redrawnTiles = 0;
+	resetRenderStats();
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -138,6 +143,15 @@ bool BaseRenderOSystem::initRenderer(int width, int height, bool windowed) {
 	_renderSurface->create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 	_blankSurface->create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 	_blankSurface->fillRect(Common::Rect(0, 0, _blankSurface->h, _blankSurface->w), _blankSurface->format.ARGBToColor(255, 0, 0, 0));
+
+	_dirtyTilesX = (_renderSurface->w + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+	_dirtyTilesY = (_renderSurface->h + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+	_dirtyTiles.clear();
+	_dirtyTiles.resize(_dirtyTilesX * _dirtyTilesY);
+	_tileTickets.clear();
+	_tileTickets.resize(_dirtyTilesX * _dirtyTilesY);
+	clearDirtyRects();
+
 	_active = true;
 
 	_clearColor = _renderSurface->format.ARGBToColor(255, 0, 0, 0);
@@ -154,8 +168,7 @@ bool BaseRenderOSystem::indicatorFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		clearDirtyRects();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -195,8 +208,7 @@ bool BaseRenderOSystem::flip() {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
 		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		clearDirtyRects();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -371,6 +383,75 @@ void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
 		_dirtyRect->extend(rect);
 	}
 	_dirtyRect->clip(_renderRect);
+
+	Common::Rect tileRect(rect);
+	tileRect.clip(_renderRect);
+	tileRect.clip(Common::Rect(_renderSurface->w, _renderSurface->h));
+	if (tileRect.isEmpty()) {
+		return;
+	}
+
+	int lastX = (tileRect.right - 1) / DIRTY_TILE_SIZE;
+	int lastY = (tileRect.bottom - 1) / DIRTY_TILE_SIZE;
+	for (int y = tileRect.top / DIRTY_TILE_SIZE; y <= lastY; y++) {
+		for (int x = tileRect.left / DIRTY_TILE_SIZE; x <= lastX; x++) {
+			_dirtyTiles[y * _dirtyTilesX + x] = true;
+		}
+	}
+}
+
+void BaseRenderOSystem::clearDirtyRects() {
+	delete _dirtyRect;
+	_dirtyRect = nullptr;
+
+	for (uint i = 0; i < _dirtyTiles.size(); i++) {
+		_dirtyTiles[i] = false;
+	}
+}
+
+void BaseRenderOSystem::getDirtyRegions(Common::Array<Common::Rect> &regions) const {
+	regions.clear();
+
+	for (int y = 0; y < _dirtyTilesY; y++) {
+		int x = 0;
+		while (x < _dirtyTilesX) {
+			if (!_dirtyTiles[y * _dirtyTilesX + x]) {
+				x++;
+				continue;
+			}
+
+			// A run of dirty tiles in this row
+			int firstX = x;
+			while (x < _dirtyTilesX && _dirtyTiles[y * _dirtyTilesX + x]) {
+				x++;
+			}
+			Common::Rect run(firstX * DIRTY_TILE_SIZE, y * DIRTY_TILE_SIZE, x * DIRTY_TILE_SIZE, (y + 1) * DIRTY_TILE_SIZE);
+
+			// Extend the region of the same run in the row above, if any
+			bool merged = false;
+			for (uint i = 0; i < regions.size(); i++) {
+				if (regions[i].left == run.left && regions[i].right == run.right && regions[i].bottom == run.top) {
+					regions[i].bottom = run.bottom;
+					merged = true;
+					break;
+				}
+			}
+			if (!merged) {
+				regions.push_back(run);
+			}
+		}
+	}
+
+	uint i = 0;
+	while (i < regions.size()) {
+		regions[i].clip(_renderRect);
+		regions[i].clip(Common::Rect(_renderSurface->w, _renderSurface->h));
+		if (regions[i].isEmpty()) {
+			regions.remove_at(i);
+		} else {
+			i++;
+		}
+	}
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -399,30 +480,104 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
-	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
-	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
-	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+
+	Common::Array<Common::Rect> regions;
+	getDirtyRegions(regions);
+
+	Common::Array<RenderTicket *> tickets;
+	tickets.reserve(_renderQueue.size());
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		tickets.push_back(*it);
+	}
+
+	_drawnPixels = _blendedPixels = _redrawnTiles = 0;
+	for (uint i = 0; i < _dirtyTiles.size(); i++) {
+		if (_dirtyTiles[i]) {
+			_redrawnTiles++;
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
 	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
+
+	// Bin the tickets into the dirty tiles they touch, so that each region
+	// only has to look at the tickets of its own tiles
+	for (uint i = 0; i < _tileTickets.size(); i++) {
+		_tileTickets[i].resize(0);
+	}
+	for (uint j = 0; j < tickets.size(); j++) {
+		Common::Rect rect(tickets[j]->_dstRect);
+		rect.clip(Common::Rect(_renderSurface->w, _renderSurface->h));
+		if (rect.isEmpty()) {
+			continue;
+		}
+
+		int lastX = (rect.right - 1) / DIRTY_TILE_SIZE;
+		int lastY = (rect.bottom - 1) / DIRTY_TILE_SIZE;
+		for (int y = rect.top / DIRTY_TILE_SIZE; y <= lastY; y++) {
+			for (int x = rect.left / DIRTY_TILE_SIZE; x <= lastX; x++) {
+				if (_dirtyTiles[y * _dirtyTilesX + x]) {
+					_tileTickets[y * _dirtyTilesX + x].push_back(j);
+				}
+			}
+		}
+	}
+
+	// Tickets of the current region, in drawing order, and the region
+	// each ticket was last added for
+	Common::Array<uint> regionTickets;
+	Common::Array<uint> ticketRegion;
+	ticketRegion.resize(tickets.size());
+	for (uint j = 0; j < tickets.size(); j++) {
+		ticketRegion[j] = 0;
+	}
+
+	for (uint i = 0; i < regions.size(); i++) {
+		const Common::Rect &region = regions[i];
+
+		regionTickets.resize(0);
+		int lastX = (region.right - 1) / DIRTY_TILE_SIZE;
+		int lastY = (region.bottom - 1) / DIRTY_TILE_SIZE;
+		for (int y = region.top / DIRTY_TILE_SIZE; y <= lastY; y++) {
+			for (int x = region.left / DIRTY_TILE_SIZE; x <= lastX; x++) {
+				const Common::Array<uint> &tileTickets = _tileTickets[y * _dirtyTilesX + x];
+				for (uint k = 0; k < tileTickets.size(); k++) {
+					if (ticketRegion[tileTickets[k]] != i + 1) {
+						ticketRegion[tileTickets[k]] = i + 1;
+						regionTickets.push_back(tileTickets[k]);
+					}
+				}
+			}
+		}
+		Common::sort(regionTickets.begin(), regionTickets.end());
+
+		// Nothing drawn before an opaque ticket covering the whole region can
+		// be seen, so start with the last such ticket, if any. Typical use-cases:
+		// fullscreen FMVs and backgrounds.
+		uint first = regionTickets.size();
+		while (first > 0) {
+			const RenderTicket *ticket = tickets[regionTickets[first - 1]];
+			if (ticket->_dstRect.contains(region) && ticket->isOpaque()) {
+				break;
+			}
+			first--;
+		}
+		if (first > 0) {
+			first--;
+		} else {
+			// Apply the clear-color to the region.
+			_renderSurface->fillRect(region, _clearColor);
+		}
+
+		for (uint j = first; j < regionTickets.size(); j++) {
+			RenderTicket *ticket = tickets[regionTickets[j]];
+			if (!ticket->_dstRect.intersects(region)) {
+				continue;
+			}
+
 			// dstClip is the area we want redrawn.
 			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
+			// reduce it to the dirty region
+			dstClip.clip(region);
+			// we need to keep track of the position to redraw the dirty region
 			Common::Rect pos(dstClip);
 			int16 offsetX = ticket->_dstRect.left;
 			int16 offsetY = ticket->_dstRect.top;
@@ -431,11 +586,26 @@ void BaseRenderOSystem::drawTickets() {
 
 			drawFromSurface(ticket, &pos, &dstClip);
 			_needsFlip = true;
+
+			uint32 pixels = dstClip.width() * dstClip.height();
+			_drawnPixels += pixels;
+			if (!ticket->isOpaque()) {
+				_blendedPixels += pixels;
+			}
 		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
+
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(region.left, region.top), _renderSurface->pitch, region.left, region.top, region.width(), region.height());
+	}
+
+	_renderStats.frames++;
+	_renderStats.redrawnTiles += _redrawnTiles;
+	_renderStats.drawnPixels += _drawnPixels;
+	_renderStats.blendedPixels += _blendedPixels;
+
+	// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
+	for (uint i = 0; i < tickets.size(); i++) {
+		tickets[i]->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -581,6 +751,24 @@ void BaseRenderOSystem::endSaveLoad() {
 	g_system->updateScreen();
 }
 
+bool BaseRenderOSystem::displayDebugInfo() {
+	if (_disableDirtyRects) {
+		return STATUS_OK;
+	}
+
+	char str[100];
+	sprintf(str, "Redrawn: %u tiles, %u px (%u blended)", _redrawnTiles, _drawnPixels, _blendedPixels);
+	_gameRef->getSystemFont()->drawText((byte *)str, 0, 50, getWidth(), TAL_RIGHT);
+	return STATUS_OK;
+}
+
+void BaseRenderOSystem::resetRenderStats() {
+	_renderStats.frames = 0;
+	_renderStats.redrawnTiles = 0;
+	_renderStats.drawnPixels = 0;
+	_renderStats.blendedPixels = 0;
+}
+
 bool BaseRenderOSystem::startSpriteBatch() {
 	return STATUS_OK;
 }
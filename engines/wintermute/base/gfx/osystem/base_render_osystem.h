@@ -33,6 +33,7 @@
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
+#include "common/array.h"
 #include "graphics/transform_struct.h"
 
 namespace Wintermute {
@@ -107,6 +108,19 @@ public:
 	float getScaleRatioY() const override {
 		return _ratioY;
 	}
+	bool displayDebugInfo() override;
+
+	// Totals over the frames drawn with dirty rects, since the last reset
+	struct RenderStats {
+		uint32 frames;
+		uint64 redrawnTiles;
+		uint64 drawnPixels;
+		uint64 blendedPixels; // Drawn by tickets which are not opaque
+	};
+	const RenderStats &getRenderStats() const {
+		return _renderStats;
+	}
+	void resetRenderStats();
 	virtual bool startSpriteBatch() override;
 	virtual bool endSpriteBatch() override;
 	void endSaveLoad();
@@ -118,6 +132,15 @@ private:
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
+	/**
+	 * Forget about all dirty areas, as they have been drawn.
+	 */
+	void clearDirtyRects();
+	/**
+	 * Merge the dirty tiles into as few rectangles as easily found.
+	 * @param regions receives the rectangles, clipped to the render rect
+	 */
+	void getDirtyRegions(Common::Array<Common::Rect> &regions) const;
 	/**
 	 * Traverse the tickets that are dirty, and draw them
 	 */
@@ -126,9 +149,24 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
+	// Bounding box of all dirty areas
 	Common::Rect *_dirtyRect;
+	// The screen is divided into tiles, and only the dirty ones are drawn
+	// again, so small changes in distant parts of the screen don't make
+	// everything between them redrawn
+	Common::Array<bool> _dirtyTiles;
+	// Indices of the tickets touching each dirty tile, in drawing order
+	Common::Array<Common::Array<uint> > _tileTickets;
+	int _dirtyTilesX;
+	int _dirtyTilesY;
 	Common::List<RenderTicket *> _renderQueue;
 
+	// Statistics of the last frame drawn with dirty rects
+	uint32 _drawnPixels;
+	uint32 _blendedPixels; // Drawn by tickets which are not opaque
+	uint32 _redrawnTiles;
+	RenderStats _renderStats;
+
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
 	Common::Rect _renderRect;
@@ -130,15 +130,38 @@ bool BaseSurfaceOSystem::create(const Common::String &filename, bool defaultCK,
 	return STATUS_OK;
 }
 
-bool BaseSurfaceOSystem::finishLoad() {
+bool BaseSurfaceOSystem::startLoad() {
+	if (_loaded || _loadJob.isValid()) {
+		return true;
+	}
+
 	BaseImage *image = new BaseImage();
-	if (!image->loadFile(_filename)) {
+	if (!image->readFile(_filename)) {
 		delete image;
 		return false;
 	}
 
-	_width = image->getSurface()->w;
-	_height = image->getSurface()->h;
+	_loadJob = Common::ThreadPool::instance().async(new LoadJob(image, g_system->getScreenFormat(), _filename.hasSuffix(".bmp"), _ckRed, _ckGreen, _ckBlue));
+	return true;
+}
+
+bool BaseSurfaceOSystem::finishLoad() {
+	if (_loaded) {
+		return true;
+	}
+
+	if (!startLoad()) {
+		return false;
+	}
+
+	LoadJob &job = _loadJob.get();
+	if (!job._surface) {
+		if (job._image->getSurface()) {
+			error("Missing palette while loading 8bit image %s", _filename.c_str());
+		}
+		_loadJob = Common::Future<LoadJob>();
+		return false;
+	}
 
 	bool isSaveGameGrayscale = _filename.matchString("savegame:*g", true);
 	if (isSaveGameGrayscale) {
@@ -148,28 +171,63 @@ bool BaseSurfaceOSystem::finishLoad() {
 
 	_surface->free();
 	delete _surface;
+	_surface = job._surface;
+	job._surface = nullptr;
+
+	_width = _surface->w;
+	_height = _surface->h;
+	_alphaType = job._alphaType;
+	_valid = true;
+
+	_gameRef->addMem(_width * _height * 4);
+
+	_loadJob = Common::Future<LoadJob>();
+	_loaded = true;
 
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+BaseSurfaceOSystem::LoadJob::LoadJob(BaseImage *image, const Graphics::PixelFormat &format, bool isBMP, byte ckRed, byte ckGreen, byte ckBlue) :
+	_image(image), _format(format), _isBMP(isBMP), _ckRed(ckRed), _ckGreen(ckGreen), _ckBlue(ckBlue), _surface(nullptr), _alphaType(Graphics::ALPHA_FULL) {
+}
+
+BaseSurfaceOSystem::LoadJob::~LoadJob() {
+	if (_surface) {
+		_surface->free();
+		delete _surface;
+	}
+	delete _image;
+}
+
+void BaseSurfaceOSystem::LoadJob::run() {
+	if (!_image->decode()) {
+		return;
+	}
+
+	const Graphics::Surface *source = _image->getSurface();
 	bool needsColorKey = false;
 	bool replaceAlpha = true;
-	if (image->getSurface()->format.bytesPerPixel == 1) {
-		if (!image->getPalette()) {
-			error("Missing palette while loading 8bit image %s", _filename.c_str());
+	if (source->format.bytesPerPixel == 1) {
+		// Reported by finishLoad(), on the engine thread
+		if (!_image->getPalette()) {
+			return;
 		}
-		_surface = image->getSurface()->convertTo(g_system->getScreenFormat(), image->getPalette());
+		_surface = source->convertTo(_format, _image->getPalette());
 		needsColorKey = true;
 	} else {
-		if (image->getSurface()->format != g_system->getScreenFormat()) {
-			_surface = image->getSurface()->convertTo(g_system->getScreenFormat());
+		if (source->format != _format) {
+			_surface = source->convertTo(_format);
 		} else {
 			_surface = new Graphics::Surface();
-			_surface->copyFrom(*image->getSurface());
+			_surface->copyFrom(*source);
 		}
 
-		if (_filename.hasSuffix(".bmp") && image->getSurface()->format.bytesPerPixel == 4) {
+		if (_isBMP && source->format.bytesPerPixel == 4) {
 			// 32 bpp BMPs have nothing useful in their alpha-channel -> color-key
 			needsColorKey = true;
 			replaceAlpha = false;
-		} else if (image->getSurface()->format.aBits() == 0) {
+		} else if (source->format.aBits() == 0) {
 			needsColorKey = true;
 		}
 	}
@@ -180,15 +238,6 @@ bool BaseSurfaceOSystem::finishLoad() {
 	}
 
 	_alphaType = hasTransparencyType(_surface);
-	_valid = true;
-
-	_gameRef->addMem(_width * _height * 4);
-
-	delete image;
-
-	_loaded = true;
-
-	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,7 @@
 #include "graphics/transparent_surface.h"
 #include "engines/wintermute/base/gfx/base_surface.h"
 #include "common/list.h"
+#include "common/threadpool.h"
 
 namespace Wintermute {
 struct TransparentSurface;
@@ -44,6 +45,8 @@ public:
 
 	bool create(const Common::String &filename, bool defaultCK, byte ckRed, byte ckGreen, byte ckBlue, int lifeTime = -1, bool keepLoaded = false) override;
 	bool create(int width, int height) override;
+	bool startLoad() override;
+	bool finishLoad() override;
 
 	bool isTransparentAt(int x, int y) override;
 	bool isTransparentAtLite(int x, int y) override;
@@ -84,9 +87,26 @@ public:
 
 	Graphics::AlphaType getAlphaType() const { return _alphaType; }
 private:
+	// Decodes the image and converts it to the screen format, on any thread
+	class LoadJob : public Common::Job {
+	public:
+		LoadJob(BaseImage *image, const Graphics::PixelFormat &format, bool isBMP, byte ckRed, byte ckGreen, byte ckBlue);
+		~LoadJob();
+		void run() override;
+
+		BaseImage *_image;
+		Graphics::PixelFormat _format;
+		bool _isBMP;
+		byte _ckRed;
+		byte _ckGreen;
+		byte _ckBlue;
+		Graphics::Surface *_surface;
+		Graphics::AlphaType _alphaType;
+	};
+
 	Graphics::Surface *_surface;
 	bool _loaded;
-	bool finishLoad();
+	Common::Future<LoadJob> _loadJob;
 	bool drawSprite(int x, int y, Rect32 *rect, Rect32 *newRect, Graphics::TransformStruct transformStruct);
 	void genAlphaMask(Graphics::Surface *surface);
 	uint32 getPixelAt(Graphics::Surface *surface, int x, int y);
@@ -106,6 +106,22 @@ bool RenderTicket::operator==(const RenderTicket &t) const {
 	return true;
 }
 
+bool RenderTicket::isOpaque() const {
+	if (!_owner || !_surface || !_isValid) {
+		return false;
+	}
+	if (!_transform._alphaDisable && _owner->getAlphaType() != Graphics::ALPHA_OPAQUE) {
+		return false;
+	}
+	if (_transform._rgbaMod != Graphics::kDefaultRgbaMod || _transform._blendMode != Graphics::BLEND_NORMAL) {
+		return false;
+	}
+	// Rotated tickets leave the corners of their destination rect untouched
+	return _transform._angle == Graphics::kDefaultAngle &&
+	       _surface->w * _transform._numTimesX == _dstRect.width() &&
+	       _surface->h * _transform._numTimesY == _dstRect.height();
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface) const {
 	Graphics::TransparentSurface src(*getSurface(), false);
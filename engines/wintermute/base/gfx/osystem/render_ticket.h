@@ -69,6 +69,11 @@ public:
 
 	BaseSurfaceOSystem *_owner;
 	bool operator==(const RenderTicket &a) const;
+	/**
+	 * Whether drawing the ticket copies its pixels without blending, and
+	 * replaces every pixel of its destination rect.
+	 */
+	bool isOpaque() const;
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
 private:
 	Graphics::Surface *_surface;
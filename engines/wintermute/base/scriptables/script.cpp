@@ -49,6 +49,7 @@ ScScript::ScScript(BaseGame *inGame, ScEngine *engine) : BaseClass(inGame) {
 
 	_symbols = nullptr;
 	_numSymbols = 0;
+	_nextScopeId = 0;
 
 	_engine = engine;
 
@@ -232,14 +233,63 @@ bool ScScript::initTables() {
 
 	_iP = origIP;
 
+	if (!_linkTable) {
+		_linkTable = TLinkTablePtr(new TLinkTable());
+	}
+	if (!_linkTable->linked) {
+		link();
+	}
+
+	// nothing is resolved yet; this also drops the slots and scope ids
+	// of a script restored from a saved game, see getScopeId()
+	_varSlots.clear();
+	_varSlots.resize(_numSymbols);
+	_scopeIds.clear();
+
 	return STATUS_OK;
 }
 
 
 //////////////////////////////////////////////////////////////////////////
-bool ScScript::create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner) {
+void ScScript::link() {
+	TLinkTable &table = *_linkTable;
+
+	// the first function or method of a name wins, the last event
+	for (uint32 i = 0; i < _numFunctions; i++) {
+		if (!table.functions.contains(_functions[i].name)) {
+			table.functions[_functions[i].name] = _functions[i].pos;
+		}
+	}
+	for (uint32 i = 0; i < _numMethods; i++) {
+		if (!table.methods.contains(_methods[i].name)) {
+			table.methods[_methods[i].name] = _methods[i].pos;
+		}
+	}
+	for (uint32 i = 0; i < _numEvents; i++) {
+		table.events[_events[i].name] = _events[i].pos;
+	}
+
+	table.externals.resize(_numSymbols);
+	for (uint32 i = 0; i < _numSymbols; i++) {
+		table.externals[i] = -1;
+		for (uint32 j = 0; j < _numExternals; j++) {
+			if (strcmp(_symbols[i], _externals[j].name) == 0) {
+				table.externals[i] = j;
+				break;
+			}
+		}
+	}
+
+	table.linked = true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool ScScript::create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner, const TLinkTablePtr &linkTable) {
 	cleanup();
 
+	_linkTable = linkTable;
+
 	_thread = false;
 	_methodThread = false;
 
@@ -299,6 +349,7 @@ bool ScScript::createThread(ScScript *original, uint32 initIP, const Common::Str
 
 	memcpy(_buffer, original->_buffer, original->_bufferSize);
 	_bufferSize = original->_bufferSize;
+	_linkTable = original->_linkTable;
 
 	// initialize
 	bool res = initScript();
@@ -356,6 +407,7 @@ bool ScScript::createMethodThread(ScScript *original, const Common::String &meth
 
 	memcpy(_buffer, original->_buffer, original->_bufferSize);
 	_bufferSize = original->_bufferSize;
+	_linkTable = original->_linkTable;
 
 	// initialize
 	bool res = initScript();
@@ -398,6 +450,9 @@ void ScScript::cleanup() {
 	_symbols = nullptr;
 	_numSymbols = 0;
 
+	_varSlots.clear();
+	_scopeIds.clear();
+
 	if (_globals && !_thread) {
 		delete _globals;
 	}
@@ -445,6 +500,8 @@ void ScScript::cleanup() {
 	_externals = nullptr;
 	_numExternals = 0;
 
+	_linkTable.reset();
+
 	delete _operand;
 	delete _reg1;
 	_operand = nullptr;
@@ -533,9 +590,19 @@ bool ScScript::executeInstruction() {
 		_operand->setNULL();
 		dw = getDWORD();
 		if (_scopeStack->_sP < 0) {
+			if (!_globals->findProp(_symbols[dw])) {
+				_engine->_varEpoch++;
+			}
 			_globals->setProp(_symbols[dw], _operand);
 		} else {
-			_scopeStack->getTop()->setProp(_symbols[dw], _operand);
+			ScValue *scope = _scopeStack->getTop();
+			scope->setProp(_symbols[dw], _operand);
+
+			// the local hides whatever the name referred to so far
+			TVarSlot &slot = _varSlots[dw];
+			slot.value = scope->findProp(_symbols[dw]);
+			slot.scope = getScopeId();
+			slot.epoch = _engine->_varEpoch;
 		}
 
 		break;
@@ -548,6 +615,7 @@ bool ScScript::executeInstruction() {
 		if (!_engine->_globals->propExists(_symbols[dw])) {
 			_operand->setNULL();
 			_engine->_globals->setProp(_symbols[dw], _operand, false, inst == II_DEF_CONST_VAR);
+			_engine->_varEpoch++;
 		}
 		break;
 	}
@@ -668,9 +736,9 @@ bool ScScript::executeInstruction() {
 	case II_EXTERNAL_CALL: {
 		uint32 symbolIndex = getDWORD();
 
-		TExternalFunction *f = getExternal(_symbols[symbolIndex]);
-		if (f) {
-			externalCall(_stack, _thisStack, f);
+		int32 external = _linkTable->externals[symbolIndex];
+		if (external >= 0) {
+			externalCall(_stack, _thisStack, &_externals[external]);
 		} else {
 			_gameRef->externalCall(this, _stack, _thisStack, _symbols[symbolIndex]);
 		}
@@ -680,6 +748,7 @@ bool ScScript::executeInstruction() {
 	case II_SCOPE:
 		_operand->setNULL();
 		_scopeStack->push(_operand);
+		enterScope();
 		break;
 
 	case II_CORRECT_STACK:
@@ -697,7 +766,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_VAR: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getVar(getDWORD());
 		if (false && /*var->_type==VAL_OBJECT ||*/ var->_type == VAL_NATIVE) {
 			_operand->setReference(var);
 			_stack->push(_operand);
@@ -708,15 +777,14 @@ bool ScScript::executeInstruction() {
 	}
 
 	case II_PUSH_VAR_REF: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getVar(getDWORD());
 		_operand->setReference(var);
 		_stack->push(_operand);
 		break;
 	}
 
 	case II_POP_VAR: {
-		char *varName = _symbols[getDWORD()];
-		ScValue *var = getVar(varName);
+		ScValue *var = getVar(getDWORD());
 		if (var) {
 			ScValue *val = _stack->pop();
 			if (!val) {
@@ -769,7 +837,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_THIS:
-		_operand->setReference(getVar(_symbols[getDWORD()]));
+		_operand->setReference(getVar(getDWORD()));
 		_thisStack->push(_operand);
 		break;
 
@@ -1106,23 +1174,19 @@ bool ScScript::executeInstruction() {
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getFuncPos(const Common::String &name) {
-	for (uint32 i = 0; i < _numFunctions; i++) {
-		if (name == _functions[i].name) {
-			return _functions[i].pos;
-		}
+	if (!_linkTable) {
+		return 0;
 	}
-	return 0;
+	return _linkTable->functions.getVal(name, 0);
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getMethodPos(const Common::String &name) const {
-	for (uint32 i = 0; i < _numMethods; i++) {
-		if (name == _methods[i].name) {
-			return _methods[i].pos;
-		}
+	if (!_linkTable) {
+		return 0;
 	}
-	return 0;
+	return _linkTable->methods.getVal(name, 0);
 }
 
 
@@ -1132,23 +1196,17 @@ ScValue *ScScript::getVar(char *name) {
 
 	// scope locals
 	if (_scopeStack->_sP >= 0) {
-		if (_scopeStack->getTop()->propExists(name)) {
-			ret = _scopeStack->getTop()->getProp(name);
-		}
+		ret = _scopeStack->getTop()->findProp(name);
 	}
 
 	// script globals
 	if (ret == nullptr) {
-		if (_globals->propExists(name)) {
-			ret = _globals->getProp(name);
-		}
+		ret = _globals->findProp(name);
 	}
 
 	// engine globals
 	if (ret == nullptr) {
-		if (_engine->_globals->propExists(name)) {
-			ret = _engine->_globals->getProp(name);
-		}
+		ret = _engine->_globals->findProp(name);
 	}
 
 	if (ret == nullptr) {
@@ -1156,6 +1214,7 @@ ScValue *ScScript::getVar(char *name) {
 		_gameRef->LOG(0, "Warning: variable '%s' is inaccessible in the current block. Consider changing the script (script:%s, line:%d)", name, _filename, _currentLine);
 		ScValue *val = new ScValue(_gameRef);
 		ScValue *scope = _scopeStack->getTop();
+		_engine->_varEpoch++;
 		if (scope) {
 			scope->setProp(name, val);
 			ret = _scopeStack->getTop()->getProp(name);
@@ -1170,6 +1229,48 @@ ScValue *ScScript::getVar(char *name) {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::getVar(uint32 symbol) {
+	TVarSlot &slot = _varSlots[symbol];
+	const uint32 scope = getScopeId();
+	if (slot.value && slot.scope == scope && slot.epoch == _engine->_varEpoch) {
+		return slot.value;
+	}
+
+	slot.value = getVar(_symbols[symbol]);
+	slot.scope = scope;
+	slot.epoch = _engine->_varEpoch;
+	return slot.value;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+uint32 ScScript::getScopeId() {
+	if (_scopeStack->_sP < 0) {
+		return 0;
+	}
+
+	// The ids are not saved, so the scopes of a restored script get new
+	// ones when they are first used
+	while ((int32)_scopeIds.size() <= _scopeStack->_sP) {
+		_scopeIds.push_back(++_nextScopeId);
+	}
+	return _scopeIds[_scopeStack->_sP];
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScScript::enterScope() {
+	// The value on the scope stack is reused, so it needs a new id for the
+	// variables resolved in the previous scope there not to be found
+	if ((int32)_scopeIds.size() > _scopeStack->_sP) {
+		_scopeIds[_scopeStack->_sP] = ++_nextScopeId;
+	} else {
+		getScopeId();
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScScript::waitFor(BaseObject *object) {
 	if (_unbreakable) {
@@ -1348,12 +1449,10 @@ ScScript *ScScript::invokeEventHandler(const Common::String &eventName, bool unb
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getEventPos(const Common::String &name) const {
-	for (int i = _numEvents - 1; i >= 0; i--) {
-		if (scumm_stricmp(name.c_str(), _events[i].name) == 0) {
-			return _events[i].pos;
-		}
+	if (!_linkTable) {
+		return 0;
 	}
-	return 0;
+	return _linkTable->events.getVal(name, 0);
 }
 
 
@@ -1450,7 +1549,7 @@ bool ScScript::finishThreads() {
 //////////////////////////////////////////////////////////////////////////
 void ScScript::afterLoad() {
 	if (_buffer == nullptr) {
-		byte *buffer = _engine->getCompiledScript(_filename, &_bufferSize);
+		byte *buffer = _engine->getCompiledScript(_filename, &_bufferSize, false, &_linkTable);
 		if (!buffer) {
 			_gameRef->LOG(0, "Error reinitializing script '%s' after load. Script will be terminated.", _filename);
 			_state = SCRIPT_ERROR;
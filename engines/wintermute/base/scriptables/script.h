@@ -34,6 +34,8 @@
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/persistent.h"
+#include "common/hash-str.h"
+#include "common/ptr.h"
 
 namespace Wintermute {
 class BaseScriptHolder;
@@ -120,6 +122,20 @@ public:
 		TExternalType *params;
 	} TExternalFunction;
 
+	// The functions, methods and events by name, and the external function
+	// each symbol refers to. These only depend on the compiled script, so they
+	// are resolved once and shared by all scripts and threads running it.
+	struct TLinkTable {
+		bool linked;
+		Common::HashMap<Common::String, uint32> functions;
+		Common::HashMap<Common::String, uint32> methods;
+		Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> events;
+		Common::Array<int32> externals; // index into the externals for each symbol, or -1
+
+		TLinkTable() : linked(false) {}
+	};
+	typedef Common::SharedPtr<TLinkTable> TLinkTablePtr;
+
 
 	ScStack *_callStack;
 	ScStack *_thisStack;
@@ -133,7 +149,7 @@ public:
 	uint32 getDWORD();
 	double getFloat();
 	void cleanup();
-	bool create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner);
+	bool create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner, const TLinkTablePtr &linkTable = TLinkTablePtr());
 	uint32 _iP;
 private:
 	void readHeader();
@@ -161,9 +177,30 @@ private:
 	uint32 _numFunctions;
 	uint32 _numMethods;
 	uint32 _numEvents;
+	TLinkTablePtr _linkTable;
+
+	// The variable each symbol last resolved to, so that the instructions
+	// accessing variables do not look them up by name every time. A slot is
+	// only valid in the scope it was resolved in, and until variables are
+	// added to or removed from the global tables (see ScEngine::_varEpoch).
+	struct TVarSlot {
+		ScValue *value;
+		uint32 scope;
+		uint32 epoch;
+
+		TVarSlot() : value(nullptr), scope(0), epoch(0) {}
+	};
+	Common::Array<TVarSlot> _varSlots;
+	Common::Array<uint32> _scopeIds; // a unique id for each scope on the scope stack
+	uint32 _nextScopeId;
+
+	ScValue *getVar(uint32 symbol);
+	uint32 getScopeId();
+	void enterScope();
 
 	bool initScript();
 	bool initTables();
+	void link();
 
 	virtual void preInstHook(uint32 inst);
 	virtual void postInstHook(uint32 inst);
@@ -34,6 +34,9 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/utils/utils.h"
+#include "engines/wintermute/wintermute.h"
+#include "common/algorithm.h"
+#include "common/debug-channels.h"
 
 namespace Wintermute {
 
@@ -44,6 +47,8 @@ IMPLEMENT_PERSISTENT(ScEngine, true)
 ScEngine::ScEngine(BaseGame *inGame) : BaseClass(inGame) {
 	_gameRef->LOG(0, "Initializing scripting engine...");
 
+	_scriptCache.setBudget(Common::ResourceCacheBase::getConfiguredBudget(SCRIPT_CACHE_BUDGET));
+
 	if (_compilerAvailable) {
 		_gameRef->LOG(0, "  Script compiler bound successfuly");
 	} else {
@@ -51,6 +56,7 @@ ScEngine::ScEngine(BaseGame *inGame) : BaseClass(inGame) {
 	}
 
 	_globals = new ScValue(_gameRef);
+	_varEpoch = 1;
 
 
 	// register 'Game' as global variable
@@ -67,17 +73,16 @@ ScEngine::ScEngine(BaseGame *inGame) : BaseClass(inGame) {
 		_globals->setProp("Math", &val);
 	}
 
-	// prepare script cache
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		_cachedScripts[i] = nullptr;
-	}
-
 	_currentScript = nullptr;
 
 	_isProfiling = false;
 	_profilingStartTime = 0;
+	_profilingInstructions = 0;
+	_profilingScriptTime = 0;
 
-	//EnableProfiling();
+	if (DebugMan.isDebugChannelEnabled(kWintermuteDebugScriptProfile)) {
+		enableProfiling();
+	}
 }
 
 
@@ -137,8 +142,10 @@ ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
 	byte *compBuffer;
 	uint32 compSize;
 
+	ScScript::TLinkTablePtr linkTable;
+
 	// get script from cache
-	compBuffer = getCompiledScript(filename, &compSize);
+	compBuffer = getCompiledScript(filename, &compSize, false, &linkTable);
 	if (!compBuffer) {
 		return nullptr;
 	}
@@ -153,7 +160,7 @@ ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
 #else
 	ScScript *script = new ScScript(_gameRef, this);
 #endif
-	bool ret = script->create(filename, compBuffer, compSize, owner);
+	bool ret = script->create(filename, compBuffer, compSize, owner, linkTable);
 	if (DID_FAIL(ret)) {
 		_gameRef->LOG(ret, "Error running script '%s'...", filename);
 		delete script;
@@ -178,15 +185,17 @@ ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
 
 
 //////////////////////////////////////////////////////////////////////////
-byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache) {
+byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache, ScScript::TLinkTablePtr *outLinkTable) {
 	// is script in cache?
 	if (!ignoreCache) {
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] && scumm_stricmp(_cachedScripts[i]->_filename.c_str(), filename) == 0) {
-				_cachedScripts[i]->_timestamp = g_system->getMillis();
-				*outSize = _cachedScripts[i]->_size;
-				return _cachedScripts[i]->_buffer;
+		CScCachedScript *cachedScript = _scriptCache.find(filename);
+		if (cachedScript) {
+			_scriptCache.touch(cachedScript);
+			*outSize = cachedScript->_size;
+			if (outLinkTable) {
+				*outLinkTable = cachedScript->_linkTable;
 			}
+			return cachedScript->_buffer;
 		}
 	}
 
@@ -222,25 +231,13 @@ byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ig
 	// add script to cache
 	CScCachedScript *cachedScript = new CScCachedScript(filename, compBuffer, compSize);
 	if (cachedScript) {
-		int index = 0;
-		uint32 minTime = g_system->getMillis();
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] == nullptr) {
-				index = i;
-				break;
-			} else if (_cachedScripts[i]->_timestamp <= minTime) {
-				minTime = _cachedScripts[i]->_timestamp;
-				index = i;
-			}
-		}
-
-		if (_cachedScripts[index] != nullptr) {
-			delete _cachedScripts[index];
-		}
-		_cachedScripts[index] = cachedScript;
+		_scriptCache.add(cachedScript);
 
 		ret = cachedScript->_buffer;
 		*outSize = cachedScript->_size;
+		if (outLinkTable) {
+			*outLinkTable = cachedScript->_linkTable;
+		}
 	}
 
 
@@ -324,6 +321,10 @@ bool ScEngine::tick() {
 
 
 	// execute scripts
+
+	const bool isProfiling = _isProfiling;
+	const uint32 profilingStart = isProfiling ? g_system->getMillis() : 0;
+
 	for (uint32 i = 0; i < _scripts.size(); i++) {
 
 		// skip paused scripts
@@ -331,35 +332,35 @@ bool ScEngine::tick() {
 			continue;
 		}
 
+		uint32 instructions = 0;
+
 		// time sliced script
 		if (_scripts[i]->_timeSlice > 0) {
 			uint32 startTime = g_system->getMillis();
 			while (_scripts[i]->_state == SCRIPT_RUNNING && g_system->getMillis() - startTime < _scripts[i]->_timeSlice) {
 				_currentScript = _scripts[i];
 				_scripts[i]->executeInstruction();
-			}
-			if (_isProfiling && _scripts[i]->_filename) {
-				addScriptTime(_scripts[i]->_filename, g_system->getMillis() - startTime);
+				instructions++;
 			}
 		}
 
 		// normal script
 		else {
-			uint32 startTime = 0;
-			bool isProfiling = _isProfiling;
-			if (isProfiling) {
-				startTime = g_system->getMillis();
-			}
-
 			while (_scripts[i]->_state == SCRIPT_RUNNING) {
 				_currentScript = _scripts[i];
 				_scripts[i]->executeInstruction();
-			}
-			if (isProfiling && _scripts[i]->_filename) {
-				addScriptTime(_scripts[i]->_filename, g_system->getMillis() - startTime);
+				instructions++;
 			}
 		}
 		_currentScript = nullptr;
+
+		if (isProfiling && _scripts[i]->_filename) {
+			addScriptInstructions(_scripts[i]->_filename, instructions);
+		}
+	}
+
+	if (isProfiling) {
+		_profilingScriptTime += g_system->getMillis() - profilingStart;
 	}
 
 	removeFinishedScripts();
@@ -454,16 +455,45 @@ int ScEngine::getNumScripts(int *running, int *waiting, int *persistent) {
 
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::emptyScriptCache() {
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		if (_cachedScripts[i]) {
-			delete _cachedScripts[i];
-			_cachedScripts[i] = nullptr;
-		}
-	}
+	_scriptCache.evictAll();
 	return STATUS_OK;
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+ScEngine::ScriptCache::~ScriptCache() {
+	evictAll();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScEngine::CScCachedScript *ScEngine::ScriptCache::find(const char *filename) {
+	ScriptMap::iterator it = _scripts.find(filename);
+	return it != _scripts.end() ? it->_value : nullptr;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::ScriptCache::add(CScCachedScript *script) {
+	// a script loaded again bypassing the cache replaces the cached one
+	CScCachedScript *oldScript = find(script->_filename.c_str());
+	if (oldScript) {
+		remove(oldScript);
+		evict(oldScript);
+	}
+
+	_scripts[script->_filename] = script;
+	Common::ResourceCache<CScCachedScript>::add(script, script->_size);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::ScriptCache::evict(CScCachedScript *script) {
+	_scripts.erase(script->_filename);
+	delete script;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::resetObject(BaseObject *Object) {
 	// terminate all scripts waiting for this object
@@ -553,18 +583,20 @@ bool ScEngine::isValidScript(ScScript *script) {
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::clearGlobals(bool includingNatives) {
 	_globals->CleanProps(includingNatives);
+	_varEpoch++;
 	return STATUS_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void ScEngine::addScriptTime(const char *filename, uint32 time) {
+void ScEngine::addScriptInstructions(const char *filename, uint32 instructions) {
 	if (!_isProfiling) {
 		return;
 	}
 
 	AnsiString fileName = filename;
 	fileName.toLowercase();
-	_scriptTimes[fileName] += time;
+	_scriptInstructions[fileName] += instructions;
+	_profilingInstructions += instructions;
 }
 
 
@@ -575,7 +607,10 @@ void ScEngine::enableProfiling() {
 	}
 
 	// destroy old data, if any
-	_scriptTimes.clear();
+	_scriptInstructions.clear();
+	_profilingInstructions = 0;
+	_profilingScriptTime = 0;
+	_scriptCache.resetStatistics();
 
 	_profilingStartTime = g_system->getMillis();
 	_isProfiling = true;
@@ -595,27 +630,39 @@ void ScEngine::disableProfiling() {
 
 //////////////////////////////////////////////////////////////////////////
 void ScEngine::dumpStats() {
-	error("DumpStats not ported to ScummVM yet");
-	/*  uint32 totalTime = g_system->getMillis() - _profilingStartTime;
+	uint32 totalTime = g_system->getMillis() - _profilingStartTime;
+	uint32 scriptTime = _profilingScriptTime;
 
-	    typedef std::vector <std::pair<uint32, std::string> > TimeVector;
-	    TimeVector times;
+	typedef Common::Array<ScriptCount> CountVector;
+	CountVector counts;
 
-	    ScriptTimes::iterator it;
-	    for (it = _scriptTimes.begin(); it != _scriptTimes.end(); ++it) {
-	        times.push_back(std::pair<uint32, std::string> (it->_value, it->_key));
-	    }
-	    std::sort(times.begin(), times.end());
+	for (ScriptInstructions::const_iterator it = _scriptInstructions.begin(); it != _scriptInstructions.end(); ++it) {
+		ScriptCount count = { it->_value, it->_key };
+		counts.push_back(count);
+	}
+	Common::sort(counts.begin(), counts.end(), scriptCountSortCB);
 
+	const Common::ResourceCacheBase::Statistics &cacheStats = _scriptCache.getStatistics();
 
-	    TimeVector::reverse_iterator tit;
+	_gameRef->LOG(0, "***** Script profiling information: *****");
+	_gameRef->LOG(0, "  %-40s %fs", "Total execution time", (float)totalTime / 1000);
+	_gameRef->LOG(0, "  %-40s %fs", "Time spent in scripts", (float)scriptTime / 1000);
+	_gameRef->LOG(0, "  %-40s %u (%u per second of script time)", "Instructions executed", _profilingInstructions,
+	              scriptTime ? (uint32)((uint64)_profilingInstructions * 1000 / scriptTime) : 0);
+	_gameRef->LOG(0, "  %-40s %u hits, %u misses, %u evictions, %u bytes", "Script cache", cacheStats.hits, cacheStats.misses,
+	              cacheStats.evictions, _scriptCache.getSize());
 
-	    _gameRef->LOG(0, "***** Script profiling information: *****");
-	    _gameRef->LOG(0, "  %-40s %fs", "Total execution time", (float)totalTime / 1000);
+	for (CountVector::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+		_gameRef->LOG(0, "  %-40s %u instructions (%f%%)", it->filename.c_str(), it->instructions,
+		              _profilingInstructions ? (float)it->instructions / (float)_profilingInstructions * 100 : 0.0f);
+	}
+}
 
-	    for (tit = times.rbegin(); tit != times.rend(); ++tit) {
-	        _gameRef->LOG(0, "  %-40s %fs (%f%%)", tit->second.c_str(), (float)tit->first / 1000, (float)tit->first / (float)totalTime * 100);
-	    }*/
+
+//////////////////////////////////////////////////////////////////////////
+bool ScEngine::scriptCountSortCB(const ScriptCount &c1, const ScriptCount &c2) {
+	// busiest first
+	return c1.instructions > c2.instructions;
 }
 
 } // End of namespace Wintermute
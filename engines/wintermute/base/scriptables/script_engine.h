@@ -32,11 +32,15 @@
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/base/base.h"
+#include "engines/wintermute/base/scriptables/script.h"
+#include "common/hash-str.h"
+#include "common/resourcecache.h"
 
 namespace Wintermute {
 
-#define MAX_CACHED_SCRIPTS 20
-class ScScript;
+// Memory kept for compiled scripts not running at the moment, unless set
+// through the resource cache config key
+#define SCRIPT_CACHE_BUDGET (1024 * 1024)
 class ScValue;
 class BaseObject;
 class BaseScriptHolder;
@@ -44,8 +48,7 @@ class ScEngine : public BaseClass {
 public:
 	class CScCachedScript {
 	public:
-		CScCachedScript(const char *filename, byte *buffer, uint32 size) {
-			_timestamp = g_system->getMillis();
+		CScCachedScript(const char *filename, byte *buffer, uint32 size) : _linkTable(new ScScript::TLinkTable()) {
 			_buffer = new byte[size];
 			if (_buffer) {
 				memcpy(_buffer, buffer, size);
@@ -60,10 +63,27 @@ public:
 			}
 		};
 
-		uint32 _timestamp;
 		byte *_buffer;
 		uint32 _size;
 		Common::String _filename;
+		ScScript::TLinkTablePtr _linkTable;
+	};
+
+	// The least recently used compiled scripts, within SCRIPT_CACHE_BUDGET bytes
+	class ScriptCache : public Common::ResourceCache<CScCachedScript> {
+	public:
+		ScriptCache() : Common::ResourceCache<CScCachedScript>(SCRIPT_CACHE_BUDGET) {}
+		virtual ~ScriptCache();
+
+		CScCachedScript *find(const char *filename);
+		void add(CScCachedScript *script);
+
+	protected:
+		virtual void evict(CScCachedScript *script);
+
+	private:
+		typedef Common::HashMap<Common::String, CScCachedScript *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ScriptMap;
+		ScriptMap _scripts;
 	};
 
 public:
@@ -79,12 +99,15 @@ public:
 	bool resetObject(BaseObject *Object);
 	bool resetScript(ScScript *script);
 	bool emptyScriptCache();
-	byte *getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache = false);
+	byte *getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache = false, ScScript::TLinkTablePtr *outLinkTable = nullptr);
 	DECLARE_PERSISTENT(ScEngine, BaseClass)
 	bool cleanup();
 	int getNumScripts(int *running = nullptr, int *waiting = nullptr, int *persistent = nullptr);
 	bool tick();
 	ScValue *_globals;
+	// Bumped whenever global variables are added or removed, which may
+	// change what a variable name resolves to in any running script
+	uint32 _varEpoch;
 	ScScript *runScript(const char *filename, BaseScriptHolder *owner = nullptr);
 	static const bool _compilerAvailable = false;
 
@@ -102,17 +125,29 @@ public:
 		return _isProfiling;
 	}
 
-	void addScriptTime(const char *filename, uint32 Time);
+	void addScriptInstructions(const char *filename, uint32 instructions);
 	void dumpStats();
 
 private:
 
-	CScCachedScript *_cachedScripts[MAX_CACHED_SCRIPTS];
+	ScriptCache _scriptCache;
+
 	bool _isProfiling;
 	uint32 _profilingStartTime;
-
-	typedef Common::HashMap<Common::String, uint32> ScriptTimes;
-	ScriptTimes _scriptTimes;
+	uint32 _profilingInstructions;
+	uint32 _profilingScriptTime;
+
+	// Scripts are only timed all together, as most of them run for much less
+	// than the millisecond resolution of the timer. Each one is weighted by
+	// the instructions it executed instead.
+	typedef Common::HashMap<Common::String, uint32> ScriptInstructions;
+	ScriptInstructions _scriptInstructions;
+
+	struct ScriptCount {
+		uint32 instructions;
+		Common::String filename;
+	};
+	static bool scriptCountSortCB(const ScriptCount &c1, const ScriptCount &c2);
 
 };
 
@@ -270,6 +270,17 @@ bool ScValue::propExists(const char *name) {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScValue::findProp(const char *name) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->findProp(name);
+	}
+	_valIter = _valObject.find(name);
+
+	return _valIter != _valObject.end() ? _valIter->_value : nullptr;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 void ScValue::deleteProps() {
 	_valIter = _valObject.begin();
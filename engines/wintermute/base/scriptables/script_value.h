@@ -53,6 +53,9 @@ public:
 	void setValue(ScValue *val);
 	bool _persistent;
 	bool propExists(const char *name);
+	// Like getProp(), but only looks at the properties stored in this value
+	// and returns nullptr if there is no such property
+	ScValue *findProp(const char *name);
 	void copy(ScValue *orig, bool copyWhole = false);
 	void setStringVal(const char *val);
 	TValType getType();
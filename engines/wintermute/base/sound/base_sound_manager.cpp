@@ -50,6 +50,7 @@ BaseSoundMgr::BaseSoundMgr(BaseGame *inGame) : BaseClass(inGame) {
 	_soundAvailable = false;
 	_volumeMaster = 255;
 	_volumeMasterPercent = 100;
+	_loadedCount = 0;
 }
 
 
@@ -104,16 +105,23 @@ BaseSoundBuffer *BaseSoundMgr::addSound(const Common::String &filename, Audio::M
 
 	BaseSoundBuffer *sound;
 
-	Common::String useFilename = filename;
-	useFilename.toLowercase();
-	// try to switch WAV to OGG file (if available)
-	if (useFilename.hasSuffix(".wav")) {
-		Common::String oggFilename = useFilename;
-		oggFilename.erase(oggFilename.size() - 4);
-		oggFilename = oggFilename + ".ogg";
-		if (BaseFileManager::getEngineInstance()->hasFile(oggFilename)) {
-			useFilename = oggFilename;
+	Common::String useFilename;
+	Common::StringMap::const_iterator it = _soundFilenames.find(filename);
+	if (it != _soundFilenames.end()) {
+		useFilename = it->_value;
+	} else {
+		useFilename = filename;
+		useFilename.toLowercase();
+		// try to switch WAV to OGG file (if available)
+		if (useFilename.hasSuffix(".wav")) {
+			Common::String oggFilename = useFilename;
+			oggFilename.erase(oggFilename.size() - 4);
+			oggFilename = oggFilename + ".ogg";
+			if (BaseFileManager::getEngineInstance()->hasFile(oggFilename)) {
+				useFilename = oggFilename;
+			}
 		}
+		_soundFilenames[filename] = useFilename;
 	}
 
 	sound = new BaseSoundBuffer(_gameRef);
@@ -137,6 +145,7 @@ BaseSoundBuffer *BaseSoundMgr::addSound(const Common::String &filename, Audio::M
 
 	// register sound
 	_sounds.push_back(sound);
+	_loadedCount++;
 
 	return sound;
 
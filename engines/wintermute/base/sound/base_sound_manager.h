@@ -33,6 +33,7 @@
 #include "engines/wintermute/base/base.h"
 #include "audio/mixer.h"
 #include "common/array.h"
+#include "common/hash-str.h"
 
 namespace Wintermute {
 class BaseSoundBuffer;
@@ -59,8 +60,13 @@ public:
 	virtual ~BaseSoundMgr();
 	Common::Array<BaseSoundBuffer *> _sounds;
 	void saveSettings();
+
+	uint32 _loadedCount; // Sounds loaded from a file
 private:
 	int32 _volumeMasterPercent; // Necessary to avoid round-offs.
+	// The file actually loaded for each requested sound file, so the check for
+	// an OGG replacing a WAV file is only done once per file
+	Common::StringMap _soundFilenames;
 	bool setMasterVolume(byte percent);
 };
 
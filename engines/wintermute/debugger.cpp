@@ -23,6 +23,7 @@
 #include "engines/wintermute/debugger.h"
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_file_manager.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/debugger/debugger_controller.h"
 #include "engines/wintermute/wintermute.h"
@@ -36,6 +37,7 @@ Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("render_stats", WRAP_METHOD(Console, Cmd_RenderStats));
 	registerCmd("help", WRAP_METHOD(Console, Cmd_Help));
 	// Actual (script) debugger commands
 	registerCmd(STEP_CMD, WRAP_METHOD(Console, Cmd_Step));
@@ -308,6 +310,32 @@ bool Console::Cmd_ShowFps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_RenderStats(int argc, const char **argv) {
+	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(BaseEngine::getRenderer());
+	if (!renderer) {
+		debugPrintf("No renderer\n");
+		return true;
+	}
+
+	if (argc == 2 && Common::String(argv[1]) == "reset") {
+		renderer->resetRenderStats();
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const BaseRenderOSystem::RenderStats &stats = renderer->getRenderStats();
+	debugPrintf("Frames drawn with dirty rects: %u\n", stats.frames);
+	if (stats.frames) {
+		debugPrintf("Per frame: %u tiles, %u px drawn, %u px blended\n",
+		            (uint32)(stats.redrawnTiles / stats.frames),
+		            (uint32)(stats.drawnPixels / stats.frames),
+		            (uint32)(stats.blendedPixels / stats.frames));
+	}
+	return true;
+}
+
 bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	if (argc != 3) {
 		debugPrintf("Usage: %s <file path> <output file name>\n", argv[0]);
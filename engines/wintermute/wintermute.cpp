@@ -39,6 +39,7 @@
 
 #include "engines/wintermute/base/sound/base_sound_manager.h"
 #include "engines/wintermute/base/base_file_manager.h"
+#include "engines/wintermute/base/base_surface_storage.h"
 #include "engines/wintermute/base/gfx/base_renderer.h"
 #include "engines/wintermute/base/scriptables/script_engine.h"
 #include "engines/wintermute/debugger/debugger_controller.h"
@@ -75,6 +76,7 @@ WintermuteEngine::WintermuteEngine(OSystem *syst, const WMEGameDescription *desc
 	DebugMan.addDebugChannel(kWintermuteDebugFileAccess, "file-access", "Non-critical problems like missing files");
 	DebugMan.addDebugChannel(kWintermuteDebugAudio, "audio", "audio-playback-related issues");
 	DebugMan.addDebugChannel(kWintermuteDebugGeneral, "general", "various issues not covered by any of the above");
+	DebugMan.addDebugChannel(kWintermuteDebugScriptProfile, "scriptprofile", "Script execution times, logged to enginelog when the game ends");
 
 	_game = nullptr;
 	_debugger = nullptr;
@@ -243,7 +245,12 @@ int WintermuteEngine::messageLoop() {
 			time = _system->getMillis();
 			diff = time - prevTime;
 			if (frameTime > diff) { // Avoid overflows
-				_system->delayMillis(frameTime - diff);
+				// Use the time to spare to decode images before they are needed
+				_game->_surfaceStorage->loadQueuedSurfaces(prevTime + frameTime);
+				diff = _system->getMillis() - prevTime;
+				if (frameTime > diff) {
+					_system->delayMillis(frameTime - diff);
+				}
 			}
 
 			// ***** flip
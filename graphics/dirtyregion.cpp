@@ -0,0 +1,188 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirtyregion.h"
+
+#include "common/util.h"
+
+namespace Graphics {
+
+static inline int32 rectArea(const Common::Rect &r) {
+	return (int32)r.width() * r.height();
+}
+
+/**
+ * The number of pixels drawn in addition to a and b when drawing their
+ * bounding box instead. Negative if they overlap more than the bounding box
+ * adds.
+ */
+static inline int32 mergeCost(const Common::Rect &a, const Common::Rect &b) {
+	Common::Rect bounds(a);
+	bounds.extend(b);
+	return rectArea(bounds) - rectArea(a) - rectArea(b);
+}
+
+DirtyRegion::DirtyRegion(uint maxRects) : _full(false), _maxRects(maxRects) {
+	assert(maxRects > 0);
+}
+
+void DirtyRegion::clear() {
+	_rects.clear();
+	_nearest.clear();
+	_full = false;
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	if (r.isEmpty())
+		return;
+
+	Common::Rect rect(r);
+
+	// Merge with the existing rectangles until nothing changes. The merged
+	// rectangle grows, so it must be checked against the others again.
+	// The costs of the last pass are those of the rectangle added.
+	bool merged;
+	do {
+		merged = false;
+		_costs.resize(_rects.size());
+		for (uint i = 0; i < _rects.size(); ++i) {
+			if (_rects[i].contains(rect))
+				return;
+
+			_costs[i] = mergeCost(_rects[i], rect);
+			if (_costs[i] <= 0) {
+				rect.extend(_rects[i]);
+				removeRect(i);
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+
+	pushRect(rect);
+
+	if (_rects.size() > _maxRects)
+		mergeCheapestPair();
+}
+
+uint32 DirtyRegion::getArea() const {
+	uint32 area = 0;
+	for (uint i = 0; i < _rects.size(); ++i)
+		area += rectArea(_rects[i]);
+	return area;
+}
+
+// Once the region is full, the cheapest neighbour of each rectangle is kept
+// up to date as rectangles come and go. Finding the cheapest pair then does
+// not need to look at all pairs again, for every rectangle added from then on.
+
+void DirtyRegion::pushRect(const Common::Rect &r) {
+	const uint index = _rects.size();
+	_rects.push_back(r);
+	if (!_full)
+		return;
+
+	Neighbour nearest;
+	nearest.index = 0;
+	nearest.cost = 0;
+	nearest.valid = false;
+	for (uint i = 0; i < index; ++i) {
+		const int32 cost = _costs[i];
+		if (!nearest.valid || cost < nearest.cost) {
+			nearest.index = i;
+			nearest.cost = cost;
+			nearest.valid = true;
+		}
+		if (_nearest[i].valid && cost < _nearest[i].cost) {
+			_nearest[i].index = index;
+			_nearest[i].cost = cost;
+		}
+	}
+	_nearest.push_back(nearest);
+}
+
+void DirtyRegion::removeRect(uint index) {
+	// The order does not matter, so the last rectangle takes its place
+	const uint last = _rects.size() - 1;
+	_rects[index] = _rects[last];
+	_rects.pop_back();
+	if (!_full)
+		return;
+
+	_nearest[index] = _nearest[last];
+	_nearest.pop_back();
+
+	for (uint i = 0; i < _nearest.size(); ++i) {
+		if (_nearest[i].index == index)
+			_nearest[i].valid = false;
+		else if (_nearest[i].index == last)
+			_nearest[i].index = index;
+	}
+}
+
+void DirtyRegion::updateNearest(uint index) {
+	Neighbour &nearest = _nearest[index];
+	nearest.valid = false;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (i == index)
+			continue;
+
+		const int32 cost = mergeCost(_rects[index], _rects[i]);
+		if (!nearest.valid || cost < nearest.cost) {
+			nearest.index = i;
+			nearest.cost = cost;
+			nearest.valid = true;
+		}
+	}
+}
+
+void DirtyRegion::mergeCheapestPair() {
+	if (!_full) {
+		Neighbour unknown;
+		unknown.index = 0;
+		unknown.cost = 0;
+		unknown.valid = false;
+		_nearest.resize(_rects.size());
+		for (uint i = 0; i < _nearest.size(); ++i)
+			_nearest[i] = unknown;
+		_full = true;
+	}
+
+	uint best = 0;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (!_nearest[i].valid)
+			updateNearest(i);
+		if (_nearest[i].cost < _nearest[best].cost)
+			best = i;
+	}
+
+	// The merged rectangle may cover others now, so add it again
+	const uint other = _nearest[best].index;
+	Common::Rect rect(_rects[best]);
+	rect.extend(_rects[other]);
+	// Removing the higher index first leaves the lower one in place
+	removeRect(MAX(best, other));
+	removeRect(MIN(best, other));
+	addRect(rect);
+}
+
+} // End of namespace Graphics
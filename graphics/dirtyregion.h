@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTYREGION_H
+#define GRAPHICS_DIRTYREGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * Set of rectangles which need to be redrawn.
+ *
+ * Rectangles are merged whenever drawing their bounding box is not more
+ * work than drawing both of them, e.g. when they overlap a lot or are
+ * adjacent. When there are more rectangles than allowed, the two whose
+ * bounding box adds the least area are merged, so the region only grows
+ * as much as needed, instead of covering the whole screen.
+ */
+class DirtyRegion {
+public:
+	/**
+	 * @param maxRects	the maximum number of rectangles kept apart
+	 */
+	DirtyRegion(uint maxRects = 32);
+
+	/** Add a rectangle to the region. Empty rectangles are ignored. */
+	void addRect(const Common::Rect &r);
+
+	/** Remove all rectangles. */
+	void clear();
+
+	/** @return true if nothing is dirty */
+	bool empty() const { return _rects.empty(); }
+
+	/** @return the rectangles of the region, which may overlap */
+	const Common::Array<Common::Rect> &getRects() const { return _rects; }
+
+	/** @return the number of pixels in all rectangles of the region */
+	uint32 getArea() const;
+
+private:
+	/** The rectangle another one is cheapest to merge with */
+	struct Neighbour {
+		uint index;
+		int32 cost;
+		bool valid; ///< false if the rectangle was removed since
+	};
+
+	Common::Array<Common::Rect> _rects;
+	Common::Array<Neighbour> _nearest; ///< for each of _rects, once full
+	bool _full; ///< whether there were more rectangles than allowed yet
+	Common::Array<int32> _costs; ///< of merging the rectangle being added
+	uint _maxRects;
+
+	/** Add a rectangle whose merge costs are in _costs */
+	void pushRect(const Common::Rect &r);
+	void removeRect(uint index);
+	void updateNearest(uint index);
+
+	/** Merge the two rectangles which are cheapest to merge. */
+	void mergeCheapestPair();
+};
+
+} // End of namespace Graphics
+
+#endif
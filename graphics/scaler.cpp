@@ -20,11 +20,13 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 
 int gBitFormat = 565;
 
@@ -178,6 +180,90 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 	}
 }
 
+namespace {
+
+enum {
+	// Bands start at a multiple of this many rows, as some scalers, e.g.
+	// DotMatrix, use patterns repeating every few rows
+	kBandAlignment = 4,
+
+	// Fewer rows are not worth handing to another thread
+	kMinBandHeight = 16,
+
+	kMaxBands = 16
+};
+
+/** Job scaling one band of a rect. */
+struct ScaleBandJob : public Common::Job {
+	ScalerProc *scalerProc;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height;
+
+	void run() { scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height); }
+};
+
+/** @return false for scalers which keep state in static memory */
+bool isReentrant(ScalerProc *scalerProc) {
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembler versions store their locals in the data segment
+	if (scalerProc == HQ2x || scalerProc == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+} // End of anonymous namespace
+
+void scaleInBands(ScalerProc *scalerProc, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+					uint8 *dstPtr, uint32 dstPitch, int width, int height, int bands) {
+	Common::ThreadPool &pool = Common::ThreadPool::instance();
+
+	// The calling thread scales a band, too
+	if (!isReentrant(scalerProc))
+		bands = 1;
+	else if (bands <= 0)
+		bands = pool.getThreadCount() + 1;
+	bands = MIN<int>(MIN<int>(bands, kMaxBands), height / kMinBandHeight);
+
+	if (bands <= 1) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	int bandHeight = (height + bands - 1) / bands;
+	bandHeight = (bandHeight + kBandAlignment - 1) & ~(kBandAlignment - 1);
+
+	Common::Future<ScaleBandJob> futures[kMaxBands];
+	int numFutures = 0;
+
+	for (int y = 0; y < height; y += bandHeight) {
+		const int h = MIN(bandHeight, height - y);
+
+		ScaleBandJob *job = new ScaleBandJob;
+		job->scalerProc = scalerProc;
+		job->srcPtr = srcPtr + y * srcPitch;
+		job->srcPitch = srcPitch;
+		job->dstPtr = dstPtr + y * scaleFactor * dstPitch;
+		job->dstPitch = dstPitch;
+		job->width = width;
+		job->height = h;
+
+		// Scale the last band here, while the workers do the others
+		if (y + h == height) {
+			job->run();
+			delete job;
+		} else {
+			futures[numFutures++] = pool.async(job);
+		}
+	}
+
+	for (int i = 0; i < numFutures; ++i)
+		futures[i].get();
+}
+
 #ifdef USE_SCALERS
 
 
@@ -62,6 +62,20 @@ DECLARE_SCALER(HQ3x);
 
 #endif // #ifdef USE_SCALERS
 
+/**
+ * Scale a rect with the given scaler, split into horizontal bands which are
+ * scaled in parallel on the shared thread pool. The scalers read the rows
+ * around each band from the source, so the result is the same as calling
+ * scalerProc on the whole rect.
+ *
+ * @param scalerProc	the scaler
+ * @param scaleFactor	the integer factor the scaler scales by
+ * @param bands		the number of bands, or 0 to use one per thread. Small
+ *			rects are not split further than a few rows per band.
+ */
+extern void scaleInBands(ScalerProc *scalerProc, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+							uint8 *dstPtr, uint32 dstPitch, int width, int height, int bands = 0);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
@@ -83,9 +83,30 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+// Disable symbol overrides so that we can use the intrinsics headers
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/system.h"
+#include "common/util.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YUV_TO_RGB_SSE2
+#include <emmintrin.h>
+
+// AVX2 is selected at runtime, which needs support for target attributes
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define YUV_TO_RGB_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define YUV_TO_RGB_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -158,7 +179,13 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
+	// Without a backend, e.g. in the unit tests, there are no other threads
+	_lookupMutex = g_system ? g_system->createMutex() : 0;
+
+	// Use the fastest kernel available
+	_kernel = kKernelLookup;
+	if (!setKernel(kKernelAVX2) && !setKernel(kKernelSSE2))
+		setKernel(kKernelNEON);
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -180,16 +207,697 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
+
+	if (_lookupMutex)
+		g_system->deleteMutex(_lookupMutex);
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	// Videos may be converted on worker threads. The lookups are only freed
+	// with the manager, so they stay valid after unlocking.
+	if (_lookupMutex)
+		g_system->lockMutex(_lookupMutex);
+
+	YUVToRGBLookup *lookup = 0;
+	for (uint i = 0; i < _lookups.size() && !lookup; i++) {
+		if (_lookups[i]->getFormat() == format && _lookups[i]->getScale() == scale)
+			lookup = _lookups[i];
+	}
+
+	if (!lookup) {
+		lookup = new YUVToRGBLookup(format, scale);
+		_lookups.push_back(lookup);
+	}
+
+	if (_lookupMutex)
+		g_system->unlockMutex(_lookupMutex);
+
+	return lookup;
+}
+
+/**
+ * Describes how the vector kernels produce the pixels of a destination
+ * format. They compute the color components arithmetically instead of
+ * looking them up, with exactly the same results as the lookup tables.
+ */
+struct YUVToRGBRowFormat {
+	/** Range which Y plus the chroma term of a component is clipped to */
+	int16 low, high;
+	/** Whether the clipped value is stretched from [16, 235] to [0, 255] */
+	bool itu;
+
+	uint8 rLoss, gLoss, bLoss;
+	uint8 rShift, gShift, bShift;
+	uint32 alpha;
+
+	/**
+	 * Whether no component of 32 bit pixels crosses the middle, so the vector
+	 * kernels can put the pixels together from 16 bit halves. Shifts of 16
+	 * mean that a component is not part of that half.
+	 */
+	bool split;
+	uint8 rLowShift, gLowShift, bLowShift;
+	uint8 rHighShift, gHighShift, bHighShift;
+
+	/** The color tables of YUVToRGBManager, used for the last pixels of a row */
+	const int16 *colorTab;
+
+	YUVToRGBRowFormat(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale, const int16 *tab) {
+		itu = scale == YUVToRGBManager::kScaleITU;
+		low = itu ? 16 : 0;
+		high = itu ? 235 : 255;
+		rLoss = format.rLoss;
+		gLoss = format.gLoss;
+		bLoss = format.bLoss;
+		rShift = format.rShift;
+		gShift = format.gShift;
+		bShift = format.bShift;
+		alpha = format.RGBToColor(0, 0, 0);
+		colorTab = tab;
+
+		split = true;
+		splitShift(rShift, rLoss, rLowShift, rHighShift);
+		splitShift(gShift, gLoss, gLowShift, gHighShift);
+		splitShift(bShift, bLoss, bLowShift, bHighShift);
+	}
+
+private:
+	void splitShift(uint8 shift, uint8 loss, uint8 &lowShift, uint8 &highShift) {
+		if (shift >= 16) {
+			lowShift = 16;
+			highShift = shift - 16;
+		} else {
+			lowShift = shift;
+			highShift = 16;
+			if (shift + 8 - loss > 16)
+				split = false;
+		}
+	}
+};
+
+/**
+ * Convert one row of pixels. If subsampled is set, the chroma rows have half
+ * the width of the luminance rows and are shared by two rows of pixels, so
+ * these are converted together. The second row starts dstPitch and yPitch
+ * bytes after the first one.
+ */
+typedef void (*YUVToRGBRowProc)(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format);
+
+static inline int16 getYUVComponent(int value, const YUVToRGBRowFormat &format) {
+	value = CLIP<int>(value, format.low, format.high);
+	if (format.itu)
+		value = (value - 16) * 255 / 219;
+	return value;
+}
+
+template<typename PixelInt>
+static inline PixelInt getPixelScalar(int y, int crR, int crbG, int cbB, const YUVToRGBRowFormat &format) {
+	return format.alpha |
+		((getYUVComponent(y + crR, format) >> format.rLoss) << format.rShift) |
+		((getYUVComponent(y + crbG, format) >> format.gLoss) << format.gShift) |
+		((getYUVComponent(y + cbB, format) >> format.bLoss) << format.bShift);
+}
+
+template<typename PixelInt, bool subsampled>
+static void convertRowScalar(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	// The color table entries include offsets into the rgbToPix table
+	const int16 *Cr_r_tab = format.colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	PixelInt *out = (PixelInt *)dst;
+	PixelInt *out2 = (PixelInt *)(dst + dstPitch);
+	for (int i = 0; i < width; i++) {
+		const byte u = uSrc[subsampled ? i >> 1 : i];
+		const byte v = vSrc[subsampled ? i >> 1 : i];
+		const int crR = Cr_r_tab[v] - 256;
+		const int crbG = Cr_g_tab[v] + Cb_g_tab[u] - (1 * 768 + 256);
+		const int cbB = Cb_b_tab[u] - (2 * 768 + 256);
+
+		out[i] = getPixelScalar<PixelInt>(ySrc[i], crR, crbG, cbB, format);
+		if (subsampled)
+			out2[i] = getPixelScalar<PixelInt>(ySrc[yPitch + i], crR, crbG, cbB, format);
+	}
+}
+
+// The vector kernels compute the chroma terms of the color tables with
+// trunc(c * x) = sign(x) * ((2 * |x| * M) >> 16), and stretch the ITU range
+// with t * 255 / 219 = (2 * t * 38156) >> 16 after subtracting 16 from the
+// luminance. For the constants below, both are exact for all inputs.
+enum {
+	kITUStretch = 38156,
+
+	kCrR = 45901, // 0.419 / 0.299
+	kCrG = 23386, // 0.299 / 0.419
+	kCbG = 11283, // 0.114 / 0.331
+	kCbB = 58110  // 0.587 / 0.331
+};
+
+#ifdef YUV_TO_RGB_SSE2
+struct YUVToRGBConstantsSSE2 {
+	__m128i bias, high, alpha16, alpha32;
+	__m128i rLoss, gLoss, bLoss, rShift, gShift, bShift;
+	__m128i alphaLow, alphaHigh;
+	__m128i rLowShift, gLowShift, bLowShift, rHighShift, gHighShift, bHighShift;
+	bool itu, split;
+
+	YUVToRGBConstantsSSE2(const YUVToRGBRowFormat &format) {
+		bias = _mm_set1_epi16(format.low);
+		high = _mm_set1_epi16(format.high - format.low);
+		alpha16 = _mm_set1_epi16((int16)format.alpha);
+		alpha32 = _mm_set1_epi32(format.alpha);
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		alphaLow = _mm_set1_epi16((int16)format.alpha);
+		alphaHigh = _mm_set1_epi16((int16)(format.alpha >> 16));
+		rLowShift = _mm_cvtsi32_si128(format.rLowShift);
+		gLowShift = _mm_cvtsi32_si128(format.gLowShift);
+		bLowShift = _mm_cvtsi32_si128(format.bLowShift);
+		rHighShift = _mm_cvtsi32_si128(format.rHighShift);
+		gHighShift = _mm_cvtsi32_si128(format.gHighShift);
+		bHighShift = _mm_cvtsi32_si128(format.bHighShift);
+		itu = format.itu;
+		split = format.split;
+	}
+};
+
+static FORCEINLINE __m128i truncMulSSE2(__m128i x, __m128i sign, int16 factor) {
+	const __m128i product = _mm_mulhi_epu16(_mm_slli_epi16(x, 1), _mm_set1_epi16(factor));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+/** Compute the chroma terms of 8 pixels */
+static FORCEINLINE void getChromaTermsSSE2(const byte *uSrc, const byte *vSrc, __m128i &crR, __m128i &crbG, __m128i &cbB) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)uSrc), zero), bias);
+	const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)vSrc), zero), bias);
+
+	// Multiply the absolute values and restore the sign afterwards
+	const __m128i uSign = _mm_srai_epi16(u, 15);
+	const __m128i vSign = _mm_srai_epi16(v, 15);
+	const __m128i uAbs = _mm_sub_epi16(_mm_xor_si128(u, uSign), uSign);
+	const __m128i vAbs = _mm_sub_epi16(_mm_xor_si128(v, vSign), vSign);
+
+	crR = truncMulSSE2(vAbs, vSign, (int16)kCrR);
+	crbG = _mm_sub_epi16(zero, _mm_add_epi16(truncMulSSE2(vAbs, vSign, (int16)kCrG), truncMulSSE2(uAbs, uSign, (int16)kCbG)));
+	cbB = truncMulSSE2(uAbs, uSign, (int16)kCbB);
+}
+
+static FORCEINLINE __m128i getYUVComponentSSE2(__m128i y, __m128i chroma, const YUVToRGBConstantsSSE2 &c) {
+	// The luminance has already been biased, so clip to [0, high - low]
+	__m128i value = _mm_add_epi16(y, chroma);
+	value = _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), c.high);
+	if (c.itu)
+		value = _mm_mulhi_epu16(_mm_add_epi16(value, value), _mm_set1_epi16((int16)kITUStretch));
+	return value;
+}
+
+static FORCEINLINE void storePixelsSSE2(uint16 *dst, __m128i r, __m128i g, __m128i b, const YUVToRGBConstantsSSE2 &c) {
+	__m128i pixels = c.alpha16;
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(r, c.rLoss), c.rShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(g, c.gLoss), c.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, c.bLoss), c.bShift));
+	_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+static FORCEINLINE __m128i packPixelsSSE2(__m128i r, __m128i g, __m128i b, const YUVToRGBConstantsSSE2 &c) {
+	__m128i pixels = c.alpha32;
+	pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(r, c.rLoss), c.rShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(g, c.gLoss), c.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(b, c.bLoss), c.bShift));
+	return pixels;
+}
+
+static FORCEINLINE void storePixelsSSE2(uint32 *dst, __m128i r, __m128i g, __m128i b, const YUVToRGBConstantsSSE2 &c) {
+	if (c.split) {
+		// Shifting by 16 clears the component
+		r = _mm_srl_epi16(r, c.rLoss);
+		g = _mm_srl_epi16(g, c.gLoss);
+		b = _mm_srl_epi16(b, c.bLoss);
+		__m128i low = _mm_or_si128(c.alphaLow, _mm_sll_epi16(r, c.rLowShift));
+		low = _mm_or_si128(low, _mm_or_si128(_mm_sll_epi16(g, c.gLowShift), _mm_sll_epi16(b, c.bLowShift)));
+		__m128i high = _mm_or_si128(c.alphaHigh, _mm_sll_epi16(r, c.rHighShift));
+		high = _mm_or_si128(high, _mm_or_si128(_mm_sll_epi16(g, c.gHighShift), _mm_sll_epi16(b, c.bHighShift)));
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+		_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(low, high));
+		return;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	_mm_storeu_si128((__m128i *)dst, packPixelsSSE2(_mm_unpacklo_epi16(r, zero), _mm_unpacklo_epi16(g, zero), _mm_unpacklo_epi16(b, zero), c));
+	_mm_storeu_si128((__m128i *)(dst + 4), packPixelsSSE2(_mm_unpackhi_epi16(r, zero), _mm_unpackhi_epi16(g, zero), _mm_unpackhi_epi16(b, zero), c));
+}
+
+/** Convert 8 pixels */
+template<typename PixelInt>
+static FORCEINLINE void convertPixelsSSE2(PixelInt *dst, const byte *ySrc, __m128i crR, __m128i crbG, __m128i cbB, const YUVToRGBConstantsSSE2 &c) {
+	const __m128i y = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ySrc), _mm_setzero_si128()), c.bias);
+	storePixelsSSE2(dst, getYUVComponentSSE2(y, crR, c), getYUVComponentSSE2(y, crbG, c), getYUVComponentSSE2(y, cbB, c), c);
+}
+
+template<typename PixelInt, bool subsampled>
+static void convertRowSSE2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	const YUVToRGBConstantsSSE2 c(format);
+	PixelInt *out = (PixelInt *)dst;
+	PixelInt *out2 = (PixelInt *)(dst + dstPitch);
+	const byte *ySrc2 = ySrc + yPitch;
+	__m128i crR, crbG, cbB;
+
+	int i = 0;
+	if (subsampled) {
+		for (; i + 16 <= width; i += 16) {
+			getChromaTermsSSE2(uSrc + i / 2, vSrc + i / 2, crR, crbG, cbB);
+			const __m128i crR0 = _mm_unpacklo_epi16(crR, crR), crR1 = _mm_unpackhi_epi16(crR, crR);
+			const __m128i crbG0 = _mm_unpacklo_epi16(crbG, crbG), crbG1 = _mm_unpackhi_epi16(crbG, crbG);
+			const __m128i cbB0 = _mm_unpacklo_epi16(cbB, cbB), cbB1 = _mm_unpackhi_epi16(cbB, cbB);
+			convertPixelsSSE2(out + i, ySrc + i, crR0, crbG0, cbB0, c);
+			convertPixelsSSE2(out + i + 8, ySrc + i + 8, crR1, crbG1, cbB1, c);
+			convertPixelsSSE2(out2 + i, ySrc2 + i, crR0, crbG0, cbB0, c);
+			convertPixelsSSE2(out2 + i + 8, ySrc2 + i + 8, crR1, crbG1, cbB1, c);
+		}
+	} else {
+		for (; i + 8 <= width; i += 8) {
+			getChromaTermsSSE2(uSrc + i, vSrc + i, crR, crbG, cbB);
+			convertPixelsSSE2(out + i, ySrc + i, crR, crbG, cbB, c);
+		}
+	}
+
+	const int uvOffset = subsampled ? i / 2 : i;
+	convertRowScalar<PixelInt, subsampled>((byte *)(out + i), dstPitch, ySrc + i, yPitch, uSrc + uvOffset, vSrc + uvOffset, width - i, format);
+}
+#endif
+
+#ifdef YUV_TO_RGB_AVX2
+// These are compiled for AVX2 regardless of the compiler flags and are only
+// used if the CPU supports it.
+#define YUV_TO_RGB_AVX2_FUNC __attribute__((target("avx2")))
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i truncMulAVX2(__m256i x, __m256i sign, int16 factor) {
+	const __m256i product = _mm256_mulhi_epu16(_mm256_slli_epi16(x, 1), _mm256_set1_epi16(factor));
+	return _mm256_sub_epi16(_mm256_xor_si256(product, sign), sign);
+}
+
+/** Compute the chroma terms of 16 pixels, see getChromaTermsSSE2 */
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE void getChromaTermsAVX2(const byte *uSrc, const byte *vSrc, __m256i &crR, __m256i &crbG, __m256i &cbB) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)uSrc)), bias);
+	const __m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)vSrc)), bias);
+
+	const __m256i uSign = _mm256_srai_epi16(u, 15);
+	const __m256i vSign = _mm256_srai_epi16(v, 15);
+	const __m256i uAbs = _mm256_abs_epi16(u);
+	const __m256i vAbs = _mm256_abs_epi16(v);
+
+	crR = truncMulAVX2(vAbs, vSign, (int16)kCrR);
+	crbG = _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_add_epi16(truncMulAVX2(vAbs, vSign, (int16)kCrG), truncMulAVX2(uAbs, uSign, (int16)kCbG)));
+	cbB = truncMulAVX2(uAbs, uSign, (int16)kCbB);
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i getYUVComponentAVX2(__m256i y, __m256i chroma, const YUVToRGBRowFormat &format) {
+	// See getYUVComponentSSE2
+	__m256i value = _mm256_add_epi16(y, chroma);
+	value = _mm256_min_epi16(_mm256_max_epi16(value, _mm256_setzero_si256()), _mm256_set1_epi16(format.high - format.low));
+	if (format.itu)
+		value = _mm256_mulhi_epu16(_mm256_add_epi16(value, value), _mm256_set1_epi16((int16)kITUStretch));
+	return value;
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i packComponentAVX2(__m256i value, uint8 loss, uint8 shift) {
+	return _mm256_sll_epi16(_mm256_srl_epi16(value, _mm_cvtsi32_si128(loss)), _mm_cvtsi32_si128(shift));
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE void storePixelsAVX2(uint16 *dst, __m256i r, __m256i g, __m256i b, const YUVToRGBRowFormat &format) {
+	__m256i pixels = _mm256_set1_epi16((int16)format.alpha);
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(r, format.rLoss, format.rShift));
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(g, format.gLoss, format.gShift));
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(b, format.bLoss, format.bShift));
+	_mm256_storeu_si256((__m256i *)dst, pixels);
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i packComponentAVX2(__m128i value, uint8 loss, uint8 shift) {
+	return _mm256_sll_epi32(_mm256_srl_epi32(_mm256_cvtepu16_epi32(value), _mm_cvtsi32_si128(loss)), _mm_cvtsi32_si128(shift));
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i packPixelsAVX2(__m128i r, __m128i g, __m128i b, const YUVToRGBRowFormat &format) {
+	__m256i pixels = _mm256_set1_epi32(format.alpha);
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(r, format.rLoss, format.rShift));
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(g, format.gLoss, format.gShift));
+	pixels = _mm256_or_si256(pixels, packComponentAVX2(b, format.bLoss, format.bShift));
+	return pixels;
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE __m256i packHalfAVX2(__m256i r, __m256i g, __m256i b, uint16 alpha, uint8 rShift, uint8 gShift, uint8 bShift) {
+	__m256i half = _mm256_or_si256(_mm256_set1_epi16((int16)alpha), _mm256_sll_epi16(r, _mm_cvtsi32_si128(rShift)));
+	return _mm256_or_si256(half, _mm256_or_si256(_mm256_sll_epi16(g, _mm_cvtsi32_si128(gShift)), _mm256_sll_epi16(b, _mm_cvtsi32_si128(bShift))));
+}
+
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE void storePixelsAVX2(uint32 *dst, __m256i r, __m256i g, __m256i b, const YUVToRGBRowFormat &format) {
+	if (format.split) {
+		// See storePixelsSSE2
+		r = _mm256_srl_epi16(r, _mm_cvtsi32_si128(format.rLoss));
+		g = _mm256_srl_epi16(g, _mm_cvtsi32_si128(format.gLoss));
+		b = _mm256_srl_epi16(b, _mm_cvtsi32_si128(format.bLoss));
+		const __m256i low = packHalfAVX2(r, g, b, format.alpha, format.rLowShift, format.gLowShift, format.bLowShift);
+		const __m256i high = packHalfAVX2(r, g, b, format.alpha >> 16, format.rHighShift, format.gHighShift, format.bHighShift);
+
+		// The unpacks work within the 128 bit lanes
+		const __m256i first = _mm256_unpacklo_epi16(low, high);
+		const __m256i second = _mm256_unpackhi_epi16(low, high);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 8), _mm256_permute2x128_si256(first, second, 0x31));
+		return;
+	}
+
+	_mm256_storeu_si256((__m256i *)dst, packPixelsAVX2(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), format));
+	_mm256_storeu_si256((__m256i *)(dst + 8), packPixelsAVX2(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), format));
+}
+
+/** Convert 16 pixels */
+template<typename PixelInt>
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE void convertPixelsAVX2(PixelInt *dst, const byte *ySrc, __m256i crR, __m256i crbG, __m256i cbB, const YUVToRGBRowFormat &format) {
+	const __m256i y = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)ySrc)), _mm256_set1_epi16(format.low));
+	storePixelsAVX2(dst, getYUVComponentAVX2(y, crR, format), getYUVComponentAVX2(y, crbG, format), getYUVComponentAVX2(y, cbB, format), format);
+}
+
+/** Duplicate each element, returning the first half in lo and the second one in hi */
+YUV_TO_RGB_AVX2_FUNC
+static FORCEINLINE void duplicateAVX2(__m256i value, __m256i &lo, __m256i &hi) {
+	// The unpacks work within the 128 bit lanes
+	const __m256i a = _mm256_unpacklo_epi16(value, value);
+	const __m256i b = _mm256_unpackhi_epi16(value, value);
+	lo = _mm256_permute2x128_si256(a, b, 0x20);
+	hi = _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+template<typename PixelInt, bool subsampled>
+YUV_TO_RGB_AVX2_FUNC
+static void convertRowAVX2(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	PixelInt *out = (PixelInt *)dst;
+	PixelInt *out2 = (PixelInt *)(dst + dstPitch);
+	const byte *ySrc2 = ySrc + yPitch;
+	__m256i crR, crbG, cbB;
+
+	int i = 0;
+	if (subsampled) {
+		__m256i crR0, crR1, crbG0, crbG1, cbB0, cbB1;
+		for (; i + 32 <= width; i += 32) {
+			getChromaTermsAVX2(uSrc + i / 2, vSrc + i / 2, crR, crbG, cbB);
+			duplicateAVX2(crR, crR0, crR1);
+			duplicateAVX2(crbG, crbG0, crbG1);
+			duplicateAVX2(cbB, cbB0, cbB1);
+			convertPixelsAVX2(out + i, ySrc + i, crR0, crbG0, cbB0, format);
+			convertPixelsAVX2(out + i + 16, ySrc + i + 16, crR1, crbG1, cbB1, format);
+			convertPixelsAVX2(out2 + i, ySrc2 + i, crR0, crbG0, cbB0, format);
+			convertPixelsAVX2(out2 + i + 16, ySrc2 + i + 16, crR1, crbG1, cbB1, format);
+		}
+	} else {
+		for (; i + 16 <= width; i += 16) {
+			getChromaTermsAVX2(uSrc + i, vSrc + i, crR, crbG, cbB);
+			convertPixelsAVX2(out + i, ySrc + i, crR, crbG, cbB, format);
+		}
+	}
+
+	const int uvOffset = subsampled ? i / 2 : i;
+	convertRowScalar<PixelInt, subsampled>((byte *)(out + i), dstPitch, ySrc + i, yPitch, uSrc + uvOffset, vSrc + uvOffset, width - i, format);
+}
+
+static bool cpuHasAVX2() {
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#ifdef YUV_TO_RGB_NEON
+static FORCEINLINE int16x8_t truncMulNEON(int16x8_t x, int16x8_t sign, uint16 factor) {
+	const uint16x8_t doubled = vshlq_n_u16(vreinterpretq_u16_s16(x), 1);
+	const uint16x8_t product = vcombine_u16(
+		vshrn_n_u32(vmull_n_u16(vget_low_u16(doubled), factor), 16),
+		vshrn_n_u32(vmull_n_u16(vget_high_u16(doubled), factor), 16));
+	return vsubq_s16(veorq_s16(vreinterpretq_s16_u16(product), sign), sign);
+}
+
+/** Compute the chroma terms of 8 pixels, see getChromaTermsSSE2 */
+static FORCEINLINE void getChromaTermsNEON(const byte *uSrc, const byte *vSrc, int16x8_t &crR, int16x8_t &crbG, int16x8_t &cbB) {
+	const int16x8_t bias = vdupq_n_s16(128);
+	const int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(uSrc))), bias);
+	const int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vSrc))), bias);
+
+	const int16x8_t uSign = vshrq_n_s16(u, 15);
+	const int16x8_t vSign = vshrq_n_s16(v, 15);
+	const int16x8_t uAbs = vabsq_s16(u);
+	const int16x8_t vAbs = vabsq_s16(v);
+
+	crR = truncMulNEON(vAbs, vSign, kCrR);
+	crbG = vnegq_s16(vaddq_s16(truncMulNEON(vAbs, vSign, kCrG), truncMulNEON(uAbs, uSign, kCbG)));
+	cbB = truncMulNEON(uAbs, uSign, kCbB);
+}
+
+static FORCEINLINE uint16x8_t getYUVComponentNEON(int16x8_t y, int16x8_t chroma, const YUVToRGBRowFormat &format) {
+	// See getYUVComponentSSE2
+	int16x8_t value = vaddq_s16(y, chroma);
+	value = vminq_s16(vmaxq_s16(value, vdupq_n_s16(0)), vdupq_n_s16(format.high - format.low));
+
+	uint16x8_t result = vreinterpretq_u16_s16(value);
+	if (format.itu) {
+		const uint16x8_t doubled = vaddq_u16(result, result);
+		result = vcombine_u16(
+			vshrn_n_u32(vmull_n_u16(vget_low_u16(doubled), kITUStretch), 16),
+			vshrn_n_u32(vmull_n_u16(vget_high_u16(doubled), kITUStretch), 16));
+	}
+	return result;
+}
+
+static FORCEINLINE uint16x8_t packComponentNEON(uint16x8_t value, uint8 loss, uint8 shift) {
+	// Shifting by a negative count shifts right
+	return vshlq_u16(vshlq_u16(value, vdupq_n_s16(-loss)), vdupq_n_s16(shift));
+}
+
+static FORCEINLINE void storePixelsNEON(uint16 *dst, uint16x8_t r, uint16x8_t g, uint16x8_t b, const YUVToRGBRowFormat &format) {
+	uint16x8_t pixels = vdupq_n_u16((uint16)format.alpha);
+	pixels = vorrq_u16(pixels, packComponentNEON(r, format.rLoss, format.rShift));
+	pixels = vorrq_u16(pixels, packComponentNEON(g, format.gLoss, format.gShift));
+	pixels = vorrq_u16(pixels, packComponentNEON(b, format.bLoss, format.bShift));
+	vst1q_u16(dst, pixels);
+}
+
+static FORCEINLINE uint32x4_t packComponentNEON(uint16x4_t value, uint8 loss, uint8 shift) {
+	return vshlq_u32(vshlq_u32(vmovl_u16(value), vdupq_n_s32(-loss)), vdupq_n_s32(shift));
+}
+
+static FORCEINLINE uint32x4_t packPixelsNEON(uint16x4_t r, uint16x4_t g, uint16x4_t b, const YUVToRGBRowFormat &format) {
+	uint32x4_t pixels = vdupq_n_u32(format.alpha);
+	pixels = vorrq_u32(pixels, packComponentNEON(r, format.rLoss, format.rShift));
+	pixels = vorrq_u32(pixels, packComponentNEON(g, format.gLoss, format.gShift));
+	pixels = vorrq_u32(pixels, packComponentNEON(b, format.bLoss, format.bShift));
+	return pixels;
+}
+
+static FORCEINLINE uint16x8_t packHalfNEON(uint16x8_t r, uint16x8_t g, uint16x8_t b, uint16 alpha, uint8 rShift, uint8 gShift, uint8 bShift) {
+	uint16x8_t half = vorrq_u16(vdupq_n_u16(alpha), vshlq_u16(r, vdupq_n_s16(rShift)));
+	return vorrq_u16(half, vorrq_u16(vshlq_u16(g, vdupq_n_s16(gShift)), vshlq_u16(b, vdupq_n_s16(bShift))));
+}
+
+static FORCEINLINE void storePixelsNEON(uint32 *dst, uint16x8_t r, uint16x8_t g, uint16x8_t b, const YUVToRGBRowFormat &format) {
+	if (format.split) {
+		// See storePixelsSSE2
+		r = vshlq_u16(r, vdupq_n_s16(-format.rLoss));
+		g = vshlq_u16(g, vdupq_n_s16(-format.gLoss));
+		b = vshlq_u16(b, vdupq_n_s16(-format.bLoss));
+		uint16x8x2_t halves;
+		halves.val[0] = packHalfNEON(r, g, b, format.alpha, format.rLowShift, format.gLowShift, format.bLowShift);
+		halves.val[1] = packHalfNEON(r, g, b, format.alpha >> 16, format.rHighShift, format.gHighShift, format.bHighShift);
+		vst2q_u16((uint16 *)dst, halves);
+		return;
+	}
+
+	vst1q_u32(dst, packPixelsNEON(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b), format));
+	vst1q_u32(dst + 4, packPixelsNEON(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b), format));
+}
+
+/** Convert 8 pixels */
+template<typename PixelInt>
+static FORCEINLINE void convertPixelsNEON(PixelInt *dst, const byte *ySrc, int16x8_t crR, int16x8_t crbG, int16x8_t cbB, const YUVToRGBRowFormat &format) {
+	const int16x8_t y = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc))), vdupq_n_s16(format.low));
+	storePixelsNEON(dst, getYUVComponentNEON(y, crR, format), getYUVComponentNEON(y, crbG, format), getYUVComponentNEON(y, cbB, format), format);
+}
+
+template<typename PixelInt, bool subsampled>
+static void convertRowNEON(byte *dst, int dstPitch, const byte *ySrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	PixelInt *out = (PixelInt *)dst;
+	PixelInt *out2 = (PixelInt *)(dst + dstPitch);
+	const byte *ySrc2 = ySrc + yPitch;
+	int16x8_t crR, crbG, cbB;
+
+	int i = 0;
+	if (subsampled) {
+		for (; i + 16 <= width; i += 16) {
+			getChromaTermsNEON(uSrc + i / 2, vSrc + i / 2, crR, crbG, cbB);
+			const int16x8x2_t r = vzipq_s16(crR, crR);
+			const int16x8x2_t g = vzipq_s16(crbG, crbG);
+			const int16x8x2_t b = vzipq_s16(cbB, cbB);
+			convertPixelsNEON(out + i, ySrc + i, r.val[0], g.val[0], b.val[0], format);
+			convertPixelsNEON(out + i + 8, ySrc + i + 8, r.val[1], g.val[1], b.val[1], format);
+			convertPixelsNEON(out2 + i, ySrc2 + i, r.val[0], g.val[0], b.val[0], format);
+			convertPixelsNEON(out2 + i + 8, ySrc2 + i + 8, r.val[1], g.val[1], b.val[1], format);
+		}
+	} else {
+		for (; i + 8 <= width; i += 8) {
+			getChromaTermsNEON(uSrc + i, vSrc + i, crR, crbG, cbB);
+			convertPixelsNEON(out + i, ySrc + i, crR, crbG, cbB, format);
+		}
+	}
+
+	const int uvOffset = subsampled ? i / 2 : i;
+	convertRowScalar<PixelInt, subsampled>((byte *)(out + i), dstPitch, ySrc + i, yPitch, uSrc + uvOffset, vSrc + uvOffset, width - i, format);
+}
+#endif
+
+static YUVToRGBRowProc getRowProc(YUVToRGBManager::Kernel kernel, int bytesPerPixel, bool subsampled) {
+	switch (kernel) {
+#ifdef YUV_TO_RGB_SSE2
+	case YUVToRGBManager::kKernelSSE2:
+		if (bytesPerPixel == 2)
+			return subsampled ? convertRowSSE2<uint16, true> : convertRowSSE2<uint16, false>;
+		return subsampled ? convertRowSSE2<uint32, true> : convertRowSSE2<uint32, false>;
+#endif
+#ifdef YUV_TO_RGB_AVX2
+	case YUVToRGBManager::kKernelAVX2:
+		if (!cpuHasAVX2())
+			return 0;
+		if (bytesPerPixel == 2)
+			return subsampled ? convertRowAVX2<uint16, true> : convertRowAVX2<uint16, false>;
+		return subsampled ? convertRowAVX2<uint32, true> : convertRowAVX2<uint32, false>;
+#endif
+#ifdef YUV_TO_RGB_NEON
+	case YUVToRGBManager::kKernelNEON:
+		if (bytesPerPixel == 2)
+			return subsampled ? convertRowNEON<uint16, true> : convertRowNEON<uint16, false>;
+		return subsampled ? convertRowNEON<uint32, true> : convertRowNEON<uint32, false>;
+#endif
+	default:
+		return 0;
+	}
+}
+
+bool YUVToRGBManager::setKernel(Kernel kernel) {
+	if (kernel != kKernelLookup && !getRowProc(kernel, 2, false))
+		return false;
+
+	_kernel = kernel;
+	return true;
+}
+
+static void convertYUV444ToRGBRows(YUVToRGBRowProc proc, const YUVToRGBRowFormat &format, byte *dstPtr, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h++) {
+		proc(dstPtr, 0, ySrc, 0, uSrc, vSrc, yWidth, format);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+static void convertYUV420ToRGBRows(YUVToRGBRowProc proc, const YUVToRGBRowFormat &format, byte *dstPtr, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h += 2) {
+		// Both rows share the chroma
+		proc(dstPtr, dstPitch, ySrc, yPitch, uSrc, vSrc, yWidth, format);
+
+		dstPtr += dstPitch * 2;
+		ySrc += yPitch * 2;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+enum {
+	/** Number of pixels of which the 410 chroma is interpolated at a time */
+	kRowChunkSize = 256
+};
+
+/**
+ * Bilinear interpolation of the chroma for one row of pixels, with the same
+ * results as convertYUV410ToRGB.
+ */
+static void interpolateYUV410Chroma(byte *dst, const byte *src, int width, int uvPitch, int yDiff) {
+	int x = 0;
+
+#ifdef YUV_TO_RGB_SSE2
+	// 32 pixels from 9 chroma samples at a time
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i topWeight = _mm_set1_epi16(4 - yDiff);
+	const __m128i bottomWeight = _mm_set1_epi16(yDiff);
+	const __m128i leftWeight = _mm_setr_epi16(4, 3, 2, 1, 4, 3, 2, 1);
+	const __m128i rightWeight = _mm_setr_epi16(0, 1, 2, 3, 0, 1, 2, 3);
+
+	for (; x + 32 <= width; x += 32) {
+		const byte *quad = src + (x >> 2);
+		const __m128i left = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)quad), zero), topWeight),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(quad + uvPitch)), zero), bottomWeight));
+		const __m128i right = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(quad + 1)), zero), topWeight),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(quad + uvPitch + 1)), zero), bottomWeight));
+
+		// Repeat each sample four times
+		const __m128i leftLo = _mm_unpacklo_epi16(left, left), leftHi = _mm_unpackhi_epi16(left, left);
+		const __m128i rightLo = _mm_unpacklo_epi16(right, right), rightHi = _mm_unpackhi_epi16(right, right);
+		__m128i out[4];
+		out[0] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi32(leftLo, leftLo), leftWeight), _mm_mullo_epi16(_mm_unpacklo_epi32(rightLo, rightLo), rightWeight));
+		out[1] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi32(leftLo, leftLo), leftWeight), _mm_mullo_epi16(_mm_unpackhi_epi32(rightLo, rightLo), rightWeight));
+		out[2] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi32(leftHi, leftHi), leftWeight), _mm_mullo_epi16(_mm_unpacklo_epi32(rightHi, rightHi), rightWeight));
+		out[3] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi32(leftHi, leftHi), leftWeight), _mm_mullo_epi16(_mm_unpackhi_epi32(rightHi, rightHi), rightWeight));
+
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(_mm_srli_epi16(out[0], 4), _mm_srli_epi16(out[1], 4)));
+		_mm_storeu_si128((__m128i *)(dst + x + 16), _mm_packus_epi16(_mm_srli_epi16(out[2], 4), _mm_srli_epi16(out[3], 4)));
+	}
+#endif
+
+	for (; x < width; x += 4) {
+		const byte *quad = src + (x >> 2);
+		const int left = quad[0] * (4 - yDiff) + quad[uvPitch] * yDiff;
+		const int right = quad[1] * (4 - yDiff) + quad[uvPitch + 1] * yDiff;
+
+		for (int xDiff = 0; xDiff < 4; xDiff++)
+			dst[x + xDiff] = (left * (4 - xDiff) + right * xDiff) >> 4;
+	}
+}
+
+static void convertYUV410ToRGBRows(YUVToRGBRowProc proc, const YUVToRGBRowFormat &format, byte *dstPtr, int dstPitch, int bytesPerPixel, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	byte uRow[kRowChunkSize], vRow[kRowChunkSize];
+
+	for (int y = 0; y < yHeight; y++) {
+		const int yDiff = y & 3;
+		const int index = (y >> 2) * uvPitch;
+
+		for (int x = 0; x < yWidth; x += kRowChunkSize) {
+			const int width = MIN<int>(kRowChunkSize, yWidth - x);
+			interpolateYUV410Chroma(uRow, uSrc + index + (x >> 2), width, uvPitch, yDiff);
+			interpolateYUV410Chroma(vRow, vSrc + index + (x >> 2), width, uvPitch, yDiff);
+
+			proc(dstPtr + x * bytesPerPixel, 0, ySrc + x, 0, uRow, vRow, width, format);
+		}
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
 }
 
 #define PUT_PIXEL(s, d) \
@@ -233,6 +941,12 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	if (_kernel != kKernelLookup) {
+		convertYUV444ToRGBRows(getRowProc(_kernel, dst->format.bytesPerPixel, false), YUVToRGBRowFormat(dst->format, scale, _colorTab),
+				(byte *)dst->getPixels(), dst->pitch, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -289,6 +1003,12 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	if (_kernel != kKernelLookup) {
+		convertYUV420ToRGBRows(getRowProc(_kernel, dst->format.bytesPerPixel, true), YUVToRGBRowFormat(dst->format, scale, _colorTab),
+				(byte *)dst->getPixels(), dst->pitch, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -374,6 +1094,12 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	if (_kernel != kKernelLookup) {
+		convertYUV410ToRGBRows(getRowProc(_kernel, dst->format.bytesPerPixel, false), YUVToRGBRowFormat(dst->format, scale, _colorTab),
+				(byte *)dst->getPixels(), dst->pitch, dst->format.bytesPerPixel, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -39,6 +39,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -54,6 +56,26 @@ public:
 		kScaleITU   /** Luminance values range from [16, 235], the range from ITU-R BT.601 */
 	};
 
+	/** The implementations of the conversion */
+	enum Kernel {
+		kKernelLookup, /** Per pixel table lookups, available everywhere */
+		kKernelSSE2,   /** 8 pixels at a time with SSE2 */
+		kKernelAVX2,   /** 16 pixels at a time with AVX2 */
+		kKernelNEON    /** 8 pixels at a time with NEON */
+	};
+
+	/** @return the implementation used for the conversion */
+	Kernel getKernel() const { return _kernel; }
+
+	/**
+	 * Change the implementation used for the conversion. By default, the
+	 * fastest one supported by the build and the CPU is used. All produce
+	 * exactly the same output.
+	 *
+	 * @return false if the kernel is not supported
+	 */
+	bool setKernel(Kernel kernel);
+
 	/**
 	 * Convert a YUV444 image to an RGB surface
 	 *
@@ -112,8 +134,11 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	/** One lookup per destination format and scale, guarded by _lookupMutex */
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::MutexRef _lookupMutex;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+	Kernel _kernel;
 };
 
 } // End of namespace Graphics
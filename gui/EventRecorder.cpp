@@ -20,18 +20,27 @@
  *
  */
 
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_clock
 
 #include "gui/EventRecorder.h"
 
 #ifdef ENABLE_EVENTRECORDER
 
+#include <time.h>
+#if defined(POSIX)
+#include <sys/resource.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/mixer/sdl/sdl-mixer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/md5.h"
 #include "gui/gui-manager.h"
@@ -50,6 +59,27 @@ namespace GUI {
 const int kMaxRecordsNames = 0x64;
 const int kDefaultScreenshotPeriod = 60000;
 
+#ifndef SDL_BACKEND
+// The mixer is run like NullSdlMixerManager runs it: 512 samples at
+// 22050 Hz every tenth time the recorder updates it
+const uint32 kFakeMixerRate = 22050;
+const uint32 kFakeMixerPeriod = 10;
+const uint32 kFakeMixerBufferSize = 2048;
+#endif
+
+/** Get a real time in milliseconds, also while the recorder fakes getMillis() */
+static uint32 getWallMillis() {
+#if defined(POSIX) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#elif defined(SDL_BACKEND)
+	return SDL_GetTicks();
+#else
+	return (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC);
+#endif
+}
+
 uint32 readTime(Common::ReadStream *inFile) {
 	uint32 d = inFile->readByte();
 	if (d == 0xff) {
@@ -72,7 +102,14 @@ void writeTime(Common::WriteStream *outFile, uint32 d) {
 EventRecorder::EventRecorder() {
 	_timerManager = NULL;
 	_recordMode = kPassthrough;
+#ifdef SDL_BACKEND
 	_fakeMixerManager = NULL;
+	_realMixerManager = 0;
+#else
+	_fakeMixer = 0;
+	_fakeMixerCalls = 0;
+	_fakeMixerBuffer = 0;
+#endif
 	_initialized = false;
 	_needRedraw = false;
 	_fastPlayback = false;
@@ -82,12 +119,14 @@ EventRecorder::EventRecorder() {
 	_needcontinueGame = false;
 	_temporarySlot = 0;
 	_realSaveManager = 0;
-	_realMixerManager = 0;
 	_controlPanel = 0;
 	_lastMillis = 0;
 	_lastScreenshotTime = 0;
 	_screenshotPeriod = 0;
 	_playbackFile = 0;
+	_benchmark = false;
+	_benchmarkStartWallMillis = 0;
+	_benchmarkStartCpuMillis = 0;
 
 	DebugMan.addDebugChannel(kDebugLevelEventRec, "EventRec", "Event recorder debug level");
 }
@@ -106,10 +145,24 @@ void EventRecorder::deinit() {
 	_needRedraw = false;
 	_initialized = false;
 	_recordMode = kPassthrough;
+#ifdef SDL_BACKEND
 	delete _fakeMixerManager;
 	_fakeMixerManager = NULL;
-	_controlPanel->close();
-	delete _controlPanel;
+#else
+	delete _fakeMixer;
+	_fakeMixer = 0;
+	delete[] _fakeMixerBuffer;
+	_fakeMixerBuffer = 0;
+#endif
+	if (_controlPanel) {
+		_controlPanel->close();
+		delete _controlPanel;
+		_controlPanel = 0;
+	}
+	if (_benchmark) {
+		reportBenchmark("success");
+		_benchmark = false;
+	}
 	debugC(1, kDebugLevelEventRec, "playback:action=stopplayback");
 	g_system->getEventManager()->getEventDispatcher()->unregisterSource(this);
 	_recordMode = kPassthrough;
@@ -154,15 +207,20 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 			_timerManager->handler();
 		} else {
 			if (_nextEvent.type == Common::EVENT_RTL) {
+				if (_benchmark)
+					reportBenchmark("success");
 				error("playback:action=stopplayback");
 			} else {
 				uint32 seconds = _fakeTimer / 1000;
 				Common::String screenTime = Common::String::format("%.2d:%.2d:%.2d", seconds / 3600 % 24, seconds / 60 % 60, seconds % 60);
+				if (_benchmark)
+					reportBenchmark("desync");
 				error("playback:action=error reason=\"synchronization error\" time = %s", screenTime.c_str());
 			}
 		}
 		millis = _fakeTimer;
-		_controlPanel->setReplayedTime(_fakeTimer);
+		if (_controlPanel)
+			_controlPanel->setReplayedTime(_fakeTimer);
 		break;
 	case kRecorderPlaybackPause:
 		millis = _fakeTimer;
@@ -215,6 +273,9 @@ void EventRecorder::switchFastMode() {
 }
 
 void EventRecorder::togglePause() {
+	if (!_controlPanel)
+		return;
+
 	RecordMode oldState;
 	switch (_recordMode) {
 	case kRecorderPlayback:
@@ -261,16 +322,25 @@ Common::String EventRecorder::generateRecordFileName(const Common::String &targe
 }
 
 
-void EventRecorder::init(Common::String recordFileName, RecordMode mode) {
+void EventRecorder::init(Common::String recordFileName, RecordMode mode, bool benchmark) {
+#ifdef SDL_BACKEND
 	_fakeMixerManager = new NullSdlMixerManager();
 	_fakeMixerManager->init();
 	_fakeMixerManager->suspendAudio();
+#else
+	_fakeMixer = new Audio::MixerImpl(g_system, kFakeMixerRate);
+	_fakeMixer->setReady(true);
+	_fakeMixerCalls = 0;
+	_fakeMixerBuffer = new byte[kFakeMixerBufferSize];
+#endif
 	_fakeTimer = 0;
 	_lastMillis = g_system->getMillis();
 	_playbackFile = new Common::PlaybackFile();
 	_lastScreenshotTime = 0;
 	_recordMode = mode;
 	_needcontinueGame = false;
+	_benchmark = benchmark && (mode == kRecorderPlayback);
+	_fastPlayback = _benchmark;
 	if (ConfMan.hasKey("disable_display")) {
 		DebugMan.enableDebugChannel("EventRec");
 		gDebugLevel = 1;
@@ -288,7 +358,9 @@ void EventRecorder::init(Common::String recordFileName, RecordMode mode) {
 		error("playback:action=error reason=\"Record file loading error\"");
 		return;
 	}
-	if (_recordMode != kPassthrough) {
+	// The control panel is not drawn when benchmarking, as it would be
+	// accounted to the engine
+	if (_recordMode != kPassthrough && !_benchmark) {
 		_controlPanel = new GUI::OnScreenDialog(_recordMode == kRecorderRecord);
 	}
 	if (_recordMode == kRecorderPlayback) {
@@ -301,8 +373,36 @@ void EventRecorder::init(Common::String recordFileName, RecordMode mode) {
 
 	switchMixer();
 	switchTimerManagers();
-	_needRedraw = true;
+	_needRedraw = !_benchmark;
 	_initialized = true;
+
+	if (_benchmark) {
+		_benchmarkStartWallMillis = getWallMillis();
+		_benchmarkStartCpuMillis = (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC);
+	}
+}
+
+void EventRecorder::reportBenchmark(const char *result) {
+	const uint32 wallMillis = getWallMillis() - _benchmarkStartWallMillis;
+	const uint32 cpuMillis = (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC) - _benchmarkStartCpuMillis;
+
+	uint32 maxResidentKB = 0;
+#if defined(POSIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(MACOSX)
+		// Mac OS X reports bytes rather than KB
+		maxResidentKB = usage.ru_maxrss / 1024;
+#else
+		maxResidentKB = usage.ru_maxrss;
+#endif
+	}
+#endif
+
+	// Always printed, so scripts can collect the results of a whole corpus
+	debug("playback:action=benchmark filename=%s result=%s replayed_ms=%u wall_ms=%u cpu_ms=%u max_rss_kb=%u checked_screens=%d failed_screens=%d",
+		_playbackFile->getHeader().fileName.c_str(), result, _fakeTimer, wallMillis, cpuMillis, maxResidentKB,
+		_playbackFile->getCheckedScreenshots(), _playbackFile->getFailedScreenshots());
 }
 
 
@@ -317,7 +417,12 @@ bool EventRecorder::openRecordFile(const Common::String &fileName) {
 	bool result;
 	switch (_recordMode) {
 	case kRecorderRecord:
-		return _playbackFile->openWrite(fileName);
+		// Create the file through the real save manager, which reopens it
+		// to write the header when recording ends
+		_recordMode = kPassthrough;
+		result = _playbackFile->openWrite(fileName);
+		_recordMode = kRecorderRecord;
+		return result;
 	case kRecorderPlayback:
 		_recordMode = kPassthrough;
 		result = _playbackFile->openRead(fileName);
@@ -350,6 +455,7 @@ bool EventRecorder::checkGameHash(const ADGameDescription *gameDesc) {
 	return true;
 }
 
+#ifdef SDL_BACKEND
 void EventRecorder::registerMixerManager(SdlMixerManager *mixerManager) {
 	_realMixerManager = mixerManager;
 }
@@ -370,6 +476,20 @@ SdlMixerManager *EventRecorder::getMixerManager() {
 		return _fakeMixerManager;
 	}
 }
+#else
+void EventRecorder::switchMixer() {
+	// The fake mixer only exists while recording or playing back, and the
+	// backend does not run its own mixer then
+}
+
+Audio::Mixer *EventRecorder::getMixer(Audio::Mixer *realMixer) {
+	if (_recordMode == kPassthrough || !_fakeMixer) {
+		return realMixer;
+	} else {
+		return _fakeMixer;
+	}
+}
+#endif
 
 void EventRecorder::getConfigFromDomain(const Common::ConfigManager::Domain *domain) {
 	for (Common::ConfigManager::Domain::const_iterator entry = domain->begin(); entry!= domain->end(); ++entry) {
@@ -418,7 +538,11 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
 	if (_recordMode == kPassthrough) {
+#ifdef SDL_BACKEND
 		_timerManager = new SdlTimerManager();
+#else
+		_timerManager = new DefaultTimerManager();
+#endif
 	} else {
 		_timerManager = new DefaultTimerManager();
 	}
@@ -430,7 +554,13 @@ void EventRecorder::updateSubsystems() {
 	}
 	RecordMode oldRecordMode = _recordMode;
 	_recordMode = kPassthrough;
+#ifdef SDL_BACKEND
 	_fakeMixerManager->update();
+#else
+	if (++_fakeMixerCalls % kFakeMixerPeriod == 0) {
+		_fakeMixer->mixCallback(_fakeMixerBuffer, kFakeMixerBufferSize);
+	}
+#endif
 	_recordMode = oldRecordMode;
 }
 
@@ -557,7 +687,7 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
-    if ((_initialized) || (_needRedraw)) {
+    if (_controlPanel && ((_initialized) || (_needRedraw))) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
 		g_system->showOverlay();
@@ -571,7 +701,7 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
-    if ((_initialized) || (_needRedraw)) {
+    if (_controlPanel && ((_initialized) || (_needRedraw))) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
 	    g_system->hideOverlay();
@@ -612,10 +742,12 @@ void EventRecorder::setFileHeader() {
 	_playbackFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Common::String gameId = ConfMan.get("gameid");
@@ -37,15 +37,19 @@
 #include "common/array.h"
 #include "common/memstream.h"
 #include "backends/keymapper/keymapper.h"
-#include "backends/mixer/sdl/sdl-mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
-#include "backends/timer/sdl/sdl-timer.h"
+#include "backends/timer/default/default-timer.h"
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
-#include "backends/mixer/nullmixer/nullsdl-mixer.h"
 #include "backends/saves/default/default-saves.h"
+#ifdef SDL_BACKEND
+#include "backends/mixer/sdl/sdl-mixer.h"
+#include "backends/mixer/nullmixer/nullsdl-mixer.h"
+#else
+#include "audio/mixer_intern.h"
+#endif
 
 
 #define g_eventRec (GUI::EventRecorder::instance())
@@ -78,7 +82,13 @@ public:
 		kRecorderPlaybackPause = 3	/**< kRecordetPlaybackPause, interal state when user pauses the playback */
 	};
 
-	void init(Common::String recordFileName, RecordMode mode);
+	/**
+	 * Start recording or playing back.
+	 *
+	 * @param benchmark	play back as fast as possible, without the control
+	 *			panel, and report the time taken when done
+	 */
+	void init(Common::String recordFileName, RecordMode mode, bool benchmark = false);
 	void deinit();
 	bool processDelayMillis();
 	uint32 getRandomSeed(const Common::String &name);
@@ -143,12 +153,30 @@ public:
 		_needRedraw = redraw;
 	}
 
+#ifdef SDL_BACKEND
 	void registerMixerManager(SdlMixerManager *mixerManager);
-	void registerTimerManager(DefaultTimerManager *timerManager);
-
 	SdlMixerManager *getMixerManager();
+#else
+	/**
+	 * Get the mixer for backends without an SDL mixer manager. While
+	 * recording or playing back, this is a mixer which the recorder runs
+	 * like NullSdlMixerManager does, so recordings play back alike on all
+	 * backends.
+	 */
+	Audio::Mixer *getMixer(Audio::Mixer *realMixer);
+#endif
+
+	void registerTimerManager(DefaultTimerManager *timerManager);
 	DefaultTimerManager *getTimerManager();
 
+	/**
+	 * Is a recording being made or played back? The timers are then run by
+	 * the recorder, and must not be run by the backend.
+	 */
+	bool isActive() const {
+		return _recordMode != kPassthrough;
+	}
+
 	void deleteRecord(const Common::String& fileName);
 	bool checkForContinueGame();
 
@@ -165,7 +193,9 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -189,10 +219,16 @@ private:
 	Common::String _name;
 
 	Common::SaveFileManager *_realSaveManager;
-	SdlMixerManager *_realMixerManager;
 	DefaultTimerManager *_timerManager;
 	RecorderSaveFileManager _fakeSaveManager;
+#ifdef SDL_BACKEND
+	SdlMixerManager *_realMixerManager;
 	NullSdlMixerManager *_fakeMixerManager;
+#else
+	Audio::MixerImpl *_fakeMixer;
+	uint32 _fakeMixerCalls;
+	byte *_fakeMixerBuffer;
+#endif
 	GUI::OnScreenDialog *_controlPanel;
 	Common::RecorderEvent _nextEvent;
 
@@ -225,10 +261,15 @@ private:
 	void saveScreenShot();
 	void checkRecordedMD5();
 	void deleteTemporarySave();
+	void reportBenchmark(const char *result);
 	volatile RecordMode _recordMode;
 	Common::String _recordFileName;
 	bool _fastPlayback;
 	bool _needRedraw;
+
+	bool _benchmark;
+	uint32 _benchmarkStartWallMillis;
+	uint32 _benchmarkStartCpuMillis;
 };
 
 } // End of namespace GUI
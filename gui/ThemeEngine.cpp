@@ -2240,12 +2240,8 @@ bool ThemeEngine::themeConfigUsable(const Common::FSNode &node, Common::String &
 			// Open THEMERC from the ZIP file.
 			stream.open("THEMERC", *zipArchive);
 		}
-		// Delete the ZIP archive again. Note: This only works because
-		// stream.open() only uses ZipArchive::createReadStreamForMember,
-		// and that in turn happens to read all the data for a given
-		// archive member into a memory block. So there will be no dangling
-		// reference to zipArchive anywhere. This could change if we
-		// ever modify ZipArchive::createReadStreamForMember.
+		// Delete the ZIP archive again. Member streams keep their own
+		// reference to the archive data, so the stream stays valid.
 		delete zipArchive;
 	} else if (node.isDirectory()) {
 		Common::FSNode headerfile = node.getChild("THEMERC");
@@ -26,6 +26,7 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
+#include "common/timer.h"
 
 #ifndef DISABLE_MD5
 #include "common/md5.h"
@@ -78,6 +79,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("timers",			WRAP_METHOD(Debugger, cmdTimers));
 }
 
 Debugger::~Debugger() {
@@ -728,6 +731,23 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdTimers(int argc, const char **argv) {
+	const Common::TimerManager::TimerStatsList timers = g_system->getTimerManager()->getTimerStats();
+
+	if (timers.empty()) {
+		debugPrintf("No timer statistics available\n");
+		return true;
+	}
+
+	debugPrintf("%-24s %10s %8s %8s %8s\n", "Timer", "Interval", "Calls", "Max ms", "Late ms");
+	for (Common::TimerManager::TimerStatsList::const_iterator i = timers.begin(); i != timers.end(); ++i) {
+		debugPrintf("%-24s %10d %8u %8u %8u\n", i->id.c_str(), i->interval,
+				i->calls, i->maxDuration, i->maxLateness);
+	}
+	debugPrintf("Intervals are in microseconds\n");
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
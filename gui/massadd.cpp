@@ -20,12 +20,15 @@
  *
  */
 
+#include "base/plugins.h"
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/system.h"
 #include "common/taskbar.h"
+#include "common/threadpool.h"
 #include "common/translation.h"
 
 #include "gui/launcher.h"	// For addGameToConf()
@@ -48,7 +51,11 @@ enum {
 	// Upper bound (im milliseconds) we want to spend in handleTickle.
 	// Setting this low makes the GUI more responsive but also slows
 	// down the scanning.
-	kMaxScanTime = 50
+	kMaxScanTime = 50,
+
+	// Upper bound of directories waiting for detection jobs. Keeps the
+	// scan from listing the whole filesystem before detecting anything.
+	kMaxPendingDetections = 64
 };
 
 enum {
@@ -63,12 +70,18 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
+	_scanStartTime(g_system->getMillis()),
 	_okButton(0),
 	_dirProgressText(0),
 	_gameProgressText(0) {
 
 	StringArray l;
 
+	// Detect on the thread pool, unless only one engine plugin may be loaded
+	// at a time
+	_concurrentDetection = PluginMan.allowsConcurrentDetection() && Common::ThreadPool::instance().getThreadCount() > 0;
+	_detectionPass = new DetectionPass(_concurrentDetection);
+
 	// The dir we start our scan at
 	_scanStack.push(startDir);
 
@@ -132,6 +145,12 @@ struct GameDescLess {
 };
 
 
+MassAddDialog::~MassAddDialog() {
+	// Wait for the detection jobs before ending the pass
+	_pendingDetections.clear();
+	delete _detectionPass;
+}
+
 void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 #if defined(USE_TASKBAR)
 	// Remove progress bar and count from taskbar
@@ -171,99 +190,138 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	}
 }
 
+void MassAddDialog::DetectionJob::run() {
+	candidates = EngineMan.detectGames(files);
+}
+
+void MassAddDialog::addGames(const Common::String &dirPath, const GameList &candidates) {
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		GameDescriptor result = *cand;
+		Common::String path = dirPath;
+
+		// Remove trailing slashes
+		while (path != "/" && path.lastChar() == '/')
+			path.deleteLastChar();
+
+		// Check for existing config entries for this path/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			bool duplicate = false;
+			const StringArray &targets = _pathToTargets[path];
+			for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((*dom)["gameid"] == result["gameid"] &&
+				    (*dom)["platform"] == result["platform"] &&
+				    (*dom)["language"] == result["language"]) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				_oldGamesCount++;
+				break;	// Skip duplicates
+			}
+		}
+		result["path"] = path;
+		_games.push_back(result);
+
+		_list->append(result.description());
+	}
+
+	_dirsScanned++;
+
+#if defined(USE_TASKBAR)
+	g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+	g_system->getTaskbarManager()->setCount(_games.size());
+#endif
+}
+
 void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
+	if (_scanStack.empty() && _pendingDetections.empty())
 		return;	// We have finished scanning
 
 	uint32 t = g_system->getMillis();
 
 	// Perform a breadth-first scan of the filesystem.
 	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
+		// Don't let the scan run too far ahead of the detection
+		if (_pendingDetections.size() >= kMaxPendingDetections)
+			break;
+
 		Common::FSNode dir = _scanStack.pop();
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+		// With concurrent detection, list directly into the job, so the
+		// nodes it gets are not referenced anywhere else
+		DetectionJob *job = new DetectionJob(dir.getPath());
+		Common::FSList &files = job->files;
+		if (!DetectionMan.getChildren(dir, files)) {
+			delete job;
 			continue;
 		}
 
-		// Run the detector on the dir
-		GameList candidates(EngineMan.detectGames(files));
-
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			GameDescriptor result = *cand;
-			Common::String path = dir.getPath();
-
-			// Remove trailing slashes
-			while (path != "/" && path.lastChar() == '/')
-				path.deleteLastChar();
-
-			// Check for existing config entries for this path/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				bool duplicate = false;
-				const StringArray &targets = _pathToTargets[path];
-				for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((*dom)["gameid"] == result["gameid"] &&
-					    (*dom)["platform"] == result["platform"] &&
-					    (*dom)["language"] == result["language"]) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					break;	// Skip duplicates
-				}
-			}
-			result["path"] = path;
-			_games.push_back(result);
-
-			_list->append(result.description());
-		}
-
-
 		// Recurse into all subdirs
 		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
 			if (file->isDirectory()) {
-				_scanStack.push(*file);
+				// FSNodes must not be shared with the detection jobs, so
+				// create new ones for the subdirs
+				if (_concurrentDetection)
+					_scanStack.push(Common::FSNode(Common::String(file->getPath().c_str())));
+				else
+					_scanStack.push(*file);
 
 				_dirTotal++;
 			}
 		}
 
-		_dirsScanned++;
-
-#if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
-#endif
+		// Run the detector on the dir
+		if (_concurrentDetection) {
+			_pendingDetections.push(Common::ThreadPool::instance().async(job));
+		} else {
+			addGames(job->path, EngineMan.detectGames(files));
+			delete job;
+		}
 	}
 
+	// Add the results in the order the directories were scanned, so they
+	// don't depend on the timing of the jobs
+	while (!_pendingDetections.empty() && _pendingDetections.front().isReady()) {
+		const DetectionJob &job = _pendingDetections.front().get();
+		addGames(job.path, job.candidates);
+		_pendingDetections.pop();
+	}
 
 	// Update the dialog
 	Common::String buf;
+	const uint32 scanTime = g_system->getMillis() - _scanStartTime;
+	const int dirsPerSecond = scanTime ? (int)((uint64)_dirsScanned * 1000 / scanTime) : 0;
+
+	if (_scanStack.empty() && _pendingDetections.empty()) {
+		// Save the detection cache and free the listings
+		delete _detectionPass;
+		_detectionPass = 0;
+
+		debug(1, "MassAdd: Scanned %d directories in %d ms (%d per second) using %d threads", _dirsScanned,
+		      scanTime, dirsPerSecond, _concurrentDetection ? Common::ThreadPool::instance().getThreadCount() : 0);
 
-	if (_scanStack.empty()) {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
-		buf = _("Scan complete!");
+		buf = Common::String::format(_("Scan complete! Scanned %d directories (%d per second)."), _dirsScanned, dirsPerSecond);
 		_dirProgressText->setLabel(buf);
 
 		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games."), _games.size(), _oldGamesCount);
 		_gameProgressText->setLabel(buf);
 
 	} else {
-		buf = Common::String::format(_("Scanned %d directories ..."), _dirsScanned);
+		buf = Common::String::format(_("Scanned %d directories (%d per second) ..."), _dirsScanned, dirsPerSecond);
 		_dirProgressText->setLabel(buf);
 
 		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games ..."), _games.size(), _oldGamesCount);
@@ -26,8 +26,12 @@
 #include "gui/dialog.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
+#include "common/queue.h"
 #include "common/stack.h"
 #include "common/str.h"
+#include "common/threadpool.h"
+
+class DetectionPass;
 
 namespace GUI {
 
@@ -37,6 +41,7 @@ class MassAddDialog : public Dialog {
 	typedef Common::Array<Common::String> StringArray;
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog();
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
@@ -49,7 +54,25 @@ public:
 	}
 
 private:
+	/** Runs the detectors on a directory listing. */
+	struct DetectionJob : public Common::Job {
+		Common::String path;
+		Common::FSList files;
+		GameList candidates;
+
+		DetectionJob(const Common::String &p) : path(p) {}
+		void run();
+	};
+
+	/** Add the games detected in a directory. */
+	void addGames(const Common::String &dirPath, const GameList &candidates);
+
 	Common::Stack<Common::FSNode>  _scanStack;
+
+	/** Is the detection run on the thread pool? */
+	bool _concurrentDetection;
+	/** Detection jobs, in the order the directories were scanned. */
+	Common::Queue<Common::Future<DetectionJob> > _pendingDetections;
 	GameList _games;
 
 	/**
@@ -62,6 +85,10 @@ private:
 	int _dirsScanned;
 	int _oldGamesCount;
 	int _dirTotal;
+	uint32 _scanStartTime;
+
+	/** Keeps the detection cache of the whole scan, until it is complete. */
+	DetectionPass *_detectionPass;
 
 	Widget *_okButton;
 	StaticTextWidget *_dirProgressText;
@@ -0,0 +1,175 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kPairs = 1027
+	};
+
+	static void fillNoise(int16 *buf, int count, uint32 seed) {
+		for (int i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			buf[i] = (int16)(seed >> 16);
+		}
+		// Make sure the extremes are covered
+		buf[0] = -32768;
+		buf[1] = 32767;
+	}
+
+	void mixWithKernel(Audio::MixKernel kernel, int16 *out, const int16 *in, Audio::st_volume_t vol0, Audio::st_volume_t vol1) {
+		const Audio::MixKernel oldKernel = Audio::getMixKernel();
+		TS_ASSERT(Audio::setMixKernel(kernel));
+		Audio::mixStereoBlock(out, in, kPairs, vol0, vol1);
+		Audio::setMixKernel(oldKernel);
+	}
+
+	void compareKernel(Audio::MixKernel kernel) {
+		const Audio::MixKernel oldKernel = Audio::getMixKernel();
+		if (!Audio::setMixKernel(kernel))
+			return;
+		Audio::setMixKernel(oldKernel);
+
+		int16 in[kPairs * 2], mixRef[kPairs * 2], mix[kPairs * 2];
+		fillNoise(in, kPairs * 2, 1);
+
+		const Audio::st_volume_t volumes[][2] = {
+			{ 256, 256 }, { 0, 256 }, { 255, 1 }, { 128, 77 }
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(volumes); ++i) {
+			// Mix into non-silent output, so saturation is exercised
+			fillNoise(mixRef, kPairs * 2, 2);
+			memcpy(mix, mixRef, sizeof(mix));
+
+			mixWithKernel(Audio::kMixKernelScalar, mixRef, in, volumes[i][0], volumes[i][1]);
+			mixWithKernel(kernel, mix, in, volumes[i][0], volumes[i][1]);
+			TS_ASSERT_EQUALS(memcmp(mix, mixRef, sizeof(mix)), 0);
+		}
+	}
+
+	/**
+	 * Convert one second of a tone with the polyphase converter and return
+	 * the largest deviation of the output from the ideal tone at the output
+	 * rate. The start, where the converter fades in, is skipped.
+	 */
+	int toneError(int inRate, int outRate, Audio::PolyphaseFilterCache *cache) {
+		const double frequency = 2000.0, amplitude = 16000.0;
+
+		byte *tone = (byte *)malloc(inRate * 2);
+		for (int i = 0; i < inRate; ++i)
+			WRITE_LE_UINT16(tone + i * 2, (int16)floor(amplitude * sin(2 * M_PI * frequency * i / inRate) + 0.5));
+		Audio::AudioStream *s = Audio::makeRawStream(tone, inRate * 2, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, Audio::kRateConverterPolyphase, cache);
+
+		const int len = outRate * 9 / 10;
+		int16 *out = new int16[len * 2]();
+		TS_ASSERT_EQUALS(converter->flow(*s, out, len, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), len);
+
+		int maxError = 0;
+		for (int i = outRate / 100; i < len; ++i) {
+			const int expected = (int)floor(amplitude * sin(2 * M_PI * frequency * i / outRate) + 0.5);
+			TS_ASSERT_EQUALS(out[i * 2], out[i * 2 + 1]);
+			maxError = MAX(maxError, ABS(out[i * 2] - expected));
+		}
+
+		delete[] out;
+		delete converter;
+		delete s;
+		return maxError;
+	}
+
+public:
+	void test_mix_kernel_sse2() {
+		compareKernel(Audio::kMixKernelSSE2);
+	}
+
+	void test_mix_kernel_neon() {
+		compareKernel(Audio::kMixKernelNEON);
+	}
+
+	void test_copy_converter_reverse_stereo() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, false, true);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 11025, true, true);
+
+		int16 out[1000 * 2] = { 0 };
+		TS_ASSERT_EQUALS(converter->flow(*s, out, 1000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+		for (int i = 0; i < 1000; ++i) {
+			TS_ASSERT_EQUALS(out[i * 2 + 0], sine[i * 2 + 1]);
+			TS_ASSERT_EQUALS(out[i * 2 + 1], sine[i * 2 + 0]);
+		}
+
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_simple_converter_mono() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(22050, 1, &sine, false, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 11025, false);
+
+		// Ask for more data than available, to check the end of the stream
+		int16 *out = new int16[11025 * 2 + 200]();
+		TS_ASSERT_EQUALS(converter->flow(*s, out, 11025 + 100, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume / 2), 11025);
+		for (int i = 0; i < 11025; ++i) {
+			TS_ASSERT_EQUALS(out[i * 2 + 0], sine[i * 2 + 1]);
+			TS_ASSERT_EQUALS(out[i * 2 + 1], sine[i * 2 + 1] / 2);
+		}
+
+		delete[] out;
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_polyphase_converter_tone() {
+		Audio::PolyphaseFilterCache cache;
+		const int rates[][2] = {
+			{ 11025, 44100 }, { 22050, 48000 }, { 22254, 44100 }, { 48000, 22050 }
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(rates); ++i) {
+			// Within 0.25% of the amplitude
+			TS_ASSERT_LESS_THAN(toneError(rates[i][0], rates[i][1], &cache), 40);
+		}
+	}
+
+	void test_polyphase_converter_end() {
+		const int rates[][2] = {
+			{ 11025, 44100 }, { 44100, 22050 }, { 22050, 48000 }
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(rates); ++i) {
+			int16 *sine;
+			Audio::SeekableAudioStream *s = createSineStream<int16>(rates[i][0], 1, &sine, false, true);
+			Audio::RateConverter *converter = Audio::makeRateConverter(rates[i][0], rates[i][1], true, false, Audio::kRateConverterPolyphase);
+
+			// All of the input is converted, up to the last sample
+			int16 *out = new int16[rates[i][1] * 4]();
+			TS_ASSERT_EQUALS(converter->flow(*s, out, rates[i][1] * 2, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), rates[i][1]);
+			TS_ASSERT(s->endOfData());
+
+			delete[] out;
+			delete converter;
+			delete[] sine;
+			delete s;
+		}
+	}
+
+	void test_polyphase_filter_cache() {
+		Audio::PolyphaseFilterCache cache;
+		const Audio::PolyphaseFilter *filter = cache.getFilter(11025, 44100);
+		TS_ASSERT(filter);
+		TS_ASSERT_EQUALS(cache.getFilter(11025, 44100), filter);
+		TS_ASSERT_DIFFERS(cache.getFilter(22050, 44100), filter);
+		TS_ASSERT_DIFFERS(cache.getFilter(44100, 11025), filter);
+	}
+};
@@ -0,0 +1,88 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/fs/posix/mmapstream.h"
+#include "backends/fs/stdiostream.h"
+
+#include <stdio.h>
+
+class MmapStreamTestSuite : public CxxTest::TestSuite {
+	static byte pattern(uint32 pos) {
+		return (byte)(pos * 7 + (pos >> 8));
+	}
+
+	static void writeFile(const char *path, uint32 size) {
+		StdioStream *f = StdioStream::makeFromPath(path, true);
+		TS_ASSERT(f);
+		for (uint32 i = 0; i < size; ++i)
+			f->writeByte(pattern(i));
+		delete f;
+	}
+
+	static void checkReads(Common::SeekableReadStream *s, uint32 size) {
+		TS_ASSERT_EQUALS(s->size(), (int32)size);
+
+		// Seek around the file
+		TS_ASSERT(s->seek(size - 10));
+		TS_ASSERT_EQUALS(s->readByte(), pattern(size - 10));
+		TS_ASSERT(s->seek(-20, SEEK_END));
+		TS_ASSERT_EQUALS(s->pos(), (int32)size - 20);
+		TS_ASSERT_EQUALS(s->readByte(), pattern(size - 20));
+		TS_ASSERT(s->seek(5, SEEK_SET));
+		TS_ASSERT(s->seek(10, SEEK_CUR));
+		byte buf[8];
+		TS_ASSERT_EQUALS(s->read(buf, 4), 4u);
+		for (uint32 i = 0; i < 4; ++i)
+			TS_ASSERT_EQUALS(buf[i], pattern(15 + i));
+
+		// Reading past the end sets eos(), but is no error
+		TS_ASSERT(s->seek(size - 2));
+		TS_ASSERT_EQUALS(s->read(buf, 8), 2u);
+		TS_ASSERT_EQUALS(buf[1], pattern(size - 1));
+		TS_ASSERT(s->eos());
+		TS_ASSERT(!s->err());
+
+		// Seeking clears it again
+		TS_ASSERT(s->seek(0));
+		TS_ASSERT(!s->eos());
+		TS_ASSERT_EQUALS(s->readByte(), pattern(0));
+	}
+
+public:
+	void test_mapped_file() {
+		const char *path = "mmapstream_test.bin";
+		const uint32 size = MmapStream::kMinMappedSize + 123;
+		writeFile(path, size);
+
+		Common::SeekableReadStream *s = MmapStream::makeFromPath(path);
+		TS_ASSERT(s);
+		checkReads(s, size);
+
+		// The data is accessible in place
+		const byte *data = s->getRange(size - 100, 100);
+		TS_ASSERT(data);
+		TS_ASSERT_EQUALS(data[99], pattern(size - 1));
+		TS_ASSERT(!s->getRange(size - 1, 2));
+
+		delete s;
+		remove(path);
+	}
+
+	void test_small_file() {
+		const char *path = "mmapstream_test_small.bin";
+		const uint32 size = 1000;
+		writeFile(path, size);
+
+		// Small files are read through stdio
+		Common::SeekableReadStream *s = MmapStream::makeFromPath(path);
+		TS_ASSERT(s);
+		TS_ASSERT(!s->getRange(0, size));
+		checkReads(s, size);
+
+		delete s;
+		remove(path);
+	}
+
+	void test_missing_file() {
+		TS_ASSERT(!MmapStream::makeFromPath("mmapstream_test_missing.bin"));
+	}
+};
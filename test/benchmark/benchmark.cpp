@@ -0,0 +1,25 @@
+// The benchmarks print their results with stdio and read the clock
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <time.h>
+
+double BenchmarkTimer::now() {
+#if defined(POSIX) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+	// Processor time, which is close enough for single threaded code
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+void benchmarkReport(const char *suite, const char *name, double value, const char *unit) {
+	printf("\nBENCH %s %s %.3f %s", suite, name, value, unit);
+	fflush(stdout);
+}
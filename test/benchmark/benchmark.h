@@ -0,0 +1,32 @@
+#ifndef TEST_BENCHMARK_BENCHMARK_H
+#define TEST_BENCHMARK_BENCHMARK_H
+
+#include "common/scummsys.h"
+
+/**
+ * Measures the wall time between construction and elapsed(). Processor time
+ * would add up the time of all threads, so it would hide any speedup from
+ * worker threads.
+ */
+class BenchmarkTimer {
+	double _start;
+
+	/** @return a monotonic time in seconds */
+	static double now();
+
+public:
+	BenchmarkTimer() : _start(now()) {}
+
+	/** @return elapsed time in seconds */
+	double elapsed() const {
+		return now() - _start;
+	}
+};
+
+/**
+ * Print one benchmark result in a format which is easy to grep and parse:
+ *   BENCH <suite> <case> <value> <unit>
+ */
+void benchmarkReport(const char *suite, const char *name, double value, const char *unit);
+
+#endif
@@ -0,0 +1,70 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+
+#include "benchmark.h"
+
+#include "../../../engines/sci/avoidpath_scenes.h"
+#include "../../../common/threadsystem.h"
+
+using namespace Sci;
+
+class AvoidPathBenchmarkSuite : public CxxTest::TestSuite {
+	typedef AvoidPathScenes::PolygonSet PolygonSet;
+
+	enum {
+		kRuns = 20
+	};
+
+	/**
+	 * Find the paths between all pairs of the points kRuns times, each run
+	 * using the next of the polygon sets, like an actor walking through a
+	 * room does. @return calls per second
+	 */
+	static double run(const Common::Array<PolygonSet> &sets, const Common::Array<Common::Point> &points, AvoidPathCache *cache) {
+		uint32 calls = 0;
+		BenchmarkTimer timer;
+		for (uint run = 0; run < kRuns; run++) {
+			const PolygonSet &polygons = sets[run % sets.size()];
+			for (uint i = 0; i < points.size(); i++) {
+				for (uint j = 0; j < points.size(); j++) {
+					if (i == j)
+						continue;
+					findAvoidPath(polygons, points[i], points[j], AvoidPathScenes::kWidth, AvoidPathScenes::kHeight, 1, cache);
+					calls++;
+				}
+			}
+		}
+		return calls / timer.elapsed();
+	}
+
+	static void report(const char *name, const Common::Array<PolygonSet> &sets) {
+		const Common::Array<Common::Point> points = AvoidPathScenes::grid(6, 5);
+
+		const double uncached = run(sets, points, NULL);
+		AvoidPathCache cache;
+		const double cached = run(sets, points, &cache);
+
+		benchmarkReport("sci_avoidpath", Common::String::format("%s_uncached", name).c_str(), uncached, "calls/s");
+		benchmarkReport("sci_avoidpath", Common::String::format("%s_cached", name).c_str(), cached, "calls/s");
+		benchmarkReport("sci_avoidpath", Common::String::format("%s_speedup", name).c_str(), cached / uncached, "x");
+	}
+
+public:
+	void test_same_polygons() {
+		NullTestSystem system;
+		Common::Array<PolygonSet> sets;
+		sets.push_back(AvoidPathScenes::room());
+		report("same", sets);
+	}
+
+	void test_changing_polygons() {
+		NullTestSystem system;
+		const PolygonSet room = AvoidPathScenes::room();
+		Common::Array<PolygonSet> sets;
+		sets.push_back(room);
+		for (uint i = 0; i < room.size(); i++)
+			sets.push_back(AvoidPathScenes::without(room, i));
+		report("changing", sets);
+	}
+};
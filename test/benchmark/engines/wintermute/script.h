@@ -0,0 +1,90 @@
+#include <cxxtest/TestSuite.h>
+
+#include "benchmark.h"
+
+#include "../../../engines/wintermute/script_builder.h"
+#include "../../../common/threadsystem.h"
+
+using namespace Wintermute;
+
+class WintermuteScriptBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kIterations = 1000,
+		kRuns = 200
+	};
+
+	static void add(ScriptBuilder &code, const char *dst, const char *a, const char *b) {
+		code.opVar(II_PUSH_VAR, a);
+		code.opVar(II_PUSH_VAR, b);
+		code.op(II_ADD);
+		code.opVar(II_POP_VAR, dst);
+	}
+
+	/**
+	 * A loop calling a function with locals, which reads and writes script
+	 * and engine globals, like the event handlers of the games do:
+	 *
+	 *   global Frames; var Total = 0; var i = 0; var one = 1;
+	 *   while (i < kIterations) { step(); i = i + one; }
+	 *   function step() { var a = i; var b = Total; Total = a + b; Frames = Frames + one; }
+	 */
+	static const Common::Array<byte> &buildScript(ScriptBuilder &code) {
+		code.opVar(II_DEF_GLOB_VAR, "Frames");
+		code.op(II_PUSH_INT, 0);
+		code.opVar(II_POP_VAR, "Frames");
+		code.opVar(II_DEF_VAR, "Total");
+		code.op(II_PUSH_INT, 0);
+		code.opVar(II_POP_VAR, "Total");
+		code.opVar(II_DEF_VAR, "i");
+		code.op(II_PUSH_INT, 0);
+		code.opVar(II_POP_VAR, "i");
+		code.opVar(II_DEF_VAR, "one");
+		code.op(II_PUSH_INT, 1);
+		code.opVar(II_POP_VAR, "one");
+
+		const uint32 loop = code.here();
+		code.opVar(II_PUSH_VAR, "i");
+		code.op(II_PUSH_INT, kIterations);
+		code.op(II_CMP_L);
+		const uint32 exit = code.jump(II_JMP_FALSE);
+		const uint32 call = code.jump(II_CALL);
+		add(code, "i", "i", "one");
+		code.op(II_JMP, loop);
+		code.patch(exit, code.here());
+		code.op(II_RET);
+
+		code.patch(call, code.here());
+		code.op(II_SCOPE);
+		code.opVar(II_DEF_VAR, "a");
+		code.opVar(II_PUSH_VAR, "i");
+		code.opVar(II_POP_VAR, "a");
+		code.opVar(II_DEF_VAR, "b");
+		code.opVar(II_PUSH_VAR, "Total");
+		code.opVar(II_POP_VAR, "b");
+		add(code, "Total", "a", "b");
+		add(code, "Frames", "Frames", "one");
+		code.op(II_RET);
+
+		return code.build();
+	}
+
+public:
+	void test_script_runs() {
+		NullTestSystem system;
+		ScriptRunner runner;
+		ScriptBuilder builder;
+		const Common::Array<byte> &code = buildScript(builder);
+
+		uint32 instructions = 0;
+		BenchmarkTimer timer;
+		for (uint32 i = 0; i < kRuns; ++i) {
+			ScScript *script = runner.create(code);
+			instructions += runner.run(script);
+			delete script;
+		}
+		const double seconds = timer.elapsed();
+
+		benchmarkReport("wintermute_script", "scripts", kRuns / seconds, "runs/s");
+		benchmarkReport("wintermute_script", "instructions", instructions / seconds / 1000000, "Minstr/s");
+	}
+};
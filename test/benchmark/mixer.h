@@ -0,0 +1,143 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/str.h"
+#include "common/util.h"
+
+#include "benchmark.h"
+
+/**
+ * Endless audio stream repeating a short noise buffer, so the benchmark
+ * measures the rate conversion and mixing rather than decoding.
+ */
+class BenchmarkNoiseStream : public Audio::AudioStream {
+	enum {
+		kNoiseSize = 4096
+	};
+
+	int16 _noise[kNoiseSize];
+	int _pos;
+	bool _stereo;
+	int _rate;
+
+public:
+	BenchmarkNoiseStream(int rate, bool stereo) : _pos(0), _stereo(stereo), _rate(rate) {
+		uint32 seed = 1;
+		for (int i = 0; i < kNoiseSize; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_noise[i] = (int16)(seed >> 16) / 4;
+		}
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int left = numSamples; left > 0; ) {
+			const int n = MIN(left, kNoiseSize - _pos);
+			memcpy(buffer, _noise + _pos, n * sizeof(int16));
+			buffer += n;
+			left -= n;
+			_pos = (_pos + n) % kNoiseSize;
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+};
+
+class MixerBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kOutputRate = 44100,
+		kBufferPairs = 2048,
+		kSeconds = 5
+	};
+
+	Audio::PolyphaseFilterCache _filterCache;
+
+	/**
+	 * Mix the given number of channels like MixerImpl::mixCallback does and
+	 * report the throughput in output sample pairs per second and channel.
+	 */
+	void benchmarkMix(const char *name, int inRate, bool stereo, int channels, Audio::RateConverterType type) {
+		Audio::AudioStream **streams = new Audio::AudioStream *[channels];
+		Audio::RateConverter **converters = new Audio::RateConverter *[channels];
+		for (int i = 0; i < channels; ++i) {
+			streams[i] = new BenchmarkNoiseStream(inRate, stereo);
+			converters[i] = Audio::makeRateConverter(inRate, kOutputRate, stereo, false, type, &_filterCache);
+		}
+
+		int16 *buf = new int16[kBufferPairs * 2];
+		const uint32 totalPairs = kOutputRate * kSeconds;
+
+		BenchmarkTimer timer;
+		for (uint32 done = 0; done < totalPairs; done += kBufferPairs) {
+			memset(buf, 0, kBufferPairs * 2 * sizeof(int16));
+			for (int i = 0; i < channels; ++i)
+				converters[i]->flow(*streams[i], buf, kBufferPairs, 200, 180);
+		}
+		const double seconds = timer.elapsed();
+
+		const char *kernel = "scalar";
+		if (Audio::getMixKernel() == Audio::kMixKernelSSE2)
+			kernel = "sse2";
+		else if (Audio::getMixKernel() == Audio::kMixKernelNEON)
+			kernel = "neon";
+
+		Common::String caseName = Common::String::format("%s/%s/%dch", name, kernel, channels);
+		benchmarkReport("mixer", caseName.c_str(), seconds > 0 ? totalPairs * (double)channels / seconds : 0.0, "pairs/s");
+
+		delete[] buf;
+		for (int i = 0; i < channels; ++i) {
+			delete converters[i];
+			delete streams[i];
+		}
+		delete[] converters;
+		delete[] streams;
+	}
+
+	void benchmarkAllKernels(const char *name, int inRate, bool stereo, Audio::RateConverterType type = Audio::kRateConverterLinear) {
+		static const int channelCounts[] = { 1, 4, 16, 32 };
+		static const Audio::MixKernel kernels[] = { Audio::kMixKernelScalar, Audio::kMixKernelSSE2, Audio::kMixKernelNEON };
+
+		const Audio::MixKernel oldKernel = Audio::getMixKernel();
+		for (uint k = 0; k < ARRAYSIZE(kernels); ++k) {
+			if (!Audio::setMixKernel(kernels[k]))
+				continue;
+
+			for (uint c = 0; c < ARRAYSIZE(channelCounts); ++c)
+				benchmarkMix(name, inRate, stereo, channelCounts[c], type);
+		}
+		Audio::setMixKernel(oldKernel);
+	}
+
+public:
+	void test_copy_stereo() {
+		benchmarkAllKernels("copy-stereo", kOutputRate, true);
+	}
+
+	void test_copy_mono() {
+		benchmarkAllKernels("copy-mono", kOutputRate, false);
+	}
+
+	void test_simple_mono() {
+		benchmarkAllKernels("simple-mono", kOutputRate * 2, false);
+	}
+
+	void test_linear_mono() {
+		benchmarkAllKernels("linear-mono", 22050, false);
+	}
+
+	void test_linear_stereo() {
+		benchmarkAllKernels("linear-stereo", 11025, true);
+	}
+
+	void test_polyphase_mono() {
+		benchmarkAllKernels("polyphase-mono", 22050, false, Audio::kRateConverterPolyphase);
+	}
+
+	void test_polyphase_stereo() {
+		benchmarkAllKernels("polyphase-stereo", 11025, true, Audio::kRateConverterPolyphase);
+	}
+};
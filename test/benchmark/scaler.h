@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/str.h"
+#include "common/threadpool.h"
+#include "common/util.h"
+#include "graphics/scaler.h"
+
+#include "benchmark.h"
+
+#include "../common/threadsystem.h"
+
+class ScalerBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kBorder = 4,
+		kSrcPitch = (kWidth + 2 * kBorder) * 2,
+		kFrames = 50
+	};
+
+	uint8 *_src;
+
+	/** @return wall time per frame in milliseconds */
+	double timeFrames(ScalerProc *scalerProc, int scaleFactor, uint8 *dst, uint32 dstPitch, bool bands) {
+		const uint8 *src = _src + kBorder * kSrcPitch + kBorder * 2;
+
+		BenchmarkTimer timer;
+		for (int i = 0; i < kFrames; ++i) {
+			if (bands)
+				scaleInBands(scalerProc, scaleFactor, src, kSrcPitch, dst, dstPitch, kWidth, kHeight);
+			else
+				scalerProc(src, kSrcPitch, dst, dstPitch, kWidth, kHeight);
+		}
+		return timer.elapsed() * 1000 / kFrames;
+	}
+
+	/**
+	 * Scale a number of full screens and report the time per frame: once
+	 * with a single call of the scaler, once split into bands without
+	 * worker threads, which shows the overhead of the split, and once with
+	 * the bands spread over the workers of the thread pool.
+	 */
+	void benchmarkScaler(const char *name, ScalerProc *scalerProc, int scaleFactor) {
+		const uint32 dstPitch = kWidth * scaleFactor * 2;
+		uint8 *dst = new uint8[dstPitch * kHeight * scaleFactor];
+
+		const double serial = timeFrames(scalerProc, scaleFactor, dst, dstPitch, false);
+		benchmarkReport("scaler", Common::String::format("%s/serial", name).c_str(), serial, "ms/frame");
+
+		Common::ThreadPool::destroy();
+		{
+			NullTestSystem system;
+			Common::ThreadPool::instance();
+			const double banded = timeFrames(scalerProc, scaleFactor, dst, dstPitch, true);
+			benchmarkReport("scaler", Common::String::format("%s/bands-1", name).c_str(), banded, "ms/frame");
+			Common::ThreadPool::destroy();
+		}
+
+		if (ThreadTestSystem::isAvailable()) {
+			ThreadTestSystem system;
+			const uint threads = Common::ThreadPool::instance().getThreadCount() + 1;
+			const double parallel = timeFrames(scalerProc, scaleFactor, dst, dstPitch, true);
+			benchmarkReport("scaler", Common::String::format("%s/bands-%u", name, threads).c_str(), parallel, "ms/frame");
+			benchmarkReport("scaler", Common::String::format("%s/speedup-%u", name, threads).c_str(), serial / parallel, "x");
+			Common::ThreadPool::destroy();
+		}
+
+		delete[] dst;
+	}
+
+public:
+	void setUp() {
+		const uint size = kSrcPitch * (kHeight + 2 * kBorder);
+		_src = new uint8[size];
+		uint32 seed = 1;
+		for (uint i = 0; i < size; i += 2) {
+			seed = seed * 1103515245 + 12345;
+			WRITE_UINT16(_src + i, ((i / 32) & 1) ? (seed >> 16) : 0x07E0);
+		}
+
+		InitScalers(565);
+	}
+
+	void tearDown() {
+		DestroyScalers();
+		delete[] _src;
+	}
+
+	void test_scalers() {
+		benchmarkScaler("Normal1x", Normal1x, 1);
+#ifdef USE_SCALERS
+		benchmarkScaler("Normal2x", Normal2x, 2);
+		benchmarkScaler("Normal3x", Normal3x, 3);
+		benchmarkScaler("2xSaI", _2xSaI, 2);
+		benchmarkScaler("Super2xSaI", Super2xSaI, 2);
+		benchmarkScaler("SuperEagle", SuperEagle, 2);
+		benchmarkScaler("AdvMame2x", AdvMame2x, 2);
+		benchmarkScaler("AdvMame3x", AdvMame3x, 3);
+		benchmarkScaler("TV2x", TV2x, 2);
+		benchmarkScaler("DotMatrix", DotMatrix, 2);
+#ifdef USE_HQ_SCALERS
+		benchmarkScaler("HQ2x", HQ2x, 2);
+		benchmarkScaler("HQ3x", HQ3x, 3);
+#endif
+#endif
+	}
+};
@@ -0,0 +1,109 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+#include "common/util.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "benchmark.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 1280,
+		kHeight = 720,
+		kFrames = 100
+	};
+
+	enum Layout {
+		kLayout444,
+		kLayout420,
+		kLayout410
+	};
+
+	byte *_y, *_u, *_v;
+
+	/**
+	 * Convert a number of HD frames with the given kernel and report the
+	 * throughput in pixels per second.
+	 */
+	void benchmarkConvert(const char *name, Graphics::YUVToRGBManager::Kernel kernel, Layout layout, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+
+		BenchmarkTimer timer;
+		for (int i = 0; i < kFrames; ++i) {
+			switch (layout) {
+			case kLayout444:
+				YUVToRGBMan.convert444(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth);
+				break;
+			case kLayout420:
+				YUVToRGBMan.convert420(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth / 2);
+				break;
+			case kLayout410:
+				YUVToRGBMan.convert410(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth / 4 + 1);
+				break;
+			}
+		}
+		const double seconds = timer.elapsed();
+
+		static const char *const kernelNames[] = { "lookup", "sse2", "avx2", "neon" };
+		Common::String caseName = Common::String::format("%s/%s/%dbpp", name, kernelNames[kernel], format.bytesPerPixel * 8);
+		benchmarkReport("yuv", caseName.c_str(), seconds > 0 ? (double)kWidth * kHeight * kFrames / seconds : 0.0, "pixels/s");
+
+		dst.free();
+	}
+
+	void benchmarkAllKernels(const char *name, Layout layout, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		static const Graphics::YUVToRGBManager::Kernel kernels[] = {
+			Graphics::YUVToRGBManager::kKernelLookup, Graphics::YUVToRGBManager::kKernelSSE2,
+			Graphics::YUVToRGBManager::kKernelAVX2, Graphics::YUVToRGBManager::kKernelNEON
+		};
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		// Planes big enough for all layouts
+		_y = new byte[kWidth * kHeight];
+		_u = new byte[kWidth * kHeight];
+		_v = new byte[kWidth * kHeight];
+		uint32 seed = 1;
+		for (int i = 0; i < kWidth * kHeight; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_y[i] = seed >> 24;
+			_u[i] = seed >> 16;
+			_v[i] = seed >> 8;
+		}
+
+		const Graphics::YUVToRGBManager::Kernel oldKernel = YUVToRGBMan.getKernel();
+		for (uint k = 0; k < ARRAYSIZE(kernels); ++k) {
+			if (!YUVToRGBMan.setKernel(kernels[k]))
+				continue;
+
+			for (uint f = 0; f < ARRAYSIZE(formats); ++f)
+				benchmarkConvert(name, kernels[k], layout, formats[f], scale);
+		}
+		YUVToRGBMan.setKernel(oldKernel);
+
+		delete[] _y;
+		delete[] _u;
+		delete[] _v;
+	}
+
+public:
+	void test_yuv420_itu() {
+		benchmarkAllKernels("420-itu", kLayout420, Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_yuv420_full() {
+		benchmarkAllKernels("420-full", kLayout420, Graphics::YUVToRGBManager::kScaleFull);
+	}
+
+	void test_yuv444_itu() {
+		benchmarkAllKernels("444-itu", kLayout444, Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_yuv410_itu() {
+		benchmarkAllKernels("410-itu", kLayout410, Graphics::YUVToRGBManager::kScaleITU);
+	}
+};
@@ -104,4 +104,18 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_range() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(3);
+		TS_ASSERT_EQUALS(ms.getRange(2, 5), contents + 2);
+		TS_ASSERT_EQUALS(ms.getRange(7, 0), contents + 7);
+		TS_ASSERT(!ms.getRange(2, 6));
+		TS_ASSERT(!ms.getRange(8, 0));
+
+		// The position does not change
+		TS_ASSERT_EQUALS(ms.pos(), 3);
+	}
 };
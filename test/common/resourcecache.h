@@ -0,0 +1,130 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/resourcecache.h"
+
+struct ResourceCacheTestItem {
+	bool evicted;
+
+	ResourceCacheTestItem() : evicted(false) {}
+};
+
+class ResourceCacheTestCache : public Common::ResourceCache<ResourceCacheTestItem> {
+public:
+	ResourceCacheTestCache(uint32 budget) : Common::ResourceCache<ResourceCacheTestItem>(budget) {}
+
+protected:
+	void evict(ResourceCacheTestItem *item) { item->evicted = true; }
+};
+
+class ResourceCacheTestSuite : public CxxTest::TestSuite {
+public:
+	void test_budget() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b, c;
+
+		cache.add(&a, 40);
+		cache.add(&b, 40);
+		TS_ASSERT_EQUALS(cache.getSize(), 80u);
+		TS_ASSERT(!a.evicted);
+
+		// The least recently used item goes first
+		cache.add(&c, 40);
+		TS_ASSERT(a.evicted);
+		TS_ASSERT(!b.evicted);
+		TS_ASSERT(!c.evicted);
+		TS_ASSERT(!cache.contains(&a));
+		TS_ASSERT_EQUALS(cache.getSize(), 80u);
+		TS_ASSERT_EQUALS(cache.getCount(), 2u);
+
+		TS_ASSERT_EQUALS(cache.getStatistics().misses, 3u);
+		TS_ASSERT_EQUALS(cache.getStatistics().evictions, 1u);
+
+		cache.setBudget(10);
+		TS_ASSERT(b.evicted);
+		TS_ASSERT(!c.evicted);
+	}
+
+	void test_touch() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b, c;
+
+		cache.add(&a, 40);
+		cache.add(&b, 40);
+		cache.touch(&a);
+		TS_ASSERT_EQUALS(cache.getStatistics().hits, 1u);
+
+		cache.add(&c, 40);
+		TS_ASSERT(!a.evicted);
+		TS_ASSERT(b.evicted);
+	}
+
+	void test_pin() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b, c;
+
+		cache.add(&a, 60);
+		cache.pin(&a);
+		cache.pin(&a);
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+		TS_ASSERT_EQUALS(cache.getPinnedSize(), 60u);
+
+		// Pinned items do not count against the budget
+		cache.add(&b, 60);
+		cache.add(&c, 40);
+		TS_ASSERT(!a.evicted);
+		TS_ASSERT(!b.evicted);
+
+		cache.unpin(&a);
+		TS_ASSERT_EQUALS(cache.getPins(&a), 1u);
+		cache.unpin(&a);
+		TS_ASSERT_EQUALS(cache.getSize(), 160u);
+
+		// Unpinning makes the item the most recently used one
+		cache.evictOld();
+		TS_ASSERT(!a.evicted);
+		TS_ASSERT(b.evicted);
+		TS_ASSERT(!c.evicted);
+		TS_ASSERT_EQUALS(cache.getSize(), 100u);
+	}
+
+	void test_oversized() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b;
+
+		// The most recently used item is kept, even if it exceeds the budget
+		cache.add(&a, 40);
+		cache.add(&b, 200);
+		TS_ASSERT(a.evicted);
+		TS_ASSERT(!b.evicted);
+		TS_ASSERT(cache.contains(&b));
+	}
+
+	void test_remove() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b;
+
+		cache.add(&a, 40);
+		cache.add(&b, 40);
+		cache.pin(&b);
+		cache.remove(&a);
+		cache.remove(&b);
+		TS_ASSERT(!a.evicted);
+		TS_ASSERT(!b.evicted);
+		TS_ASSERT_EQUALS(cache.getCount(), 0u);
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+		TS_ASSERT_EQUALS(cache.getPinnedSize(), 0u);
+	}
+
+	void test_evictAll() {
+		ResourceCacheTestCache cache(100);
+		ResourceCacheTestItem a, b;
+
+		cache.add(&a, 10);
+		cache.add(&b, 10);
+		cache.pin(&b);
+		cache.evictAll();
+		TS_ASSERT(a.evicted);
+		TS_ASSERT(!b.evicted);
+		TS_ASSERT_EQUALS(cache.getCount(), 1u);
+	}
+};
@@ -0,0 +1,300 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/threadpool.h"
+
+#include "threadsystem.h"
+
+/**
+ * Keeps streams from reading until it is opened.
+ */
+class SearchSetTestGate {
+public:
+	SearchSetTestGate() : _open(false) {
+		_mutex = g_system->createMutex();
+		_cond = g_system->createCondition();
+	}
+
+	~SearchSetTestGate() {
+		g_system->deleteCondition(_cond);
+		g_system->deleteMutex(_mutex);
+	}
+
+	void open() {
+		g_system->lockMutex(_mutex);
+		_open = true;
+		g_system->broadcastCondition(_cond);
+		g_system->unlockMutex(_mutex);
+	}
+
+	void pass() {
+		g_system->lockMutex(_mutex);
+		while (!_open)
+			g_system->waitCondition(_cond, _mutex);
+		g_system->unlockMutex(_mutex);
+	}
+
+private:
+	OSystem::MutexRef _mutex;
+	OSystem::ConditionRef _cond;
+	bool _open;
+};
+
+class SearchSetGatedStream : public Common::MemoryReadStream {
+public:
+	SearchSetGatedStream(const Common::String &data, SearchSetTestGate *gate)
+		: Common::MemoryReadStream((const byte *)strdup(data.c_str()), data.size(), DisposeAfterUse::YES), _gate(gate) {}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		_gate->pass();
+		return Common::MemoryReadStream::read(dataPtr, dataSize);
+	}
+
+private:
+	SearchSetTestGate *_gate;
+};
+
+class SearchSetTestArchive : public Common::Archive {
+public:
+	Common::String _file;
+	mutable int _lookups;
+	mutable int _opened;
+	bool _background;
+	SearchSetTestGate *_gate;
+
+	SearchSetTestArchive(const Common::String &file) : _file(file), _lookups(0), _opened(0), _background(false), _gate(0) {}
+
+	bool hasFile(const Common::String &name) const {
+		++_lookups;
+		return name.equalsIgnoreCase(_file);
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const {
+		list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_file, this)));
+		return 1;
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return 0;
+		++_opened;
+		if (_gate)
+			return new SearchSetGatedStream(_file, _gate);
+		return new Common::MemoryReadStream((const byte *)_file.c_str(), _file.size());
+	}
+
+	bool canReadMemberInBackground(const Common::String &name) const {
+		return _background;
+	}
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+public:
+	void test_index_lookup() {
+		Common::SearchSet set;
+		SearchSetTestArchive *a = new SearchSetTestArchive("a.dat");
+		SearchSetTestArchive *b = new SearchSetTestArchive("b.dat");
+		set.add("a", a);
+		set.add("b", b);
+
+		TS_ASSERT(set.hasFile("b.dat"));
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 1u);
+		TS_ASSERT_EQUALS(a->_lookups, 1);
+
+		// Second lookup (in different case) goes straight to 'b'
+		TS_ASSERT(set.hasFile("B.DAT"));
+		TS_ASSERT_EQUALS(set.getIndexHits(), 1u);
+		TS_ASSERT_EQUALS(a->_lookups, 1);
+
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("b.dat");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->readByte(), 'b');
+		delete stream;
+		TS_ASSERT_EQUALS(a->_lookups, 1);
+
+		TS_ASSERT(!set.hasFile("c.dat"));
+		TS_ASSERT(!set.hasFile(""));
+	}
+
+	void test_index_missing() {
+		Common::SearchSet set;
+		SearchSetTestArchive *a = new SearchSetTestArchive("a.dat");
+		SearchSetTestArchive *b = new SearchSetTestArchive("b.dat");
+		set.add("a", a);
+		set.add("b", b);
+
+		TS_ASSERT(!set.hasFile("c.dat"));
+		TS_ASSERT_EQUALS(a->_lookups, 1);
+		TS_ASSERT_EQUALS(b->_lookups, 1);
+
+		// Missing names are not remembered, so every archive is asked again
+		TS_ASSERT(!set.createReadStreamForMember("C.DAT"));
+		TS_ASSERT_EQUALS(a->_lookups, 2);
+		TS_ASSERT_EQUALS(b->_lookups, 2);
+		TS_ASSERT_EQUALS(set.getIndexHits(), 0u);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 2u);
+
+		// and members which show up later are found without flushing the
+		// index
+		b->_file = "c.dat";
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("c.dat");
+		TS_ASSERT(stream);
+		delete stream;
+		TS_ASSERT(set.hasFile("c.dat"));
+		TS_ASSERT_EQUALS(set.getIndexHits(), 1u);
+		TS_ASSERT_EQUALS(set.getIndexStale(), 0u);
+	}
+
+	void test_index_priority() {
+		Common::SearchSet set;
+		SearchSetTestArchive *low = new SearchSetTestArchive("file");
+		SearchSetTestArchive *high = new SearchSetTestArchive("file");
+		set.add("low", low, 0);
+
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("file");
+		delete stream;
+		TS_ASSERT_EQUALS(low->_lookups, 1);
+
+		// Adding an archive flushes the index, so the higher priority
+		// archive is found first.
+		set.add("high", high, 1);
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT_EQUALS(high->_lookups, 1);
+		TS_ASSERT_EQUALS(low->_lookups, 1);
+
+		// Removing it again must not leave a dangling index entry
+		set.remove("high");
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT_EQUALS(low->_lookups, 2);
+
+		// The index also follows files disappearing from an archive
+		low->_file = "other";
+		TS_ASSERT(!set.hasFile("file"));
+		TS_ASSERT_EQUALS(set.getIndexStale(), 1u);
+		TS_ASSERT(set.hasFile("other"));
+	}
+
+	// The test runner has no backend providing threads, so members are read
+	// right away
+	void test_prefetch() {
+		Common::SearchSet set;
+		SearchSetTestArchive *a = new SearchSetTestArchive("a.dat");
+		SearchSetTestArchive *b = new SearchSetTestArchive("bb.dat");
+		set.add("a", a);
+		set.add("b", b);
+
+		// Archives have to support reading in the background
+		TS_ASSERT(!set.prefetch("a.dat").isValid());
+		a->_background = b->_background = true;
+		TS_ASSERT(!set.prefetch("c.dat").isValid());
+
+		Common::PrefetchHandle handle = set.prefetch("a.dat");
+		TS_ASSERT(handle.isValid());
+		handle.wait();
+		TS_ASSERT(handle.isReady());
+		TS_ASSERT_EQUALS(set.getPrefetchedSize(), 5u);
+		TS_ASSERT_EQUALS(a->_opened, 1);
+
+		// Opening it is served from memory, also repeatedly
+		for (int i = 0; i < 2; ++i) {
+			Common::SeekableReadStream *stream = set.createReadStreamForMember("A.DAT");
+			TS_ASSERT(stream);
+			TS_ASSERT_EQUALS(stream->size(), 5);
+			TS_ASSERT_EQUALS(stream->readByte(), 'a');
+			delete stream;
+		}
+		TS_ASSERT_EQUALS(a->_opened, 1);
+
+		// Prefetching it again does not read it again
+		TS_ASSERT(set.prefetch("a.dat").isValid());
+		TS_ASSERT_EQUALS(a->_opened, 1);
+
+		// Changes to the set flush the cache
+		set.setPriority("b", 1);
+		TS_ASSERT_EQUALS(set.getPrefetchedSize(), 0u);
+		delete set.createReadStreamForMember("a.dat");
+		TS_ASSERT_EQUALS(a->_opened, 2);
+	}
+
+	void test_prefetch_cache_size() {
+		Common::SearchSet set;
+		SearchSetTestArchive *a = new SearchSetTestArchive("a.dat");
+		SearchSetTestArchive *b = new SearchSetTestArchive("bb.dat");
+		a->_background = b->_background = true;
+		set.add("a", a);
+		set.add("b", b);
+		set.setPrefetchCacheSize(8);
+
+		TS_ASSERT(set.prefetch("a.dat").isValid());
+
+		// Streams keep dropped members alive
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+
+		// The least recently used member is dropped to make room
+		TS_ASSERT(set.prefetch("bb.dat").isValid());
+		TS_ASSERT_EQUALS(set.getPrefetchedSize(), 6u);
+		TS_ASSERT_EQUALS(stream->readByte(), 'a');
+		delete stream;
+
+		delete set.createReadStreamForMember("a.dat");
+		TS_ASSERT_EQUALS(a->_opened, 2);
+		delete set.createReadStreamForMember("bb.dat");
+		TS_ASSERT_EQUALS(b->_opened, 1);
+
+		// Members which never fit are not prefetched
+		set.setPrefetchCacheSize(4);
+		TS_ASSERT_EQUALS(set.getPrefetchedSize(), 0u);
+		TS_ASSERT(!set.prefetch("bb.dat").isValid());
+	}
+
+	void test_prefetch_threads() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		// Recreate the shared pool, so that it has worker threads
+		Common::ThreadPool::destroy();
+		TS_ASSERT_LESS_THAN(0u, Common::ThreadPool::instance().getThreadCount());
+
+		SearchSetTestGate gate;
+		Common::SearchSet set;
+		SearchSetTestArchive *a = new SearchSetTestArchive("a.dat");
+		SearchSetTestArchive *b = new SearchSetTestArchive("bb.dat");
+		a->_background = b->_background = true;
+		a->_gate = b->_gate = &gate;
+		set.add("a", a);
+		set.add("b", b);
+
+		Common::PrefetchHandle handle = set.prefetch("a.dat");
+		TS_ASSERT(handle.isValid());
+		TS_ASSERT(set.prefetch("bb.dat").isValid());
+		TS_ASSERT(!handle.isReady());
+
+		// Changing the set drops the members without waiting for them
+		set.setPriority("b", 1);
+		TS_ASSERT_EQUALS(set.getPrefetchedSize(), 0u);
+
+		// Handles still work
+		gate.open();
+		handle.wait();
+		TS_ASSERT(handle.isReady());
+		handle = Common::PrefetchHandle();
+
+		// Streams on prefetched data do not depend on the pool
+		set.prefetch("a.dat").wait();
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT_EQUALS(a->_opened, 2);
+		set.clearPrefetchCache();
+		Common::ThreadPool::destroy();
+
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 5);
+		TS_ASSERT_EQUALS(stream->readByte(), 'a');
+		delete stream;
+	}
+};
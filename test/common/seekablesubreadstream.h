@@ -70,4 +70,14 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_get_range() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+		TS_ASSERT_EQUALS(ssrs.getRange(1, 5), contents + 3);
+		TS_ASSERT(!ssrs.getRange(1, 6));
+		TS_ASSERT(!ssrs.getRange(7, 0));
+	}
 };
@@ -0,0 +1,214 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/threadpool.h"
+
+#include "threadsystem.h"
+
+class ThreadPoolTestJob : public Common::Job {
+public:
+	static int _alive;
+
+	int _input;
+	int _result;
+
+	ThreadPoolTestJob(int input) : _input(input), _result(0) { ++_alive; }
+	~ThreadPoolTestJob() { --_alive; }
+
+	void run() { _result = _input * _input; }
+};
+
+int ThreadPoolTestJob::_alive = 0;
+
+static void threadPoolTestProc(void *param) {
+	++*(int *)param;
+}
+
+struct ThreadPoolTestCounter {
+	OSystem::MutexRef mutex;
+	int count;
+};
+
+static void threadPoolTestLockedProc(void *param) {
+	ThreadPoolTestCounter *counter = (ThreadPoolTestCounter *)param;
+	g_system->lockMutex(counter->mutex);
+	++counter->count;
+	g_system->unlockMutex(counter->mutex);
+}
+
+/**
+ * Job which blocks until it is released, to keep a worker busy.
+ */
+class ThreadPoolGateJob : public Common::Job {
+public:
+	ThreadPoolGateJob() : _started(false), _released(false) {
+		_mutex = g_system->createMutex();
+		_cond = g_system->createCondition();
+	}
+
+	~ThreadPoolGateJob() {
+		g_system->deleteCondition(_cond);
+		g_system->deleteMutex(_mutex);
+	}
+
+	void run() {
+		g_system->lockMutex(_mutex);
+		_started = true;
+		g_system->broadcastCondition(_cond);
+		while (!_released)
+			g_system->waitCondition(_cond, _mutex);
+		g_system->unlockMutex(_mutex);
+	}
+
+	void waitStarted() {
+		g_system->lockMutex(_mutex);
+		while (!_started)
+			g_system->waitCondition(_cond, _mutex);
+		g_system->unlockMutex(_mutex);
+	}
+
+	void release() {
+		g_system->lockMutex(_mutex);
+		_released = true;
+		g_system->broadcastCondition(_cond);
+		g_system->unlockMutex(_mutex);
+	}
+
+private:
+	OSystem::MutexRef _mutex;
+	OSystem::ConditionRef _cond;
+	bool _started, _released;
+};
+
+/**
+ * Job which waits for a job of its own, as e.g. a decoder job splitting its
+ * work further would.
+ */
+class ThreadPoolNestedJob : public Common::Job {
+public:
+	Common::ThreadPool *_pool;
+	int _result;
+
+	ThreadPoolNestedJob(Common::ThreadPool *pool) : _pool(pool), _result(0) {}
+
+	void run() {
+		_result = 25;
+		Common::Future<Common::FunctionJob> child = _pool->async(new Common::FunctionJob(threadPoolTestProc, &_result));
+		child.get();
+	}
+};
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_submit() {
+		Common::ThreadPool pool(0);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 0u);
+
+		int counter = 0;
+		for (int i = 0; i < 10; ++i)
+			pool.submit(threadPoolTestProc, &counter);
+		pool.waitAll();
+		TS_ASSERT_EQUALS(counter, 10);
+
+		// Submitted jobs are owned by the pool
+		pool.submit(new ThreadPoolTestJob(3));
+		pool.waitAll();
+		TS_ASSERT_EQUALS(ThreadPoolTestJob::_alive, 0);
+	}
+
+	void test_future() {
+		Common::ThreadPool pool(0);
+
+		{
+			Common::Future<ThreadPoolTestJob> future = pool.async(new ThreadPoolTestJob(7));
+			TS_ASSERT(future.isValid());
+			TS_ASSERT(future.isReady());
+			TS_ASSERT_EQUALS(future.get()._result, 49);
+
+			Common::Future<ThreadPoolTestJob> copy = future;
+			future = Common::Future<ThreadPoolTestJob>();
+			TS_ASSERT(!future.isValid());
+			TS_ASSERT_EQUALS(ThreadPoolTestJob::_alive, 1);
+			TS_ASSERT_EQUALS(copy.get()._result, 49);
+		}
+
+		// The last future deletes the job
+		TS_ASSERT_EQUALS(ThreadPoolTestJob::_alive, 0);
+	}
+
+	// The tests below use real worker threads
+
+	void test_async_threads() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		Common::ThreadPool pool(3);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 3u);
+
+		Common::Array<Common::Future<ThreadPoolTestJob> > futures;
+		for (int i = 0; i < 100; ++i)
+			futures.push_back(pool.async(new ThreadPoolTestJob(i)));
+		for (int i = 0; i < 100; ++i) {
+			TS_ASSERT_EQUALS(futures[i].get()._result, i * i);
+			TS_ASSERT(futures[i].isReady());
+		}
+
+		futures.clear();
+		TS_ASSERT_EQUALS(ThreadPoolTestJob::_alive, 0);
+	}
+
+	void test_wait_runs_only_own_job() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		Common::ThreadPool pool(1);
+
+		// Keep the only worker busy, so the jobs below stay queued
+		ThreadPoolGateJob *gate = new ThreadPoolGateJob;
+		Common::Future<ThreadPoolGateJob> gateFuture = pool.async(gate);
+		gate->waitStarted();
+
+		Common::Future<ThreadPoolTestJob> first = pool.async(new ThreadPoolTestJob(2));
+		Common::Future<ThreadPoolTestJob> second = pool.async(new ThreadPoolTestJob(3));
+
+		// Waiting for the second job runs it on this thread, but leaves the
+		// first one alone
+		TS_ASSERT_EQUALS(second.get()._result, 9);
+		TS_ASSERT(!first.isReady());
+		TS_ASSERT(!gateFuture.isReady());
+
+		gate->release();
+		TS_ASSERT_EQUALS(first.get()._result, 4);
+		gateFuture.get();
+	}
+
+	void test_wait_all_threads() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		Common::ThreadPool pool(2);
+
+		// A job waiting for its own job must not deadlock the pool, even if
+		// all workers do it at once
+		Common::Array<Common::Future<ThreadPoolNestedJob> > nested;
+		for (int i = 0; i < 8; ++i)
+			nested.push_back(pool.async(new ThreadPoolNestedJob(&pool)));
+
+		ThreadPoolTestCounter counter;
+		counter.mutex = g_system->createMutex();
+		counter.count = 0;
+		for (int i = 0; i < 50; ++i)
+			pool.submit(threadPoolTestLockedProc, &counter);
+
+		// waitAll only returns once all of them have finished
+		pool.waitAll();
+		TS_ASSERT_EQUALS(counter.count, 50);
+		g_system->deleteMutex(counter.mutex);
+		for (int i = 0; i < 8; ++i) {
+			TS_ASSERT(nested[i].isReady());
+			TS_ASSERT_EQUALS(nested[i].get()._result, 26);
+		}
+	}
+};
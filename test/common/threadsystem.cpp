@@ -0,0 +1,103 @@
+// The POSIX headers declare functions which common/forbidden.h disables
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include <cxxtest/TestSuite.h>
+
+#include "threadsystem.h"
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+struct ThreadStart {
+	pthread_t thread;
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+void *threadEntry(void *param) {
+	ThreadStart *start = (ThreadStart *)param;
+	start->proc(start->param);
+	return 0;
+}
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef ThreadTestSystem::createThread(ThreadProc proc, void *param, const char *name) {
+	ThreadStart *start = new ThreadStart;
+	start->proc = proc;
+	start->param = param;
+	if (pthread_create(&start->thread, 0, threadEntry, start) != 0) {
+		delete start;
+		return 0;
+	}
+	return (ThreadRef)start;
+}
+
+void ThreadTestSystem::joinThread(ThreadRef thread) {
+	ThreadStart *start = (ThreadStart *)thread;
+	pthread_join(start->thread, 0);
+	delete start;
+}
+
+OSystem::ConditionRef ThreadTestSystem::createCondition() {
+	pthread_cond_t *cond = new pthread_cond_t;
+	pthread_cond_init(cond, 0);
+	return (ConditionRef)cond;
+}
+
+void ThreadTestSystem::waitCondition(ConditionRef cond, MutexRef mutex) {
+	pthread_cond_wait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex);
+}
+
+void ThreadTestSystem::signalCondition(ConditionRef cond) {
+	pthread_cond_signal((pthread_cond_t *)cond);
+}
+
+void ThreadTestSystem::broadcastCondition(ConditionRef cond) {
+	pthread_cond_broadcast((pthread_cond_t *)cond);
+}
+
+void ThreadTestSystem::deleteCondition(ConditionRef cond) {
+	pthread_cond_destroy((pthread_cond_t *)cond);
+	delete (pthread_cond_t *)cond;
+}
+
+OSystem::MutexRef ThreadTestSystem::createMutex() {
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_t *mutex = new pthread_mutex_t;
+	pthread_mutex_init(mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	return (MutexRef)mutex;
+}
+
+void ThreadTestSystem::lockMutex(MutexRef mutex) {
+	pthread_mutex_lock((pthread_mutex_t *)mutex);
+}
+
+void ThreadTestSystem::unlockMutex(MutexRef mutex) {
+	pthread_mutex_unlock((pthread_mutex_t *)mutex);
+}
+
+void ThreadTestSystem::deleteMutex(MutexRef mutex) {
+	pthread_mutex_destroy((pthread_mutex_t *)mutex);
+	delete (pthread_mutex_t *)mutex;
+}
+
+uint32 ThreadTestSystem::getMillis(bool skipRecord) {
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (uint32)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+void ThreadTestSystem::delayMillis(uint msecs) {
+	usleep(msecs * 1000);
+}
+
+#endif
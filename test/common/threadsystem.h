@@ -0,0 +1,133 @@
+#ifndef TEST_COMMON_THREADSYSTEM_H
+#define TEST_COMMON_THREADSYSTEM_H
+
+#include "common/system.h"
+
+/**
+ * Base of the OSystems used by the tests, which replace g_system while
+ * they exist. Everything the tests don't need is stubbed out.
+ */
+class TestSystemBase : public OSystem {
+public:
+	TestSystemBase() : _oldSystem(g_system) { g_system = this; }
+	~TestSystemBase() { g_system = _oldSystem; }
+
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return false; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+
+private:
+	OSystem *_oldSystem;
+};
+
+#ifdef USE_PTHREADS
+
+/**
+ * Minimal OSystem providing mutexes, condition variables and threads based
+ * on POSIX threads, so that thread pools with real worker threads can be
+ * tested. It replaces g_system while it exists. The methods using POSIX
+ * threads are in threadsystem.cpp, which may use their system headers.
+ */
+class ThreadTestSystem : public TestSystemBase {
+public:
+	static bool isAvailable() { return true; }
+
+	ThreadRef createThread(ThreadProc proc, void *param, const char *name);
+	void joinThread(ThreadRef thread);
+
+	ConditionRef createCondition();
+	void waitCondition(ConditionRef cond, MutexRef mutex);
+	void signalCondition(ConditionRef cond);
+	void broadcastCondition(ConditionRef cond);
+	void deleteCondition(ConditionRef cond);
+
+	int getCPUCount() { return 4; }
+
+	// Mutexes are recursive, like those of the real backends
+	MutexRef createMutex();
+	void lockMutex(MutexRef mutex);
+	void unlockMutex(MutexRef mutex);
+	void deleteMutex(MutexRef mutex);
+
+	uint32 getMillis(bool skipRecord = false);
+	void delayMillis(uint msecs);
+	void getTimeAndDate(TimeDate &t) const {}
+};
+
+#else
+
+// Without POSIX threads, the tests using worker threads are skipped
+class ThreadTestSystem {
+public:
+	static bool isAvailable() { return false; }
+};
+
+#endif
+
+/**
+ * OSystem without threads, like the null backend and the other backends
+ * without a thread manager: createCondition() and createThread() return 0,
+ * and mutexes do nothing. Time only passes in delayMillis().
+ */
+class NullTestSystem : public TestSystemBase {
+public:
+	NullTestSystem() : _millis(0) {}
+
+	ThreadRef createThread(ThreadProc proc, void *param, const char *name) { return 0; }
+	ConditionRef createCondition() { return 0; }
+
+	// The backends assert when these are called without a thread manager
+	void joinThread(ThreadRef thread) { TS_FAIL("joinThread() called without threads"); }
+	void waitCondition(ConditionRef cond, MutexRef mutex) { TS_FAIL("waitCondition() called without threads"); }
+	void signalCondition(ConditionRef cond) { TS_FAIL("signalCondition() called without threads"); }
+	void broadcastCondition(ConditionRef cond) { TS_FAIL("broadcastCondition() called without threads"); }
+	void deleteCondition(ConditionRef cond) { TS_FAIL("deleteCondition() called without threads"); }
+
+	int getCPUCount() { return 1; }
+
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+
+	uint32 getMillis(bool skipRecord = false) { return _millis; }
+	void delayMillis(uint msecs) { _millis += msecs; }
+	void getTimeAndDate(TimeDate &t) const {}
+
+	// Like the null backend in its default 16 bit mode
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0); }
+
+private:
+	uint32 _millis;
+};
+
+#endif
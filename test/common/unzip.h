@@ -0,0 +1,208 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+// Hides getRange(), so archive data has to be read through the stream
+class UnzipTestUnmappedStream : public Common::SeekableReadStream {
+	Common::MemoryReadStream _stream;
+
+public:
+	UnzipTestUnmappedStream(const byte *data, uint32 size) : _stream(data, size) {}
+
+	bool eos() const { return _stream.eos(); }
+	uint32 read(void *dataPtr, uint32 dataSize) { return _stream.read(dataPtr, dataSize); }
+	int32 pos() const { return _stream.pos(); }
+	int32 size() const { return _stream.size(); }
+	bool seek(int32 offs, int whence = SEEK_SET) { return _stream.seek(offs, whence); }
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	enum {
+		kDataSize = 1000000
+	};
+
+	byte *_data;
+	byte *_zip;
+	uint32 _zipSize;
+
+	static void writeEntryHeader(Common::WriteStream &out, uint32 signature, bool central, uint16 method,
+	                             uint32 crc, uint32 compressedSize, const char *name, uint32 localOffset) {
+		out.writeUint32LE(signature);
+		if (central)
+			out.writeUint16LE(20);         // version made by
+		out.writeUint16LE(20);             // version needed
+		out.writeUint16LE(0);              // flags
+		out.writeUint16LE(method);
+		out.writeUint32LE(0);              // dos date/time
+		out.writeUint32LE(crc);
+		out.writeUint32LE(compressedSize);
+		out.writeUint32LE(kDataSize);
+		out.writeUint16LE(strlen(name));
+		out.writeUint16LE(0);              // extra field length
+		if (central) {
+			out.writeUint16LE(0);          // comment length
+			out.writeUint16LE(0);          // disk number
+			out.writeUint16LE(0);          // internal attributes
+			out.writeUint32LE(0);          // external attributes
+			out.writeUint32LE(localOffset);
+		}
+		out.write(name, strlen(name));
+	}
+
+	Common::Archive *makeArchive(bool mapped = true) {
+		if (!mapped)
+			return Common::makeZipArchive(new UnzipTestUnmappedStream(_zip, _zipSize));
+		return Common::makeZipArchive(new Common::MemoryReadStream(_zip, _zipSize));
+	}
+
+	void checkRange(Common::SeekableReadStream &stream, uint32 start, uint32 len) {
+		byte buf[1024];
+		TS_ASSERT(stream.seek(start));
+		TS_ASSERT_EQUALS((uint32)stream.pos(), start);
+		TS_ASSERT_EQUALS(stream.read(buf, len), len);
+		TS_ASSERT(memcmp(buf, _data + start, len) == 0);
+	}
+
+public:
+	void setUp() {
+		_data = new byte[kDataSize];
+		for (uint32 i = 0; i < kDataSize; ++i)
+			_data[i] = (byte)(((i * 2654435761U) >> 24) ^ (i / 1000));
+
+		// Produce raw deflate data by stripping the gzip header and trailer
+		Common::MemoryWriteStreamDynamic *gzData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gz = Common::wrapCompressedWriteStream(gzData);
+		gz->write(_data, kDataSize);
+		gz->finalize();
+		byte *gzBuf = gzData->getData();
+		uint32 gzSize = gzData->size();
+		delete gz;
+
+		const byte *deflated = gzBuf + 10;
+		const uint32 deflatedSize = gzSize - 18;
+		const uint32 crc = READ_LE_UINT32(gzBuf + gzSize - 8);
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		writeEntryHeader(zip, 0x04034b50, false, 0, crc, kDataSize, "stored.bin", 0);
+		zip.write(_data, kDataSize);
+		const uint32 deflatedOffset = zip.pos();
+		writeEntryHeader(zip, 0x04034b50, false, 8, crc, deflatedSize, "deflated.bin", 0);
+		zip.write(deflated, deflatedSize);
+		const uint32 centralOffset = zip.pos();
+		writeEntryHeader(zip, 0x02014b50, true, 0, crc, kDataSize, "stored.bin", 0);
+		writeEntryHeader(zip, 0x02014b50, true, 8, crc, deflatedSize, "deflated.bin", deflatedOffset);
+		const uint32 centralSize = zip.pos() - centralOffset;
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(2);
+		zip.writeUint16LE(2);
+		zip.writeUint32LE(centralSize);
+		zip.writeUint32LE(centralOffset);
+		zip.writeUint16LE(0);
+
+		_zip = zip.getData();
+		_zipSize = zip.size();
+		free(gzBuf);
+	}
+
+	void tearDown() {
+		free(_zip);
+		delete[] _data;
+	}
+
+	void test_stored_member() {
+		Common::Archive *archive = makeArchive();
+		TS_ASSERT(archive);
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("stored.bin");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), kDataSize);
+		checkRange(*stream, 0, 1024);
+		checkRange(*stream, kDataSize - 1024, 1024);
+		checkRange(*stream, 4711, 17);
+		delete stream;
+		delete archive;
+	}
+
+#ifdef USE_ZLIB
+	void test_deflated_sequential() {
+		Common::Archive *archive = makeArchive();
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), kDataSize);
+
+		byte *buf = new byte[kDataSize];
+		TS_ASSERT_EQUALS(stream->read(buf, kDataSize), (uint32)kDataSize);
+		TS_ASSERT(memcmp(buf, _data, kDataSize) == 0);
+		TS_ASSERT(!stream->err());
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->read(buf, 1), 0u);
+		TS_ASSERT(stream->eos());
+		delete[] buf;
+
+		delete stream;
+		delete archive;
+	}
+
+	void checkDeflatedSeek(bool mapped) {
+		Common::Archive *archive = makeArchive(mapped);
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("deflated.bin");
+
+		// Forward, then backwards across checkpoints and back to the start
+		checkRange(*stream, 300000, 1000);
+		checkRange(*stream, 900000, 1000);
+		checkRange(*stream, 600000, 1000);
+		checkRange(*stream, 10, 1000);
+		checkRange(*stream, 899999, 1000);
+		checkRange(*stream, kDataSize - 1000, 1000);
+		TS_ASSERT(stream->seek(-500, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), kDataSize - 500);
+		TS_ASSERT(!stream->seek(kDataSize + 1));
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+		delete archive;
+	}
+
+	void test_deflated_seek() {
+		checkDeflatedSeek(true);
+	}
+
+	void test_deflated_seek_unmapped() {
+		checkDeflatedSeek(false);
+	}
+
+	void test_interleaved_members() {
+		Common::Archive *archive = makeArchive();
+		Common::SeekableReadStream *a = archive->createReadStreamForMember("deflated.bin");
+		Common::SeekableReadStream *b = archive->createReadStreamForMember("deflated.bin");
+		Common::SeekableReadStream *c = archive->createReadStreamForMember("stored.bin");
+
+		// The streams must outlive the archive
+		delete archive;
+
+		byte bufA[777], bufB[777], bufC[777];
+		uint32 posB = 0;
+		for (uint32 pos = 0; pos + sizeof(bufA) <= kDataSize; pos += sizeof(bufA)) {
+			TS_ASSERT_EQUALS(a->read(bufA, sizeof(bufA)), sizeof(bufA));
+			TS_ASSERT_EQUALS(c->read(bufC, sizeof(bufC)), sizeof(bufC));
+			TS_ASSERT(memcmp(bufA, _data + pos, sizeof(bufA)) == 0);
+			TS_ASSERT(memcmp(bufC, _data + pos, sizeof(bufC)) == 0);
+
+			// Let the second stream lag behind
+			if ((pos / sizeof(bufA)) % 2 == 0) {
+				TS_ASSERT_EQUALS(b->read(bufB, sizeof(bufB)), sizeof(bufB));
+				TS_ASSERT(memcmp(bufB, _data + posB, sizeof(bufB)) == 0);
+				posB += sizeof(bufB);
+			}
+		}
+
+		delete a;
+		delete b;
+		delete c;
+	}
+#endif
+};
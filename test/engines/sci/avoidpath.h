@@ -0,0 +1,112 @@
+#include <cxxtest/TestSuite.h>
+
+#include "avoidpath_scenes.h"
+
+#include "../../common/threadsystem.h"
+
+using namespace Sci;
+
+/**
+ * Checks that kAvoidPath finds the same paths with the visibility graph
+ * cache as without it, while the cache is kept across calls like in a game.
+ */
+class AvoidPathTestSuite : public CxxTest::TestSuite {
+	typedef AvoidPathScenes::PolygonSet PolygonSet;
+
+	/** Compare the paths between all pairs of the points, return the number of pairs */
+	static uint compare(const PolygonSet &polygons, const Common::Array<Common::Point> &points, int opt, AvoidPathCache &cache) {
+		uint pairs = 0;
+		for (uint i = 0; i < points.size(); i++) {
+			for (uint j = 0; j < points.size(); j++) {
+				if (i == j)
+					continue;
+
+				const Common::Array<Common::Point> uncached = findAvoidPath(polygons, points[i], points[j],
+					AvoidPathScenes::kWidth, AvoidPathScenes::kHeight, opt, NULL);
+				const Common::Array<Common::Point> cached = findAvoidPath(polygons, points[i], points[j],
+					AvoidPathScenes::kWidth, AvoidPathScenes::kHeight, opt, &cache);
+
+				TS_ASSERT_EQUALS(cached.size(), uncached.size());
+				if (cached.size() != uncached.size())
+					return pairs;
+
+				for (uint k = 0; k < cached.size(); k++) {
+					TS_ASSERT_EQUALS(cached[k].x, uncached[k].x);
+					TS_ASSERT_EQUALS(cached[k].y, uncached[k].y);
+					if (cached[k] != uncached[k])
+						return pairs;
+				}
+				pairs++;
+			}
+		}
+		return pairs;
+	}
+
+public:
+	void test_detour() {
+		NullTestSystem system;
+
+		// A box in the way, which the path passes at its lower corners
+		PolygonSet polygons;
+		polygons.push_back(AvoidPathScenes::rect(AvoidPathScenes::kBarredAccess, 140, 60, 180, 130));
+
+		AvoidPathCache cache;
+		for (int pass = 0; pass < 2; pass++) {
+			const Common::Array<Common::Point> path = findAvoidPath(polygons, Common::Point(50, 110), Common::Point(270, 110),
+				AvoidPathScenes::kWidth, AvoidPathScenes::kHeight, 1, &cache);
+
+			TS_ASSERT_EQUALS(path.size(), 4u);
+			if (path.size() != 4)
+				return;
+			TS_ASSERT(path[0] == Common::Point(50, 110));
+			TS_ASSERT(path[1] == Common::Point(140, 130));
+			TS_ASSERT(path[2] == Common::Point(180, 130));
+			TS_ASSERT(path[3] == Common::Point(270, 110));
+		}
+		TS_ASSERT_EQUALS(cache.polygons.size(), 1u);
+	}
+
+	void test_room() {
+		NullTestSystem system;
+		AvoidPathCache cache;
+		const Common::Array<Common::Point> points = AvoidPathScenes::grid(6, 5);
+
+		TS_ASSERT_EQUALS(compare(AvoidPathScenes::room(), points, 1, cache), 870u);
+		TS_ASSERT_EQUALS(compare(AvoidPathScenes::room(), points, 0, cache), 870u);
+		TS_ASSERT_LESS_THAN(0u, cache.hits);
+	}
+
+	void test_changing_polygons() {
+		NullTestSystem system;
+		AvoidPathCache cache;
+		const PolygonSet room = AvoidPathScenes::room();
+		const Common::Array<Common::Point> points = AvoidPathScenes::grid(4, 3);
+
+		// Polygons drop out of the set and come back, while the cache
+		// keeps what it learned about all of them
+		for (uint i = 0; i < room.size(); i++)
+			TS_ASSERT_EQUALS(compare(AvoidPathScenes::without(room, i), points, 1, cache), 132u);
+		TS_ASSERT_EQUALS(compare(room, points, 1, cache), 132u);
+		TS_ASSERT_EQUALS(cache.polygons.size(), room.size());
+	}
+
+	void test_full_cache() {
+		NullTestSystem system;
+		AvoidPathCache cache;
+		const Common::Array<Common::Point> points = AvoidPathScenes::grid(3, 2);
+
+		// Too many polygons, which are not cached at all
+		const PolygonSet crowd = AvoidPathScenes::crowd();
+		TS_ASSERT_LESS_THAN((uint)AvoidPathCache::kMaxPolygons, crowd.size());
+		TS_ASSERT_EQUALS(compare(crowd, points, 1, cache), 30u);
+		TS_ASSERT(cache.polygons.empty());
+
+		// Alternating sets which only fit into the cache on their own, so
+		// that it is emptied each time
+		for (int pass = 0; pass < 2; pass++) {
+			TS_ASSERT_EQUALS(compare(AvoidPathScenes::columns(false), points, 1, cache), 30u);
+			TS_ASSERT_EQUALS(compare(AvoidPathScenes::columns(true), points, 1, cache), 30u);
+			TS_ASSERT_EQUALS(cache.polygons.size(), 5u);
+		}
+	}
+};
@@ -0,0 +1,116 @@
+#ifndef TEST_ENGINES_SCI_AVOIDPATH_SCENES_H
+#define TEST_ENGINES_SCI_AVOIDPATH_SCENES_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+#include "engines/sci/engine/kpathing.h"
+
+/**
+ * Fixed polygon sets as games pass them to kAvoidPath, so that the tests
+ * and benchmarks run the pathfinder on the same input every time.
+ */
+class AvoidPathScenes {
+public:
+	typedef Common::Array<Sci::AvoidPathPolygon> PolygonSet;
+
+	enum {
+		kWidth = 320,
+		kHeight = 190
+	};
+
+	enum {
+		kTotalAccess = 0,
+		kNearestAccess = 1,
+		kBarredAccess = 2,
+		kContainedAccess = 3
+	};
+
+	static Sci::AvoidPathPolygon polygon(int type, const int16 *coords, uint count) {
+		Sci::AvoidPathPolygon result(type);
+		for (uint i = 0; i < count; i += 2)
+			result.points.push_back(Common::Point(coords[i], coords[i + 1]));
+		return result;
+	}
+
+	static Sci::AvoidPathPolygon rect(int type, int16 left, int16 top, int16 right, int16 bottom) {
+		const int16 coords[] = { left, top, right, top, right, bottom, left, bottom };
+		return polygon(type, coords, ARRAYSIZE(coords));
+	}
+
+	/** A room with a walkable area and obstacles of all kinds */
+	static PolygonSet room() {
+		static const int16 walkable[] = {
+			5, 40, 120, 30, 200, 30, 315, 45, 315, 185, 160, 170, 5, 185
+		};
+		static const int16 table[] = { 60, 70, 100, 60, 115, 90, 75, 100 };
+		static const int16 counter[] = {
+			170, 80, 260, 80, 260, 140, 240, 140, 240, 100, 170, 100
+		};
+		static const int16 plant[] = { 140, 140, 150, 130, 160, 140, 150, 150 };
+		static const int16 rug[] = { 110, 150, 150, 160, 110, 170, 70, 160 };
+
+		PolygonSet set;
+		set.push_back(polygon(kContainedAccess, walkable, ARRAYSIZE(walkable)));
+		set.push_back(polygon(kBarredAccess, table, ARRAYSIZE(table)));
+		set.push_back(polygon(kBarredAccess, counter, ARRAYSIZE(counter)));
+		set.push_back(polygon(kNearestAccess, plant, ARRAYSIZE(plant)));
+		set.push_back(polygon(kTotalAccess, rug, ARRAYSIZE(rug)));
+		set.push_back(rect(kBarredAccess, 20, 120, 45, 150));
+		set.push_back(rect(kBarredAccess, 280, 60, 300, 170));
+		return set;
+	}
+
+	/** More polygons than the visibility graph cache can hold */
+	static PolygonSet crowd() {
+		PolygonSet set;
+		for (int16 y = 0; y < 5; y++) {
+			for (int16 x = 0; x < 8; x++) {
+				const int16 left = 20 + x * 36 + (y % 2) * 12;
+				const int16 top = 15 + y * 34;
+				set.push_back(rect(kBarredAccess, left, top, left + 14, top + 12));
+			}
+		}
+		return set;
+	}
+
+	/**
+	 * Columns of polygons with many vertices, which fill the vertices of the
+	 * cache when used together with the second half
+	 */
+	static PolygonSet columns(bool secondHalf) {
+		PolygonSet set;
+		for (int16 column = 0; column < 5; column++) {
+			const int16 x = (secondHalf ? 170 : 20) + column * 28;
+			Sci::AvoidPathPolygon zigzag(kBarredAccess);
+			for (int16 i = 0; i < 14; i++)
+				zigzag.points.push_back(Common::Point(x + (i % 2) * 4, 20 + i * 11));
+			for (int16 i = 13; i >= 0; i--)
+				zigzag.points.push_back(Common::Point(x + 12 + (i % 2) * 4, 20 + i * 11));
+			set.push_back(zigzag);
+		}
+		return set;
+	}
+
+	/** The set without one of its polygons, like the polygon an actor stands on */
+	static PolygonSet without(const PolygonSet &set, uint index) {
+		PolygonSet result;
+		for (uint i = 0; i < set.size(); i++) {
+			if (i != index)
+				result.push_back(set[i]);
+		}
+		return result;
+	}
+
+	/** Points spread over the screen, some of them inside polygons */
+	static Common::Array<Common::Point> grid(int columns, int rows) {
+		Common::Array<Common::Point> points;
+		for (int y = 0; y < rows; y++) {
+			for (int x = 0; x < columns; x++)
+				points.push_back(Common::Point(8 + x * 304 / (columns - 1), 8 + y * 174 / (rows - 1)));
+		}
+		return points;
+	}
+};
+
+#endif
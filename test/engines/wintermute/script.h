@@ -0,0 +1,169 @@
+#include <cxxtest/TestSuite.h>
+
+#include "script_builder.h"
+
+#include "../../common/threadsystem.h"
+
+using namespace Wintermute;
+
+/**
+ * Checks that the variables resolved once per symbol still refer to the
+ * same variables as a lookup by name would.
+ */
+class ScriptVariableTestSuite : public CxxTest::TestSuite {
+	/** Write "dst = a + b", with both operands variables */
+	static void add(ScriptBuilder &code, const char *dst, const char *a, const char *b) {
+		code.opVar(II_PUSH_VAR, a);
+		code.opVar(II_PUSH_VAR, b);
+		code.op(II_ADD);
+		code.opVar(II_POP_VAR, dst);
+	}
+
+	static void set(ScriptBuilder &code, const char *dst, int value) {
+		code.op(II_PUSH_INT, value);
+		code.opVar(II_POP_VAR, dst);
+	}
+
+	static int getInt(ScValue *object, const char *name) {
+		ScValue *value = object->getProp(name);
+		TS_ASSERT(value);
+		return value ? value->getInt() : -1;
+	}
+
+public:
+	void test_loop() {
+		NullTestSystem system;
+		ScriptRunner runner;
+
+		// var sum = 0; { var i = 0; while (i < 100) { sum = sum + i; i = i + 1; } }
+		ScriptBuilder code;
+		code.opVar(II_DEF_VAR, "sum");
+		set(code, "sum", 0);
+		code.op(II_SCOPE);
+		code.opVar(II_DEF_VAR, "i");
+		set(code, "i", 0);
+		code.opVar(II_DEF_VAR, "one");
+		set(code, "one", 1);
+		const uint32 loop = code.here();
+		code.opVar(II_PUSH_VAR, "i");
+		code.op(II_PUSH_INT, 100);
+		code.op(II_CMP_L);
+		const uint32 exit = code.jump(II_JMP_FALSE);
+		add(code, "sum", "sum", "i");
+		add(code, "i", "i", "one");
+		code.op(II_JMP, loop);
+		code.patch(exit, code.here());
+		code.op(II_RET);
+
+		ScScript *script = runner.create(code.build());
+		TS_ASSERT(script);
+		runner.run(script);
+		TS_ASSERT_EQUALS(script->_state, SCRIPT_FINISHED);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "sum"), 4950);
+		delete script;
+	}
+
+	void test_shadowing() {
+		NullTestSystem system;
+		ScriptRunner runner;
+
+		// An engine global, then a script global and a local of the same name,
+		// each declared after the name was resolved to the previous one
+		ScriptBuilder code;
+		code.opVar(II_DEF_GLOB_VAR, "x");
+		set(code, "x", 1);
+		code.opVar(II_DEF_VAR, "x");
+		set(code, "x", 2);
+		code.op(II_SCOPE);
+		code.opVar(II_DEF_VAR, "copy");
+		add(code, "copy", "x", "x");
+		code.opVar(II_DEF_VAR, "x");
+		set(code, "x", 3);
+		code.opVar(II_DEF_GLOB_VAR, "local");
+		add(code, "local", "x", "copy");
+		code.op(II_RET);
+
+		ScScript *script = runner.create(code.build());
+		TS_ASSERT(script);
+		runner.run(script);
+		TS_ASSERT_EQUALS(script->_state, SCRIPT_FINISHED);
+		TS_ASSERT_EQUALS(getInt(runner.getEngine()->_globals, "x"), 1);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "x"), 2);
+		TS_ASSERT_EQUALS(getInt(runner.getEngine()->_globals, "local"), 7);
+		delete script;
+	}
+
+	void test_reused_scope() {
+		NullTestSystem system;
+		ScriptRunner runner;
+
+		// var total = 0; f(); f(); with
+		// function f() { var a = total; var b = 5; total = a + b; }
+		// where both calls get the same value on the scope stack
+		ScriptBuilder code;
+		code.opVar(II_DEF_VAR, "total");
+		set(code, "total", 0);
+		const uint32 call1 = code.jump(II_CALL);
+		const uint32 call2 = code.jump(II_CALL);
+		code.op(II_RET);
+
+		code.patch(call1, code.here());
+		code.patch(call2, code.here());
+		code.op(II_SCOPE);
+		code.opVar(II_DEF_VAR, "a");
+		code.opVar(II_PUSH_VAR, "total");
+		code.opVar(II_POP_VAR, "a");
+		code.opVar(II_DEF_VAR, "b");
+		set(code, "b", 5);
+		add(code, "total", "a", "b");
+		code.op(II_RET);
+
+		ScScript *script = runner.create(code.build());
+		TS_ASSERT(script);
+		runner.run(script);
+		TS_ASSERT_EQUALS(script->_state, SCRIPT_FINISHED);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "total"), 10);
+		delete script;
+	}
+
+	void test_nested_scopes() {
+		NullTestSystem system;
+		ScriptRunner runner;
+
+		// var a = 1; var seen; var back; g(); with
+		// function g() { var a = 2; h(); back = a; }
+		// function h() { seen = a; }
+		// where h only sees the script global, not the local of its caller
+		ScriptBuilder code;
+		code.opVar(II_DEF_VAR, "a");
+		set(code, "a", 1);
+		code.opVar(II_DEF_VAR, "seen");
+		code.opVar(II_DEF_VAR, "back");
+		const uint32 callG = code.jump(II_CALL);
+		code.op(II_RET);
+
+		code.patch(callG, code.here());
+		code.op(II_SCOPE);
+		code.opVar(II_DEF_VAR, "a");
+		set(code, "a", 2);
+		const uint32 callH = code.jump(II_CALL);
+		code.opVar(II_PUSH_VAR, "a");
+		code.opVar(II_POP_VAR, "back");
+		code.op(II_RET);
+
+		code.patch(callH, code.here());
+		code.op(II_SCOPE);
+		code.opVar(II_PUSH_VAR, "a");
+		code.opVar(II_POP_VAR, "seen");
+		code.op(II_RET);
+
+		ScScript *script = runner.create(code.build());
+		TS_ASSERT(script);
+		runner.run(script);
+		TS_ASSERT_EQUALS(script->_state, SCRIPT_FINISHED);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "a"), 1);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "seen"), 1);
+		TS_ASSERT_EQUALS(getInt(script->_globals, "back"), 2);
+		delete script;
+	}
+};
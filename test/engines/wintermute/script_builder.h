@@ -0,0 +1,137 @@
+#ifndef TEST_ENGINES_WINTERMUTE_SCRIPT_BUILDER_H
+#define TEST_ENGINES_WINTERMUTE_SCRIPT_BUILDER_H
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/str.h"
+
+#include "engines/wintermute/base/base_engine.h"
+#include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/scriptables/dcscript.h"
+#include "engines/wintermute/base/scriptables/script.h"
+#include "engines/wintermute/base/scriptables/script_engine.h"
+#include "engines/wintermute/base/scriptables/script_value.h"
+
+/**
+ * Assembles compiled Wintermute scripts, so that the tests and benchmarks
+ * can run them without a script compiler or game data.
+ */
+class ScriptBuilder {
+public:
+	ScriptBuilder() {
+		// the header is filled in by build()
+		_code.resize(kHeaderSize);
+	}
+
+	/** @return the offset the next instruction is written to */
+	uint32 here() const { return _code.size(); }
+
+	/** @return the index of the given symbol, adding it if needed */
+	uint32 symbol(const char *name) {
+		for (uint32 i = 0; i < _symbols.size(); ++i) {
+			if (_symbols[i] == name)
+				return i;
+		}
+		_symbols.push_back(name);
+		return _symbols.size() - 1;
+	}
+
+	void op(Wintermute::TInstruction inst) { putDWORD(inst); }
+	void op(Wintermute::TInstruction inst, uint32 param) { putDWORD(inst); putDWORD(param); }
+	void opVar(Wintermute::TInstruction inst, const char *name) { op(inst, symbol(name)); }
+
+	/** Write a jump whose target is set later with patch() */
+	uint32 jump(Wintermute::TInstruction inst) {
+		op(inst, 0);
+		return here() - 4;
+	}
+
+	void patch(uint32 offset, uint32 target) { WRITE_LE_UINT32(&_code[offset], target); }
+
+	/** Append the tables and the header, and return the compiled script */
+	const Common::Array<byte> &build() {
+		const uint32 symbolTable = here();
+		putDWORD(_symbols.size());
+		for (uint32 i = 0; i < _symbols.size(); ++i) {
+			putDWORD(i);
+			putString(_symbols[i]);
+		}
+
+		// no functions, events, externals or methods
+		const uint32 emptyTable = here();
+		putDWORD(0);
+
+		const uint32 header[kHeaderSize / 4] = {
+			SCRIPT_MAGIC, SCRIPT_VERSION, kHeaderSize, emptyTable,
+			symbolTable, emptyTable, emptyTable, emptyTable
+		};
+		for (uint32 i = 0; i < kHeaderSize / 4; ++i)
+			WRITE_LE_UINT32(&_code[i * 4], header[i]);
+
+		return _code;
+	}
+
+private:
+	enum {
+		kHeaderSize = 8 * 4
+	};
+
+	void putDWORD(uint32 value) {
+		for (int i = 0; i < 4; ++i)
+			_code.push_back((value >> (i * 8)) & 0xFF);
+	}
+
+	void putString(const Common::String &str) {
+		for (uint32 i = 0; i <= str.size(); ++i)
+			_code.push_back(str.c_str()[i]);
+	}
+
+	Common::Array<byte> _code;
+	Common::Array<Common::String> _symbols;
+};
+
+/**
+ * A game with just a script engine, which runs the scripts to completion.
+ * It needs an OSystem for the log timestamps.
+ */
+class ScriptRunner {
+public:
+	ScriptRunner() {
+		Wintermute::BaseEngine::instance().initClassRegistry();
+		_game = new Wintermute::BaseGame("test");
+		_engine = new Wintermute::ScEngine(_game);
+	}
+
+	~ScriptRunner() {
+		delete _engine;
+		delete _game;
+		Wintermute::BaseEngine::destroy();
+	}
+
+	Wintermute::ScEngine *getEngine() { return _engine; }
+
+	/** Run the script and return the number of instructions it executed */
+	uint32 run(Wintermute::ScScript *script) {
+		uint32 instructions = 0;
+		while (script->_state == Wintermute::SCRIPT_RUNNING) {
+			script->executeInstruction();
+			++instructions;
+		}
+		return instructions;
+	}
+
+	Wintermute::ScScript *create(const Common::Array<byte> &code) {
+		Wintermute::ScScript *script = new Wintermute::ScScript(_game, _engine);
+		if (DID_FAIL(script->create("test.script", const_cast<byte *>(code.begin()), code.size(), nullptr))) {
+			delete script;
+			return nullptr;
+		}
+		return script;
+	}
+
+private:
+	Wintermute::BaseGame *_game;
+	Wintermute::ScEngine *_engine;
+};
+
+#endif
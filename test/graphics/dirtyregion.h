@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyregion.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty() {
+		Graphics::DirtyRegion region;
+		TS_ASSERT(region.empty());
+
+		region.addRect(Common::Rect(10, 10, 10, 20));
+		TS_ASSERT(region.empty());
+		TS_ASSERT_EQUALS(region.getArea(), 0u);
+	}
+
+	void test_contained() {
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 100, 100));
+		region.addRect(Common::Rect(10, 10, 20, 20));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 100, 100));
+
+		region.addRect(Common::Rect(-10, -10, 110, 110));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(-10, -10, 110, 110));
+	}
+
+	void test_adjacent() {
+		// Adjacent rects of the same height are merged without any cost
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(10, 0, 20, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getArea(), 200u);
+	}
+
+	void test_distant() {
+		// Merging rects far apart would redraw a lot more
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(100, 100, 110, 110));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+		TS_ASSERT_EQUALS(region.getArea(), 200u);
+	}
+
+	void test_chain() {
+		// The merged rect may be merged with earlier ones
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(20, 0, 30, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2u);
+
+		region.addRect(Common::Rect(10, 0, 20, 10));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 30, 10));
+	}
+
+	void test_limit() {
+		// A grid of small rects is merged into the given number of rects,
+		// which cover all of them, without growing to the whole area
+		Graphics::DirtyRegion region(4);
+		for (int y = 0; y < 8; ++y)
+			for (int x = 0; x < 8; ++x)
+				region.addRect(Common::Rect(x * 40, y * 25, x * 40 + 4, y * 25 + 4));
+
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		TS_ASSERT_LESS_THAN_EQUALS(rects.size(), 4u);
+
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				bool covered = false;
+				for (uint i = 0; i < rects.size(); ++i)
+					covered |= rects[i].contains(Common::Rect(x * 40, y * 25, x * 40 + 4, y * 25 + 4));
+				TS_ASSERT(covered);
+			}
+		}
+
+		TS_ASSERT_LESS_THAN_EQUALS(region.getArea(), 284u * 179u);
+	}
+
+	void test_many() {
+		// Many more rects than allowed are merged in batches, and all of
+		// them stay covered
+		Graphics::DirtyRegion region;
+		Common::Array<Common::Rect> added;
+		uint32 seed = 1;
+		for (int i = 0; i < 1000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const int x = (seed >> 8) % 620, y = (seed >> 20) % 460;
+			added.push_back(Common::Rect(x, y, x + 4 + i % 16, y + 4 + i % 16));
+			region.addRect(added.back());
+		}
+
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		TS_ASSERT_LESS_THAN_EQUALS(rects.size(), 32u);
+
+		for (uint i = 0; i < added.size(); ++i) {
+			bool covered = false;
+			for (uint j = 0; j < rects.size(); ++j)
+				covered |= rects[j].contains(added[i]);
+			TS_ASSERT(covered);
+		}
+	}
+
+	void test_clear() {
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.clear();
+		TS_ASSERT(region.empty());
+	}
+};
@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/threadpool.h"
+#include "common/util.h"
+#include "graphics/scaler.h"
+
+#include "../common/threadsystem.h"
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Enough rows for several bands, with a last band of odd height
+		kWidth = 40,
+		kHeight = 75,
+		// The scalers read a few pixels around the rect
+		kBorder = 4,
+		kSrcPitch = (kWidth + 2 * kBorder) * 2
+	};
+
+	uint8 _src[kSrcPitch * (kHeight + 2 * kBorder)];
+
+	const uint8 *srcRect() const {
+		return _src + kBorder * kSrcPitch + kBorder * 2;
+	}
+
+	void checkBands(ScalerProc *scalerProc, int scaleFactor) {
+		const uint32 dstPitch = kWidth * scaleFactor * 2;
+		const uint32 dstSize = dstPitch * kHeight * scaleFactor;
+		uint8 *serial = new uint8[dstSize];
+		uint8 *banded = new uint8[dstSize];
+		memset(serial, 0, dstSize);
+		memset(banded, 0, dstSize);
+
+		scalerProc(srcRect(), kSrcPitch, serial, dstPitch, kWidth, kHeight);
+		scaleInBands(scalerProc, scaleFactor, srcRect(), kSrcPitch, banded, dstPitch, kWidth, kHeight, 4);
+
+		TS_ASSERT_SAME_DATA(serial, banded, dstSize);
+
+		delete[] serial;
+		delete[] banded;
+	}
+
+public:
+	void setUp() {
+		// Runs of equal colors and some noise, so the edge detection of the
+		// scalers kicks in
+		uint32 seed = 1;
+		for (uint i = 0; i < ARRAYSIZE(_src); i += 2) {
+			seed = seed * 1103515245 + 12345;
+			const uint16 color = ((i / 16) & 1) ? (seed >> 16) : 0xF800;
+			WRITE_UINT16(_src + i, color);
+		}
+
+		InitScalers(565);
+	}
+
+	void tearDown() {
+		DestroyScalers();
+	}
+
+	void test_normal() {
+		checkBands(Normal1x, 1);
+#ifdef USE_SCALERS
+		checkBands(Normal2x, 2);
+		checkBands(Normal3x, 3);
+#endif
+	}
+
+	void test_threads() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		// Recreate the shared pool, so that the bands run on worker threads
+		Common::ThreadPool::destroy();
+		TS_ASSERT_LESS_THAN(0u, Common::ThreadPool::instance().getThreadCount());
+
+		checkBands(Normal1x, 1);
+#ifdef USE_SCALERS
+		checkBands(Normal3x, 3);
+		checkBands(AdvMame2x, 2);
+		checkBands(TV2x, 2);
+#ifdef USE_HQ_SCALERS
+		checkBands(HQ2x, 2);
+		checkBands(HQ3x, 3);
+#endif
+#endif
+
+		// The pool must not outlive the thread functions of the system
+		Common::ThreadPool::destroy();
+	}
+
+#ifdef USE_SCALERS
+	void test_sai() {
+		checkBands(_2xSaI, 2);
+		checkBands(Super2xSaI, 2);
+		checkBands(SuperEagle, 2);
+	}
+
+	void test_advmame() {
+		checkBands(AdvMame2x, 2);
+		checkBands(AdvMame3x, 3);
+	}
+
+	void test_tv() {
+		checkBands(TV2x, 2);
+		checkBands(DotMatrix, 2);
+	}
+
+#ifdef USE_HQ_SCALERS
+	void test_hq() {
+		checkBands(HQ2x, 2);
+		checkBands(HQ3x, 3);
+	}
+#endif
+#endif
+};
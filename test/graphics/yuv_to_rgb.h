@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../common/threadsystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum {
+		// Not a multiple of the vector widths, so the tails are covered
+		kWidth = 268,
+		kHeight = 20,
+		kPitch = kWidth + 4
+	};
+
+	enum Layout {
+		kLayout444,
+		kLayout420,
+		kLayout410
+	};
+
+	byte _y[kPitch * kHeight], _u[kPitch * (kHeight + 1)], _v[kPitch * (kHeight + 1)];
+
+	void fillPlanes() {
+		// Go through all the luminance values and a wide range of chroma
+		// combinations, including the extremes
+		uint32 seed = 1;
+		for (int i = 0; i < kPitch * kHeight; ++i)
+			_y[i] = i;
+		for (int i = 0; i < kPitch * (kHeight + 1); ++i) {
+			seed = seed * 1103515245 + 12345;
+			_u[i] = (i & 1) ? (seed >> 16) : ((i >> 1) & 1) * 255;
+			_v[i] = (i & 2) ? (seed >> 24) : (i & 1) * 255;
+		}
+	}
+
+	void convert(Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, Layout layout) {
+		switch (layout) {
+		case kLayout444:
+			YUVToRGBMan.convert444(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case kLayout420:
+			YUVToRGBMan.convert420(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case kLayout410:
+			YUVToRGBMan.convert410(&dst, scale, _y, _u, _v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		}
+	}
+
+	struct ConvertThread {
+		YUVToRGBTestSuite *suite;
+		Graphics::Surface surface;
+	};
+
+	static void convertThreadProc(void *param) {
+		ConvertThread *thread = (ConvertThread *)param;
+		for (int i = 0; i < 20; ++i)
+			thread->suite->convert(thread->surface, Graphics::YUVToRGBManager::kScaleITU, kLayout420);
+	}
+
+	void compareKernel(Graphics::YUVToRGBManager::Kernel kernel) {
+		const Graphics::YUVToRGBManager::Kernel oldKernel = YUVToRGBMan.getKernel();
+		if (!YUVToRGBMan.setKernel(kernel))
+			return;
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 24)
+		};
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU
+		};
+		const Layout layouts[] = { kLayout444, kLayout420, kLayout410 };
+
+		fillPlanes();
+
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			for (uint s = 0; s < ARRAYSIZE(scales); ++s) {
+				for (uint l = 0; l < ARRAYSIZE(layouts); ++l) {
+					Graphics::Surface ref, out;
+					ref.create(kWidth, kHeight, formats[f]);
+					out.create(kWidth, kHeight, formats[f]);
+
+					YUVToRGBMan.setKernel(Graphics::YUVToRGBManager::kKernelLookup);
+					convert(ref, scales[s], layouts[l]);
+					YUVToRGBMan.setKernel(kernel);
+					convert(out, scales[s], layouts[l]);
+
+					TS_ASSERT_EQUALS(memcmp(ref.getPixels(), out.getPixels(), ref.pitch * kHeight), 0);
+
+					ref.free();
+					out.free();
+				}
+			}
+		}
+
+		YUVToRGBMan.setKernel(oldKernel);
+	}
+
+public:
+	void test_kernel_sse2() {
+		compareKernel(Graphics::YUVToRGBManager::kKernelSSE2);
+	}
+
+	void test_kernel_avx2() {
+		compareKernel(Graphics::YUVToRGBManager::kKernelAVX2);
+	}
+
+	void test_kernel_neon() {
+		compareKernel(Graphics::YUVToRGBManager::kKernelNEON);
+	}
+
+	void test_lookup_threads() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		ThreadTestSystem system;
+		// Recreate the manager, so that it guards its lookups
+		Graphics::YUVToRGBManager::destroy();
+		YUVToRGBMan.setKernel(Graphics::YUVToRGBManager::kKernelLookup);
+		fillPlanes();
+
+		// Every thread needs a different lookup
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 24)
+		};
+		ConvertThread threads[ARRAYSIZE(formats)];
+		OSystem::ThreadRef refs[ARRAYSIZE(formats)];
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			threads[i].suite = this;
+			threads[i].surface.create(kWidth, kHeight, formats[i]);
+			refs[i] = g_system->createThread(convertThreadProc, &threads[i], "YUVToRGBTest");
+			TS_ASSERT(refs[i]);
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			g_system->joinThread(refs[i]);
+
+			Graphics::Surface ref;
+			ref.create(kWidth, kHeight, formats[i]);
+			convert(ref, Graphics::YUVToRGBManager::kScaleITU, kLayout420);
+			TS_ASSERT_EQUALS(memcmp(ref.getPixels(), threads[i].surface.getPixels(), ref.pitch * kHeight), 0);
+			ref.free();
+			threads[i].surface.free();
+		}
+
+		// The manager must not outlive the mutex functions of the system
+		Graphics::YUVToRGBManager::destroy();
+	}
+
+	void test_kernel_lookup() {
+		const Graphics::YUVToRGBManager::Kernel oldKernel = YUVToRGBMan.getKernel();
+		TS_ASSERT(YUVToRGBMan.setKernel(Graphics::YUVToRGBManager::kKernelLookup));
+		YUVToRGBMan.setKernel(oldKernel);
+	}
+};
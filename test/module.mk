@@ -3,14 +3,50 @@
 # Use the 'test' target to run them.
 # Edit TESTS and TESTLIBS to add more tests.
 #
+# Benchmarks live in test/benchmark and are run with the 'benchmark'
+# target. Their results are only meaningful in optimized builds.
+#
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := test/common/threadsystem.o audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+ifdef HAVE_MMAP
+	TESTS += $(srcdir)/test/backends/*.h
+	TEST_LIBS += backends/fs/posix/mmapstream.o backends/fs/stdiostream.o
+endif
+
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	TEST_LIBS := video/libvideo.a $(TEST_LIBS)
+endif
+
+BENCHMARKS      := $(srcdir)/test/benchmark/*.h
+BENCHMARK_LIBS  := test/benchmark/benchmark.o test/common/threadsystem.o \
+	audio/libaudio.a graphics/libgraphics.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
+	BENCHMARKS += $(srcdir)/test/benchmark/engines/wintermute/*.h
+	BENCHMARK_LIBS += engines/wintermute/libwintermute.a
+	TEST_ENGINES := 1
+endif
+
+ifeq ($(ENABLE_SCI), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/sci/*.h
+	TEST_LIBS += engines/sci/libsci.a
+	BENCHMARKS += $(srcdir)/test/benchmark/engines/sci/*.h
+	BENCHMARK_LIBS += engines/sci/libsci.a
+	TEST_ENGINES := 1
+endif
+
+# The engine tests need most of the program, whose libraries depend on each
+# other, so all of them are linked three times. OBJS is only complete once
+# all modules are read, hence the deferred expansion.
+ifdef TEST_ENGINES
+TEST_PROGRAM_DEPS := $(EXECUTABLE)
+TEST_PROGRAM_LIBS = $(foreach pass,1 2 3,$(filter %.a,$(OBJS)))
 endif
 
 #
@@ -43,14 +79,29 @@ endif
 
 test: test/runner
 	./test/runner
-test/runner: test/runner.cpp $(TEST_LIBS)
-	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+test/runner: test/runner.cpp $(TEST_LIBS) | $(TEST_PROGRAM_DEPS)
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_PROGRAM_LIBS) $(TEST_LDFLAGS)
 test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+# The helpers which need system functions are built on their own, so that
+# their exceptions to common/forbidden.h do not apply to the tests
+test/common/threadsystem.o: CXXFLAGS:=$(CXXFLAGS) -I$(srcdir)/test/cxxtest
+test/common/threadsystem.o: $(srcdir)/test/common/threadsystem.h
+test/benchmark/benchmark.o: $(srcdir)/test/benchmark/benchmark.h
+
+benchmark: test/benchmark/runner
+	./test/benchmark/runner
+test/benchmark/runner: test/benchmark/runner.cpp $(BENCHMARK_LIBS) | $(TEST_PROGRAM_DEPS)
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -I$(srcdir)/test/benchmark -o $@ $+ $(TEST_PROGRAM_LIBS) $(TEST_LDFLAGS)
+test/benchmark/runner.cpp: $(BENCHMARKS)
+	@mkdir -p test/benchmark
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/benchmark/runner.cpp test/benchmark/runner
+	-$(RM) test/common/threadsystem.o test/benchmark/benchmark.o
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
@@ -0,0 +1,172 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/threadpool.h"
+#include "common/util.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "video/bink_decoder.h"
+
+#include "../common/threadsystem.h"
+
+class BinkTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 16,
+		kHeight = 16,
+		kFrameCount = 5
+	};
+
+	/** Writes bits in the order the decoder's LSB first bit stream reads them */
+	class BitWriter {
+	public:
+		BitWriter() : _bits(0) {}
+
+		void put(uint32 value, int count) {
+			for (int i = 0; i < count; ++i, ++_bits) {
+				if (!(_bits & 7))
+					_data.push_back(0);
+				if ((value >> i) & 1)
+					_data.back() |= 1 << (_bits & 7);
+			}
+		}
+
+		void align32() {
+			while (_bits & 31)
+				put(0, 1);
+		}
+
+		const Common::Array<byte> &getData() const { return _data; }
+
+	private:
+		Common::Array<byte> _data;
+		uint32 _bits;
+	};
+
+	/** Bits of a bundle's element count, for planes of the given width */
+	static int countLength(uint32 value) {
+		return Common::intLog2(value + 511) + 1;
+	}
+
+	/**
+	 * Write a plane made of skipped blocks: every bundle uses the raw nibble
+	 * tree, each row of blocks has its block types filled with kBlockSkip,
+	 * and all other bundles are empty.
+	 */
+	static void writeSkipPlane(BitWriter &bits, bool isChroma) {
+		const uint32 width = isChroma ? kWidth / 2 : kWidth;
+		const uint32 blockWidth = isChroma ? (kWidth + 15) / 16 : (kWidth + 7) / 8;
+		const uint32 blockHeight = isChroma ? (kHeight + 15) / 16 : (kHeight + 7) / 8;
+		const uint32 blocks8 = MAX<uint32>(width, 8) >> 3;
+
+		// Huffman trees of the bundles: sixteen extra ones for the colors,
+		// none for the DC values
+		bits.put(0, 4 * 7 + 4 * 16);
+
+		for (uint32 y = 0; y < blockHeight; ++y) {
+			// Block types, all skipped
+			bits.put(blockWidth, countLength(blocks8));
+			bits.put(1, 1);
+			bits.put(0, 4);
+
+			// The other bundles are empty, and not read again after that
+			if (y == 0) {
+				bits.put(0, countLength((MAX<uint32>(width, 8) + 7) >> 4)); // Sub block types
+				bits.put(0, countLength(blockWidth * 64));                 // Colors
+				bits.put(0, countLength(blockWidth << 3));                 // Patterns
+				bits.put(0, countLength(blocks8));                         // X offsets
+				bits.put(0, countLength(blocks8));                         // Y offsets
+				bits.put(0, countLength(blocks8));                         // Intra DC
+				bits.put(0, countLength(blocks8));                         // Inter DC
+				bits.put(0, countLength(blockWidth * 48));                 // Runs
+			}
+		}
+
+		bits.align32();
+	}
+
+	/** Create a BIKf video without audio, whose frames only skip blocks */
+	static Common::SeekableReadStream *createVideo() {
+		BitWriter bits;
+		writeSkipPlane(bits, false);
+		writeSkipPlane(bits, true);
+		writeSkipPlane(bits, true);
+		const Common::Array<byte> &frame = bits.getData();
+
+		const uint32 headerSize = 44 + 4 * kFrameCount;
+		const uint32 size = headerSize + kFrameCount * frame.size();
+		byte *data = (byte *)malloc(size);
+
+		WRITE_BE_UINT32(data, MKTAG('B', 'I', 'K', 'f'));
+		WRITE_LE_UINT32(data + 4, size - 8);
+		WRITE_LE_UINT32(data + 8, kFrameCount);
+		WRITE_LE_UINT32(data + 12, frame.size());
+		WRITE_LE_UINT32(data + 16, 0);
+		WRITE_LE_UINT32(data + 20, kWidth);
+		WRITE_LE_UINT32(data + 24, kHeight);
+		WRITE_LE_UINT32(data + 28, 25);
+		WRITE_LE_UINT32(data + 32, 1);
+		WRITE_LE_UINT32(data + 36, 0); // Video flags
+		WRITE_LE_UINT32(data + 40, 0); // Audio tracks
+
+		for (uint32 i = 0; i < kFrameCount; ++i) {
+			const uint32 offset = headerSize + i * frame.size();
+			WRITE_LE_UINT32(data + 44 + 4 * i, offset | (i == 0 ? 1 : 0));
+			memcpy(data + offset, frame.begin(), frame.size());
+		}
+
+		return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	}
+
+	static void playVideo() {
+		Video::BinkDecoder decoder;
+		TS_ASSERT(decoder.loadStream(createVideo()));
+		decoder.start();
+
+		uint frames = 0;
+		while (!decoder.endOfVideo()) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT(surface);
+			if (!surface)
+				break;
+
+			TS_ASSERT_EQUALS(surface->w, kWidth);
+			TS_ASSERT_EQUALS(surface->h, kHeight);
+			++frames;
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), (int)frames - 1);
+		}
+
+		TS_ASSERT_EQUALS(frames, (uint)kFrameCount);
+	}
+
+	static void resetSingletons() {
+		Common::ThreadPool::destroy();
+		Graphics::YUVToRGBManager::destroy();
+	}
+
+public:
+	void test_play_without_threads() {
+		// Like the null backend, which has no thread manager and hence no
+		// condition variables
+		resetSingletons();
+		{
+			NullTestSystem system;
+			playVideo();
+			resetSingletons();
+		}
+	}
+
+	void test_play_with_workers() {
+		if (!ThreadTestSystem::isAvailable())
+			return;
+
+		resetSingletons();
+		{
+			ThreadTestSystem system;
+			TS_ASSERT(Common::ThreadPool::instance().getThreadCount() > 0);
+			playVideo();
+			resetSingletons();
+		}
+	}
+};
@@ -33,6 +33,7 @@
 #include "common/stream.h"
 #include "common/substream.h"
 #include "common/file.h"
+#include "common/memstream.h"
 #include "common/str.h"
 #include "common/bitstream.h"
 #include "common/huffman.h"
@@ -63,6 +64,7 @@ namespace Video {
 
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+	_nextFrame = 0;
 }
 
 BinkDecoder::~BinkDecoder() {
@@ -141,6 +143,8 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	_frames[frameCount - 1].size = _bink->size() - _frames[frameCount - 1].offset;
 
+	_nextFrame = 0;
+
 	return true;
 }
 
@@ -152,15 +156,22 @@ void BinkDecoder::close() {
 
 	_audioTracks.clear();
 	_frames.clear();
+	_nextFrame = 0;
 }
 
 void BinkDecoder::readNextPacket() {
 	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
 
-	if (videoTrack->endOfTrack())
-		return;
+	// Keep the decode job busy with the following frames while the current
+	// one is shown. Without worker threads, read only what is needed.
+	const uint queueSize = Common::ThreadPool::instance().getThreadCount() > 0 ? (uint)BinkVideoTrack::kFrameQueueSize : 1;
+
+	while (_nextFrame < _frames.size() && videoTrack->getQueuedFrameCount() < queueSize)
+		readPacket(_frames[_nextFrame++]);
+}
 
-	VideoFrame &frame = _frames[videoTrack->getCurFrame() + 1];
+void BinkDecoder::readPacket(VideoFrame &frame) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
 
 	if (!_bink->seek(frame.offset))
 		error("Bad bink seek");
@@ -200,16 +211,15 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	// The packet is decoded on another thread, so it needs its own copy
+	byte *videoPacket = (byte *)malloc(frameSize);
+	if ((!videoPacket && frameSize > 0) || _bink->read(videoPacket, frameSize) != frameSize)
+		error("Failed to read video packet of frame %d", _nextFrame - 1);
 
-	videoTrack->decodePacket(frame);
+	frame.bits = new Common::BitStream32LELSB(new Common::MemoryReadStream(videoPacket,
+			frameSize, DisposeAfterUse::YES), DisposeAfterUse::YES);
 
-	delete frame.bits;
-	frame.bits = 0;
+	videoTrack->queuePacket(frame);
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -246,6 +256,14 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
 
+	_nextSurface  = 0;
+	_shownSurface = &_surfaces[0];
+	_queuedFrames = 0;
+	_decoding     = false;
+
+	_queueMutex   = g_system->createMutex();
+	_frameDecoded = g_system->createCondition();
+
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
@@ -279,16 +297,22 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 		_surfaceWidth++;
 	}
 
-	_surface.create(_surfaceWidth, _surfaceHeight, format);
-	// Since we over-allocate to make surfaces even-sized
-	// we need to set the actual VIDEO size back into the
-	// surface.
-	_surface.h = height;
-	_surface.w = width;
+	for (uint i = 0; i < ARRAYSIZE(_surfaces); i++) {
+		_surfaces[i].create(_surfaceWidth, _surfaceHeight, format);
+		// Since we over-allocate to make surfaces even-sized
+		// we need to set the actual VIDEO size back into the
+		// surface.
+		_surfaces[i].h = height;
+		_surfaces[i].w = width;
+	}
+
+	// The frames are converted on worker threads; singletons are not
+	// created thread safely, so create the converter here
+	Graphics::YUVToRGBManager::instance();
 
 	// Give the planes a bit extra space
-	width  = _surface.w + 32;
-	height = _surface.h + 32;
+	width  = _surfaces[0].w + 32;
+	height = _surfaces[0].h + 32;
 
 	_curPlanes[0] = new byte[ width       *  height      ]; // Y
 	_curPlanes[1] = new byte[(width >> 1) * (height >> 1)]; // U, 1/4 resolution
@@ -314,6 +338,17 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	// Drop the packets not yet decoded and wait for the decode job
+	g_system->lockMutex(_queueMutex);
+	_packets.clear();
+	g_system->unlockMutex(_queueMutex);
+
+	_decodeJob = Common::Future<DecodeJob>();
+
+	if (_frameDecoded)
+		g_system->deleteCondition(_frameDecoded);
+	g_system->deleteMutex(_queueMutex);
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -326,10 +361,91 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 		_huffman[i] = 0;
 	}
 
-	_surface.free();
+	for (uint i = 0; i < ARRAYSIZE(_surfaces); i++)
+		_surfaces[i].free();
+}
+
+const Graphics::Surface *BinkDecoder::BinkVideoTrack::decodeNextFrame() {
+	g_system->lockMutex(_queueMutex);
+
+	// Without the condition, the packets are decoded when queued, so this
+	// never has to wait
+	while (_decodedFrames.empty() && _decoding)
+		g_system->waitCondition(_frameDecoded, _queueMutex);
+
+	if (!_decodedFrames.empty()) {
+		_shownSurface = _decodedFrames.pop();
+		_queuedFrames--;
+		_curFrame++;
+	}
+
+	g_system->unlockMutex(_queueMutex);
+
+	return _shownSurface;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+void BinkDecoder::BinkVideoTrack::queuePacket(VideoFrame &frame) {
+	g_system->lockMutex(_queueMutex);
+	_packets.push(&frame);
+	g_system->unlockMutex(_queueMutex);
+
+	_queuedFrames++;
+
+	startDecoding();
+}
+
+void BinkDecoder::BinkVideoTrack::startDecoding() {
+	g_system->lockMutex(_queueMutex);
+	const bool start = !_decoding && !_packets.empty();
+	if (start)
+		_decoding = true;
+	g_system->unlockMutex(_queueMutex);
+
+	if (!start)
+		return;
+
+	// Backends without threads have no condition variables either, e.g. the
+	// null backend, so decode the packets right away there. Without worker
+	// threads, the job would do the same. Otherwise, a previous job has
+	// already left its loop, and replacing its future only waits for it to
+	// return.
+	if (_frameDecoded)
+		_decodeJob = Common::ThreadPool::instance().async(new DecodeJob(this));
+	else
+		decodeQueuedPackets();
+}
+
+void BinkDecoder::BinkVideoTrack::decodeQueuedPackets() {
+	g_system->lockMutex(_queueMutex);
+
+	while (!_packets.empty()) {
+		VideoFrame *frame = _packets.pop();
+
+		// At most kFrameQueueSize frames are queued, so this is never the
+		// surface currently shown
+		Graphics::Surface *surface = &_surfaces[_nextSurface];
+		_nextSurface = (_nextSurface + 1) % ARRAYSIZE(_surfaces);
+
+		g_system->unlockMutex(_queueMutex);
+
+		decodePacket(*frame, *surface);
+
+		delete frame->bits;
+		frame->bits = 0;
+
+		g_system->lockMutex(_queueMutex);
+		_decodedFrames.push(surface);
+		if (_frameDecoded)
+			g_system->signalCondition(_frameDecoded);
+	}
+
+	_decoding = false;
+	if (_frameDecoded)
+		g_system->signalCondition(_frameDecoded);
+	g_system->unlockMutex(_queueMutex);
+}
+
+void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame, Graphics::Surface &surface) {
 	assert(frame.bits);
 
 	if (_hasAlpha) {
@@ -356,21 +472,19 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
 	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-	YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
+	YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
 			_surfaceWidth, _surfaceHeight, _surfaceWidth, _surfaceWidth >> 1);
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
-
-	_curFrame++;
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
-	uint32 blockWidth  = isChroma ? ((_surface.w  + 15) >> 4) : ((_surface.w  + 7) >> 3);
-	uint32 blockHeight = isChroma ? ((_surface.h + 15) >> 4) : ((_surface.h + 7) >> 3);
-	uint32 width       = isChroma ?  (_surface.w        >> 1) :   _surface.w;
-	uint32 height      = isChroma ?  (_surface.h       >> 1) :   _surface.h;
+	uint32 blockWidth  = isChroma ? ((_surfaces[0].w  + 15) >> 4) : ((_surfaces[0].w  + 7) >> 3);
+	uint32 blockHeight = isChroma ? ((_surfaces[0].h + 15) >> 4) : ((_surfaces[0].h + 7) >> 3);
+	uint32 width       = isChroma ?  (_surfaces[0].w        >> 1) :   _surfaces[0].w;
+	uint32 height      = isChroma ?  (_surfaces[0].h       >> 1) :   _surfaces[0].h;
 
 	DecodeContext ctx;
 
@@ -556,8 +670,8 @@ void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(VideoFrame &video, byte *d
 }
 
 void BinkDecoder::BinkVideoTrack::initBundles() {
-	uint32 bw     = (_surface.w  + 7) >> 3;
-	uint32 bh     = (_surface.h + 7) >> 3;
+	uint32 bw     = (_surfaces[0].w  + 7) >> 3;
+	uint32 bh     = (_surfaces[0].h + 7) >> 3;
 	uint32 blocks = bw * bh;
 
 	for (int i = 0; i < kSourceMAX; i++) {
@@ -565,8 +679,8 @@ void BinkDecoder::BinkVideoTrack::initBundles() {
 		_bundles[i].dataEnd = _bundles[i].data + blocks * 64;
 	}
 
-	uint32 cbw[2] = { (uint32)((_surface.w + 7) >> 3), (uint32)((_surface.w  + 15) >> 4) };
-	uint32 cw [2] = { (uint32)( _surface.w          ), (uint32)( _surface.w        >> 1) };
+	uint32 cbw[2] = { (uint32)((_surfaces[0].w + 7) >> 3), (uint32)((_surfaces[0].w  + 15) >> 4) };
+	uint32 cw [2] = { (uint32)( _surfaces[0].w          ), (uint32)( _surfaces[0].w        >> 1) };
 
 	// Calculate the lengths of an element count in bits
 	for (int i = 0; i < 2; i++) {
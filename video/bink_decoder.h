@@ -32,7 +32,10 @@
 #define VIDEO_BINK_DECODER_H
 
 #include "common/array.h"
+#include "common/queue.h"
 #include "common/rational.h"
+#include "common/system.h"
+#include "common/threadpool.h"
 
 #include "video/video_decoder.h"
 
@@ -139,20 +142,35 @@ private:
 		~VideoFrame();
 	};
 
+	/**
+	 * The video track. Frames are decoded on a worker thread ahead of
+	 * presentation: the packets read by the decoder are queued, and
+	 * decodeNextFrame() returns the oldest decoded frame.
+	 */
 	class BinkVideoTrack : public FixedRateVideoTrack {
 	public:
+		enum {
+			kFrameQueueSize = 2 ///< Number of frames read ahead of the one shown.
+		};
+
 		BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id);
 		~BinkVideoTrack();
 
-		uint16 getWidth() const { return _surface.w; }
-		uint16 getHeight() const { return _surface.h; }
-		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		uint16 getWidth() const { return _surfaces[0].w; }
+		uint16 getHeight() const { return _surfaces[0].h; }
+		Graphics::PixelFormat getPixelFormat() const { return _surfaces[0].format; }
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() { return &_surface; }
+		const Graphics::Surface *decodeNextFrame();
 
-		/** Decode a video packet. */
-		void decodePacket(VideoFrame &frame);
+		/**
+		 * Queue a video packet for decoding. The packet's bits are deleted
+		 * once it has been decoded.
+		 */
+		void queuePacket(VideoFrame &frame);
+
+		/** @return the number of queued frames not yet returned by decodeNextFrame(). */
+		uint getQueuedFrameCount() const { return _queuedFrames; }
 
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
@@ -231,10 +249,37 @@ private:
 			byte *curPtr; ///< Pointer to the data that wasn't yet read.
 		};
 
+		/** Decodes the queued packets on a worker thread. */
+		struct DecodeJob : public Common::Job {
+			BinkVideoTrack *track;
+
+			explicit DecodeJob(BinkVideoTrack *t) : track(t) {}
+			void run() { track->decodeQueuedPackets(); }
+		};
+
 		int _curFrame;
 		int _frameCount;
 
-		Graphics::Surface _surface;
+		/**
+		 * The frames are decoded into these surfaces in turn. One is shown,
+		 * the others hold the frames queued behind it.
+		 */
+		Graphics::Surface _surfaces[kFrameQueueSize + 1];
+		uint _nextSurface;                  ///< The surface to decode the next packet into.
+		const Graphics::Surface *_shownSurface; ///< The surface last returned by decodeNextFrame().
+
+		uint _queuedFrames; ///< Number of frames queued, decoding or decoded, but not shown.
+
+		// Shared with the decode job, guarded by _queueMutex
+		Common::Queue<VideoFrame *> _packets;             ///< Packets waiting to be decoded.
+		Common::Queue<Graphics::Surface *> _decodedFrames; ///< Decoded frames waiting to be shown.
+		bool _decoding; ///< Is the decode job running?
+
+		OSystem::MutexRef _queueMutex;
+		OSystem::ConditionRef _frameDecoded; ///< 0 if the backend has no threads.
+
+		Common::Future<DecodeJob> _decodeJob;
+
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
 
@@ -257,6 +302,13 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		/** Start the decode job, unless it is running or there is nothing to do. */
+		void startDecoding();
+		/** Decode packets until the queue is empty. Called by the decode job. */
+		void decodeQueuedPackets();
+		/** Decode a video packet into the given surface. */
+		void decodePacket(VideoFrame &frame, Graphics::Surface &surface);
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -352,7 +404,12 @@ private:
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
+	uint32 _nextFrame; ///< The next frame whose packet is read.
+
 	void initAudioTrack(AudioInfo &audio);
+
+	/** Read a packet, decode its audio and queue its video for decoding. */
+	void readPacket(VideoFrame &frame);
 };
 
 } // End of namespace Video